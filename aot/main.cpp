@@ -0,0 +1,73 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <aot/translator.hpp>
+
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+int main(int argc, char* argv[])
+{
+  using namespace std::string_view_literals;
+  using namespace yarisc::arch;
+  using namespace yarisc::aot;
+
+  if ((argc < 3) || (argc > 5))
+  {
+    std::cerr << "Usage: yarisc-aot <image> <output.cpp> [program name] [min|v1]" << std::endl;
+
+    return 2;
+  }
+
+  try
+  {
+    const std::filesystem::path image{argv[1]};
+
+    translation_options options;
+    options.image = image.filename().string();
+
+    if (argc > 3)
+      options.name = argv[3];
+
+    if (argc > 4)
+    {
+      if (argv[4] == "min"sv)
+        options.level = feature_level::min;
+      else if (argv[4] != "v1"sv)
+        throw std::invalid_argument{"Invalid feature level " + std::string{argv[4]}};
+    }
+
+    // The image is loaded exactly as it is loaded for execution
+    machine m{options.level};
+    m.load(image);
+
+    std::ofstream os{argv[2]};
+
+    if (!os.is_open())
+      throw std::runtime_error{"could not open output file"};
+
+    translate(os, std::as_const(m).main_memory(), options);
+
+    if (!os.flush())
+      throw std::runtime_error{"could not write output file"};
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,492 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <aot/translator.hpp>
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/detail/hex_word.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace yarisc::aot
+{
+  namespace
+  {
+    using namespace std::string_view_literals;
+
+    using arch::address_t;
+    using arch::opcode;
+    using arch::word_t;
+    using arch::detail::decoded_instruction;
+    using arch::detail::operand_form;
+
+    constexpr std::uint8_t ip_index = 7;
+    constexpr unsigned int ip_mask = 0x1 << ip_index;
+
+    constexpr std::size_t num_words =
+      (static_cast<std::size_t>(std::numeric_limits<address_t>::max()) + 1) / sizeof(word_t);
+
+    struct instruction final
+    {
+      address_t address{0};
+
+      /**
+       * @brief Instruction word and the word following it
+       */
+      word_t word{0};
+      word_t arg{0};
+
+      decoded_instruction decoded{};
+
+      [[nodiscard]] address_t next() const noexcept
+      {
+        return static_cast<address_t>(address + decoded.size());
+      }
+    };
+
+    struct block final
+    {
+      address_t entry{0};
+      std::vector<instruction> instructions{};
+
+      [[nodiscard]] address_t end() const noexcept
+      {
+        return instructions.back().next();
+      }
+
+      [[nodiscard]] std::uint32_t length() const noexcept
+      {
+        std::uint32_t result = 0;
+
+        for (const instruction& instr : instructions)
+          result += instr.decoded.size();
+
+        return result;
+      }
+    };
+
+    /**
+     * @brief Decodes a block with the same rules as the block cache
+     */
+    template <typename Profile>
+    [[nodiscard]] block build_block(const arch::memory& mem, address_t entry)
+    {
+      constexpr address_t last_address = std::numeric_limits<address_t>::max() - (sizeof(word_t) - 1);
+
+      block b{entry};
+
+      address_t address = entry;
+
+      while (b.instructions.size() < arch::detail::block_cache::max_block_size)
+      {
+        instruction instr{address, mem.load(address)};
+        instr.decoded = arch::detail::decode_instruction<Profile>(instr.word);
+
+        // Instructions which cannot be executed in decoded form are left to the reference interpreter
+        if (instr.decoded.form == operand_form::fallback)
+          break;
+
+        if (address != last_address)
+        {
+          instr.arg = mem.load(static_cast<address_t>(address + sizeof(word_t)));
+        }
+        else if (instr.decoded.long_immediate())
+        {
+          // Long immediate constants wrapping around the end of the address space are left to the interpreter too
+          break;
+        }
+
+        if (instr.decoded.long_immediate())
+          instr.decoded.imm = instr.arg;
+
+        b.instructions.push_back(instr);
+
+        const address_t next = instr.next();
+
+        // Wrapping around the end of the address space also ends the block
+        if (arch::detail::ends_block(instr.decoded) || (next < address))
+          break;
+
+        address = next;
+      }
+
+      return b;
+    }
+
+    /**
+     * @brief Finds the blocks reachable from the entry address
+     *
+     * @return the blocks sorted by entry address
+     */
+    template <typename Profile>
+    [[nodiscard]] std::vector<block> find_blocks(const arch::memory& mem, address_t entry)
+    {
+      std::vector<bool> visited(num_words);
+      std::vector<address_t> pending{entry};
+      std::vector<block> blocks;
+
+      while (!pending.empty())
+      {
+        const address_t address = pending.back();
+        pending.pop_back();
+
+        if (!arch::detail::is_aligned(address) || visited[address / sizeof(word_t)])
+          continue;
+
+        visited[address / sizeof(word_t)] = true;
+
+        block b = build_block<Profile>(mem, address);
+
+        if (b.instructions.empty())
+          continue;
+
+        const decoded_instruction& last = b.instructions.back().decoded;
+
+        if ((last.get_opcode() == opcode::jump) || (last.get_opcode() == opcode::cond_jump))
+          pending.push_back(static_cast<address_t>(last.imm));
+
+        pending.push_back(b.end());
+
+        blocks.push_back(std::move(b));
+      }
+
+      std::sort(begin(blocks), end(blocks), [](const block& lhs, const block& rhs) { return lhs.entry < rhs.entry; });
+
+      return blocks;
+    }
+
+    [[nodiscard]] std::vector<block> find_blocks(
+      const arch::memory& mem, address_t entry, arch::feature_level level)
+    {
+      switch (level)
+      {
+      case arch::feature_level::min:
+        return find_blocks<arch::machine_profile<arch::feature_level::min>>(mem, entry);
+      case arch::feature_level::v1:
+        return find_blocks<arch::machine_profile<arch::feature_level::v1>>(mem, entry);
+      default:
+        throw std::invalid_argument{
+          "Invalid feature level " + std::to_string(static_cast<std::underlying_type_t<arch::feature_level>>(level))};
+      }
+    }
+
+    [[nodiscard]] std::string_view level_name(arch::feature_level level) noexcept
+    {
+      return (level == arch::feature_level::min) ? "min"sv : "v1"sv;
+    }
+
+    [[nodiscard]] bool is_identifier(std::string_view name) noexcept
+    {
+      const auto alpha = [](char c) { return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || (c == '_'); };
+      const auto digit = [](char c) { return (c >= '0') && (c <= '9'); };
+
+      return !name.empty() && alpha(name.front()) &&
+             std::all_of(begin(name), end(name), [&](char c) { return alpha(c) || digit(c); });
+    }
+
+    [[nodiscard]] std::string hex(word_t value)
+    {
+      std::ostringstream oss;
+      arch::detail::output_hex(oss << "0x"sv, value);
+
+      return std::move(oss).str();
+    }
+
+    [[nodiscard]] std::string block_name(address_t entry)
+    {
+      std::ostringstream oss;
+      arch::detail::output_hex(oss << "block_"sv, entry);
+
+      return std::move(oss).str();
+    }
+
+    [[nodiscard]] std::string reg(std::uint8_t index)
+    {
+      std::string name{"r"};
+      name += std::to_string(index);
+
+      return name;
+    }
+
+    [[nodiscard]] std::string op1(const decoded_instruction& instr)
+    {
+      return (instr.form == operand_form::immediate_op1) ? hex(instr.imm) : reg(instr.op1);
+    }
+
+    [[nodiscard]] std::string op2(const decoded_instruction& instr)
+    {
+      return (instr.form == operand_form::immediate_op2) ? hex(instr.imm) : reg(instr.op2);
+    }
+
+    /**
+     * @brief Returns the bit masks of the registers read and written by an instruction
+     */
+    [[nodiscard]] std::pair<unsigned int, unsigned int> register_usage(const decoded_instruction& instr) noexcept
+    {
+      const auto bit = [](std::uint8_t index) { return 0x1u << index; };
+
+      switch (instr.get_opcode())
+      {
+      case opcode::move:
+      case opcode::load:
+        return {(instr.form == operand_form::registers) ? bit(instr.op1) : 0u, bit(instr.op0)};
+      case opcode::store:
+        return {bit(instr.op0) | ((instr.form == operand_form::registers) ? bit(instr.op1) : 0u), 0u};
+      case opcode::add:
+      case opcode::add_with_carry:
+        return {((instr.form != operand_form::immediate_op1) ? bit(instr.op1) : 0u) |
+                  ((instr.form != operand_form::immediate_op2) ? bit(instr.op2) : 0u),
+                bit(instr.op0)};
+      default:
+        return {0u, 0u};
+      }
+    }
+
+    /**
+     * @brief Writer of the function of a block
+     */
+    class block_writer final
+    {
+    public:
+      block_writer(std::ostream& os, const block& b, arch::feature_level level)
+        : os_{os}
+        , b_{b}
+        , level_{level}
+      {
+        const decoded_instruction& last = b_.instructions.back().decoded;
+
+        loops_ = ((last.get_opcode() == opcode::jump) || (last.get_opcode() == opcode::cond_jump)) &&
+                 (last.imm == b_.entry);
+        indent_ = loops_ ? "      "sv : "    "sv;
+      }
+
+      void write()
+      {
+        unsigned int reads = 0;
+        unsigned int writes = 0;
+
+        for (const instruction& instr : b_.instructions)
+        {
+          const auto [r, w] = register_usage(instr.decoded);
+
+          reads |= r;
+          writes |= w;
+        }
+
+        os_ << "\n  // "sv << hex(b_.entry) << ": "sv << b_.instructions.size() << " instruction(s)\n"sv;
+        os_ << "  aot_exit "sv << block_name(b_.entry) << "(aot_context& ctx)\n  {\n"sv;
+        os_ << "    auto& r = ctx.reg.named.r;\n"sv;
+
+        for (std::uint8_t i = 0; i < ip_index; ++i)
+        {
+          if ((reads | writes) & (0x1u << i))
+            os_ << "    word_t "sv << reg(i) << " = r["sv << int{i} << "];\n"sv;
+        }
+
+        if ((reads | writes) & ip_mask)
+          os_ << "    word_t r7 = 0x0000;\n"sv;
+
+        os_ << "    word_t s = ctx.reg.status.s;\n\n"sv;
+
+        os_ << "    const auto leave = [&](word_t ip, std::uint64_t steps, aot_exit exit) noexcept\n    {\n"sv;
+
+        for (std::uint8_t i = 0; i < ip_index; ++i)
+        {
+          if (writes & (0x1u << i))
+            os_ << "      r["sv << int{i} << "] = "sv << reg(i) << ";\n"sv;
+        }
+
+        os_ << "      r[7] = ip;\n"sv;
+        os_ << "      ctx.reg.status.s = s;\n"sv;
+        os_ << "      ctx.steps += steps;\n\n"sv;
+        os_ << "      return exit;\n"sv;
+        os_ << "    };\n\n"sv;
+
+        if (loops_)
+          os_ << "    for (;;)\n    {\n"sv;
+
+        for (std::size_t i = 0; i < b_.instructions.size(); ++i)
+          write_instruction(b_.instructions[i], i + 1);
+
+        if (!arch::detail::ends_block(b_.instructions.back().decoded) ||
+            (b_.instructions.back().decoded.get_opcode() == opcode::cond_jump))
+        {
+          line();
+          line("return leave("sv, hex(b_.end()), ", "sv, b_.instructions.size(), ", aot_exit::next);"sv);
+        }
+
+        if (loops_)
+          os_ << "    }\n"sv;
+
+        os_ << "  }\n"sv;
+      }
+
+    private:
+      std::ostream& os_;
+      const block& b_;
+      arch::feature_level level_;
+
+      /**
+       * @brief Set if the block ends with a jump back to its entry, which is translated to a loop
+       */
+      bool loops_{false};
+
+      std::string_view indent_;
+
+      template <typename... Args>
+      void line(const Args&... args)
+      {
+        if constexpr (sizeof...(Args) == 0)
+          os_ << '\n';
+        else
+          (os_ << indent_ << ... << args) << '\n';
+      }
+
+      void write_instruction(const instruction& instr, std::size_t count)
+      {
+        const decoded_instruction& d = instr.decoded;
+        const auto [reads, writes] = register_usage(d);
+
+        if (count > 1)
+          line();
+
+        line("// "sv, hex(instr.address), ": "sv, arch::disassemble(instr.word, instr.arg, level_).text);
+
+        // Reading the instruction pointer returns the address of the next instruction
+        if ((reads | writes) & ip_mask)
+          line("r7 = "sv, hex(instr.next()), ';');
+
+        switch (d.get_opcode())
+        {
+        case opcode::move:
+          line(reg(d.op0), " = "sv, op1(d), ';');
+          line("s = detail::aot_zero(s, "sv, reg(d.op0), ");"sv);
+          break;
+        case opcode::load:
+          line(reg(d.op0), " = ctx.mem.load(static_cast<address_t>("sv, op1(d), "));"sv);
+          line("s = detail::aot_zero(s, "sv, reg(d.op0), ");"sv);
+          break;
+        case opcode::store:
+          line('{');
+          line("  const auto a = static_cast<address_t>("sv, op1(d), ");"sv);
+          line("  ctx.mem.store(a, "sv, reg(d.op0), ");"sv);
+          line();
+          line("  if (detail::aot_covered(ctx.code, a))"sv);
+          line("  {"sv);
+          line("    ctx.modified = a;"sv);
+          line("    return leave("sv, hex(instr.next()), ", "sv, count, ", aot_exit::code_modified);"sv);
+          line("  }"sv);
+          line('}');
+          break;
+        case opcode::add:
+          line("s = detail::aot_add("sv, reg(d.op0), ", "sv, op1(d), ", "sv, op2(d), ", 0x0);"sv);
+          break;
+        case opcode::add_with_carry:
+          line("s = detail::aot_add("sv, reg(d.op0), ", "sv, op1(d), ", "sv, op2(d),
+               ", s & status_register::carry_flag);"sv);
+          break;
+        case opcode::jump:
+          if (loops_)
+            write_loop(count);
+          else
+            line("return leave("sv, hex(d.imm), ", "sv, count, ", aot_exit::next);"sv);
+          break;
+        case opcode::cond_jump:
+        {
+          std::ostringstream cond;
+          cond << "(s & "sv << hex(d.op0) << ((d.op1 != 0) ? ") == 0"sv : ") != 0"sv);
+
+          line("if ("sv, cond.str(), ')');
+
+          if (loops_)
+          {
+            line('{');
+            indent_ = "        "sv;
+            write_loop(count);
+            indent_ = "      "sv;
+            line('}');
+          }
+          else
+          {
+            line("  return leave("sv, hex(d.imm), ", "sv, count, ", aot_exit::next);"sv);
+          }
+        }
+        break;
+        case opcode::noop:
+          break;
+        case opcode::halt:
+          line("return leave("sv, hex(instr.next()), ", "sv, count - 1, ", aot_exit::halt);"sv);
+          break;
+        default:
+          break;
+        }
+
+        if ((writes & ip_mask) && (d.get_opcode() != opcode::store))
+          line("return leave(r7, "sv, count, ", aot_exit::next);"sv);
+      }
+
+      void write_loop(std::size_t count)
+      {
+        line("ctx.steps += "sv, count, ';');
+        line();
+        line("if (ctx.limit - ctx.steps >= "sv, count, ')');
+        line("  continue;"sv);
+        line();
+        line("return leave("sv, hex(b_.entry), ", 0, aot_exit::next);"sv);
+      }
+    };
+
+  } // namespace
+
+  void translate(std::ostream& os, const arch::memory& mem, const translation_options& options)
+  {
+    if (!is_identifier(options.name))
+      throw std::invalid_argument{"Invalid program name " + options.name};
+
+    const std::vector<block> blocks = find_blocks(mem, options.entry, options.level);
+
+    os << "/*\n * Generated by yarisc-aot"sv;
+
+    if (!options.image.empty())
+      os << " from "sv << options.image;
+
+    os << ", do not edit.\n */\n\n"sv;
+    os << "#include <yarisc/arch/aot.hpp>\n\n"sv;
+    os << "#include <array>\n#include <cstdint>\n\n"sv;
+    os << "namespace\n{\n  using namespace yarisc::arch;\n"sv;
+
+    for (const block& b : blocks)
+      block_writer{os, b, options.level}.write();
+
+    os << "\n  constexpr std::array<aot_block, "sv << blocks.size() << "> blocks{{\n"sv;
+
+    for (const block& b : blocks)
+    {
+      os << "    {"sv << hex(b.entry) << ", "sv << b.length() << ", "sv << b.instructions.size() << ", &"sv
+         << block_name(b.entry) << "},\n"sv;
+    }
+
+    os << "  }};\n\n} // namespace\n\n"sv;
+
+    os << "extern const yarisc::arch::aot_program "sv << options.name << ";\n\n"sv;
+    os << "const yarisc::arch::aot_program "sv << options.name << "{yarisc::arch::feature_level::"sv
+       << level_name(options.level) << ", blocks};\n"sv;
+  }
+
+} // namespace yarisc::aot
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_AOT_TRANSLATOR_HPP
+#define YARISC_AOT_TRANSLATOR_HPP
+
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <ostream>
+#include <string>
+
+namespace yarisc::aot
+{
+  /**
+   * @brief Options of the translation
+   */
+  struct translation_options final
+  {
+    /**
+     * @brief Name of the `yarisc::arch::aot_program` constant defined by the translation unit
+     */
+    std::string name{"program"};
+
+    /**
+     * @brief Feature level to decode the image for
+     */
+    arch::feature_level level{arch::feature_level_latest};
+
+    /**
+     * @brief Address of the first instruction executed
+     */
+    arch::address_t entry{0x0000};
+
+    /**
+     * @brief Name of the image, which is mentioned in the header comment
+     */
+    std::string image{};
+  };
+
+  /**
+   * @brief Translates the reachable code of an image to a C++ translation unit
+   *
+   * Code is found from the entry address by following the fall-through and jump targets of the decoded instructions.
+   * The targets of indirect jumps, which write to the instruction pointer register, cannot be followed. Therefore the
+   * instructions following a block are always translated too, as they are typically return addresses.
+   *
+   * The translation unit defines one function per basic block and an `aot_program` with the table of the blocks, which
+   * is executed by `yarisc::arch::aot_runtime`.
+   *
+   * @param os stream to write the translation unit to
+   * @param mem main memory holding the image
+   * @param options options of the translation
+   */
+  void translate(std::ostream& os, const arch::memory& mem, const translation_options& options);
+
+} // namespace yarisc::aot
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/assembler.hpp>
+#include <yarisc/arch/feature_level.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+  using namespace std::string_view_literals;
+  using namespace yarisc::arch;
+
+  if ((argc < 3) || (argc > 4))
+  {
+    std::cerr << "Usage: yarisc-as <source> <image> [min|v1]" << std::endl;
+
+    return 2;
+  }
+
+  try
+  {
+    const std::filesystem::path path{argv[1]};
+
+    assembler_options options;
+    options.name = path.filename().string();
+
+    if (argc > 3)
+    {
+      if (argv[3] == "min"sv)
+        options.level = feature_level::min;
+      else if (argv[3] != "v1"sv)
+        throw std::invalid_argument{"Invalid feature level " + std::string{argv[3]}};
+    }
+
+    std::ifstream is{path, std::ios::binary};
+
+    if (!is.is_open())
+      throw std::runtime_error{"could not open source file"};
+
+    // Read the entire source at once, the assembler scans it in place
+    std::string source(static_cast<std::size_t>(std::filesystem::file_size(path)), '\0');
+
+    if (!is.read(source.data(), static_cast<std::streamsize>(source.size())))
+      throw std::runtime_error{"could not read source file"};
+
+    const std::vector<std::byte> image = assemble_source(source, options);
+
+    std::ofstream os{argv[2], std::ios::binary};
+
+    if (!os.is_open())
+      throw std::runtime_error{"could not open image file"};
+
+    os.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+
+    if (!os.flush())
+      throw std::runtime_error{"could not write image file"};
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
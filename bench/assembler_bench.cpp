@@ -0,0 +1,94 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/assembler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * @brief Number of constants defined by every block of the generated source
+   */
+  constexpr std::size_t constants_per_block = 34;
+
+  /**
+   * @brief Generates a source of the given number of blocks with labels, constants, forward references, and data
+   *
+   * Every block has 41 lines, most of them constants like a generated table of symbols, because the code of 100k lines
+   * would not fit into the address space. The image of 2500 blocks covers most of the address space.
+   */
+  [[nodiscard]] std::string generate_source(std::size_t blocks)
+  {
+    std::string source;
+    source.reserve(blocks * 900);
+
+    for (std::size_t i = 0; i < blocks; ++i)
+    {
+      const std::string n = std::to_string(i);
+      const std::string next = std::to_string((i + 1) % blocks);
+
+      source += "k" + n + " = " + std::to_string(i % 16) + "\n";
+
+      for (std::size_t j = 1; j < constants_per_block; ++j)
+        source += "c" + n + "_" + std::to_string(j) + " = k" + n + " + " + std::to_string(j) + "\n";
+
+      source += "b" + n + ":   MOV r0, k" + n + "        ; short constant\n";
+      source += "        ADD r1, r1, -1\n";
+      source += "        ADD r2, r0, 0x1234\n";
+      source += "        LDR r3, d" + n + "\n";
+      source += "        JNZ b" + next + "\n";
+      source += "        JMP b" + n + "\n";
+      source += "d" + n + ":   .word c" + n + "_2, b" + n + "\n";
+    }
+
+    return source;
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    const std::size_t blocks = (argc > 1) ? std::stoull(argv[1]) : 2500;
+    const int runs = 20;
+
+    const std::string source = generate_source(blocks);
+    const std::size_t lines = static_cast<std::size_t>(std::count(source.begin(), source.end(), '\n'));
+
+    std::size_t size = 0;
+    double best = 1e9;
+
+    for (int run = 0; run < runs; ++run)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const std::vector<std::byte> image = yarisc::arch::assemble_source(source);
+      const auto stop = std::chrono::steady_clock::now();
+
+      size = image.size();
+      best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+
+    std::cout << "lines   " << lines << "\nsource  " << source.size() << " bytes\nimage   " << size << " bytes\n"
+              << std::fixed << std::setprecision(2) << "time    " << (best * 1e3) << " ms\nspeed   "
+              << (static_cast<double>(lines) / best / 1e6) << " Mlines/s" << std::endl;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
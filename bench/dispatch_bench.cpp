@@ -0,0 +1,276 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  struct workload final
+  {
+    std::string_view name;
+    void (*setup)(memory& mem, word_t outer);
+  };
+
+  void store_program(memory& mem, std::initializer_list<word_t> words)
+  {
+    address_t address = 0x0000;
+
+    for (const word_t word : words)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+  /**
+   * @brief Tight count down loop of an ADD and a conditional jump, which is easy to predict for any dispatch
+   */
+  void setup_count_down(memory& mem, word_t outer)
+  {
+    store_program(
+      mem,
+      {
+        assemble<opcode::move>(r5, immediate),
+        outer,
+        assemble<opcode::move>(r0, short_immediate{0x0}), // 0x0004
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+        assemble<opcode::add>(r5, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+        assemble<opcode::halt>(),
+      });
+  }
+
+  /**
+   * @brief Loop with a mix of memory, ALU, and data dependent branch instructions
+   */
+  void setup_mixed(memory& mem, word_t outer)
+  {
+    store_program(
+      mem,
+      {
+        assemble<opcode::move>(r1, immediate),
+        0x1000,
+        assemble<opcode::move>(r5, immediate),
+        outer,
+        assemble<opcode::move>(r0, short_immediate{0x0}), // 0x0008
+        assemble<opcode::load>(r2, r1),                   // 0x000a
+        assemble<opcode::add>(r2, accumulator, short_immediate{0x3}),
+        assemble<opcode::store>(r2, r1),
+        assemble<opcode::add_with_carry>(r3, r3, r2),
+        assemble<opcode::cond_jump>(jc, short_cond_jump_address{0x0016}),
+        assemble<opcode::noop>(),
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}), // 0x0016
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x000a}),
+        assemble<opcode::add>(r5, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0008}),
+        assemble<opcode::halt>(),
+      });
+  }
+
+  /**
+   * @brief Copy loop of a load and a store, which moves 8 KiB in every outer iteration
+   */
+  void setup_copy(memory& mem, word_t outer)
+  {
+    store_program(
+      mem,
+      {
+        assemble<opcode::move>(r5, immediate),
+        outer,
+        assemble<opcode::move>(r0, immediate), // 0x0004
+        0x2000,
+        assemble<opcode::move>(r1, immediate),
+        0x4000,
+        assemble<opcode::move>(r3, immediate),
+        0x8000,
+        assemble<opcode::load>(r2, r1), // 0x0010
+        assemble<opcode::store>(r2, r3),
+        assemble<opcode::add>(r1, accumulator, short_immediate{0x2}),
+        assemble<opcode::add>(r3, accumulator, short_immediate{0x2}),
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0010}),
+        assemble<opcode::add>(r5, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+        assemble<opcode::halt>(),
+      });
+  }
+
+  /**
+   * @brief Loop that increments a 64 bit counter by a chain of additions with carry
+   */
+  void setup_multiword(memory& mem, word_t outer)
+  {
+    store_program(
+      mem,
+      {
+        assemble<opcode::move>(r5, immediate),
+        outer,
+        assemble<opcode::move>(r0, short_immediate{0x0}), // 0x0004
+        assemble<opcode::add>(r1, accumulator, short_immediate{0x1}),
+        assemble<opcode::add_with_carry>(r2, accumulator, short_immediate{0x0}),
+        assemble<opcode::add_with_carry>(r3, accumulator, short_immediate{0x0}),
+        assemble<opcode::add_with_carry>(r4, accumulator, short_immediate{0x0}),
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+        assemble<opcode::add>(r5, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+        assemble<opcode::halt>(),
+      });
+  }
+
+  [[nodiscard]] std::string_view engine_name(execution_engine engine) noexcept
+  {
+    using namespace std::string_view_literals;
+
+    switch (engine)
+    {
+    case execution_engine::interpreter:
+      return "interpreter"sv;
+    case execution_engine::predecoded:
+      return "predecoded"sv;
+    case execution_engine::threaded:
+      return "threaded"sv;
+    case execution_engine::block:
+      return "block"sv;
+    case execution_engine::jit:
+      return "jit"sv;
+    default:
+      return "unknown"sv;
+    }
+  }
+
+  void run(const workload& load, execution_engine engine, execution_mode mode, bool debug, word_t outer)
+  {
+    machine m = debug ? machine{std::make_shared<debugger>()} : machine{};
+    m.set_engine(engine);
+
+    load.setup(m.main_memory(), outer);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto [halted, steps] = m.execute(UINT64_MAX, mode);
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+
+    std::cout << std::left << std::setw(12) << load.name << std::setw(13) << engine_name(engine) << std::setw(8)
+              << (mode == execution_mode::strict ? "strict" : "normal") << std::setw(7) << (debug ? "yes" : "no")
+              << std::right << std::setw(12) << steps << std::setw(10) << std::fixed << std::setprecision(3) << seconds
+              << std::setw(10) << std::setprecision(1) << (static_cast<double>(steps) / seconds / 1e6)
+              << (halted ? "" : "  (not halted)") << '\n';
+  }
+
+  /**
+   * @brief Counts the executed pairs the decode cache fuses, each of which saves an indirect dispatch
+   *
+   * The workload is stepped with the reference interpreter, so only a few outer iterations are counted.
+   */
+  void count_fusions(const workload& load, word_t outer)
+  {
+    using profile = machine_profile<feature_level_latest>;
+
+    machine m;
+    m.set_engine(execution_engine::interpreter);
+
+    load.setup(m.main_memory(), outer);
+
+    std::array<std::uint64_t, 4> fused{};
+    std::uint64_t steps = 0;
+    std::uint64_t pending = 0;
+
+    for (;;)
+    {
+      const memory& mem = std::as_const(m).main_memory();
+      const auto ip = static_cast<address_t>(m.state().reg.named.ip());
+
+      const auto first = detail::decode_instruction<profile>(mem.load(ip));
+      const auto second =
+        detail::decode_instruction<profile>(mem.load(static_cast<address_t>(ip + first.size())));
+
+      if (m.execute(1).second == 0)
+        break;
+
+      // The second instruction of a pair has to be executed too
+      fused[pending] += (pending != 0) ? 1 : 0;
+      pending = static_cast<std::size_t>(detail::fusion_of(first, second));
+      ++steps;
+    }
+
+    const std::uint64_t pairs = fused[1] + fused[2] + fused[3];
+
+    std::cout << std::left << std::setw(12) << load.name << std::right << std::setw(12) << steps << std::setw(12)
+              << fused[1] << std::setw(12) << fused[2] << std::setw(12) << fused[3] << std::setw(12) << (steps - pairs)
+              << std::setw(9) << std::fixed << std::setprecision(1)
+              << (100.0 * static_cast<double>(pairs) / static_cast<double>(steps)) << "%\n";
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    const auto outer = static_cast<word_t>((argc > 1) ? std::stoul(argv[1]) : 200);
+
+    constexpr std::array<workload, 4> workloads{{
+      {"count-down", &setup_count_down},
+      {"mixed", &setup_mixed},
+      {"copy", &setup_copy},
+      {"multiword", &setup_multiword},
+    }};
+
+    constexpr std::array<execution_engine, 5> engines{{
+      execution_engine::interpreter,
+      execution_engine::predecoded,
+      execution_engine::threaded,
+      execution_engine::block,
+      execution_engine::jit,
+    }};
+
+    std::cout << "workload    engine       mode    debug         steps   seconds      MIPS\n";
+
+    for (const workload& load : workloads)
+    {
+      for (const execution_engine engine : engines)
+      {
+        run(load, engine, execution_mode::normal, false, outer);
+        run(load, engine, execution_mode::normal, true, outer);
+        run(load, engine, execution_mode::strict, true, outer);
+      }
+    }
+
+    std::cout << "\nworkload           steps   add/adc+j     ldr+str   add/adc+adc  dispatches    saved\n";
+
+    for (const workload& load : workloads)
+      count_fusions(load, 2);
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/output.hpp>
+#include <yarisc/utils/screen.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace
+{
+  using namespace yarisc;
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  /**
+   * @brief Memory window of the viewer
+   */
+  constexpr address_t window_base = 0x0000;
+  constexpr memory::size_type window_size = 256;
+
+  /**
+   * @brief Loop that adds the address to every word of the memory window after the code
+   */
+  void setup_scan(memory& mem)
+  {
+    const std::array<word_t, 12> program{{
+      assemble<opcode::move>(r1, immediate),
+      0x0040,
+      assemble<opcode::move>(r0, immediate),
+      0x0060,
+      assemble<opcode::load>(r2, r1), // 0x0008
+      assemble<opcode::add>(r2, r2, r1),
+      assemble<opcode::store>(r2, r1),
+      assemble<opcode::add>(r1, accumulator, short_immediate{0x2}),
+      assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+      assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0008}),
+      assemble<opcode::move>(ip, short_immediate{0x0}),
+      assemble<opcode::noop>(),
+    }};
+
+    address_t address = 0x0000;
+
+    for (const word_t word : program)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+  /**
+   * @brief Returns the number of bytes of the control sequences in the given text
+   */
+  [[nodiscard]] std::size_t escape_bytes(std::string_view text) noexcept
+  {
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+      if ((text[i] == '\033') && (i + 1 < text.size()) && (text[i + 1] == '['))
+      {
+        std::size_t end = i + 2;
+
+        while ((end < text.size()) && ((text[end] < '@') || (text[end] > '~')))
+          ++end;
+
+        count += end + 1 - i;
+        i = end;
+      }
+    }
+
+    return count;
+  }
+
+  struct frame_bytes final
+  {
+    std::uint64_t total{0};
+    std::uint64_t escape{0};
+
+    void add(std::string_view text) noexcept
+    {
+      total += text.size();
+      escape += escape_bytes(text);
+    }
+  };
+
+  void print(std::string_view name, std::string_view output, std::uint64_t frames, const frame_bytes& bytes)
+  {
+    const auto per_frame = [&](std::uint64_t value)
+    { return static_cast<double>(value) / static_cast<double>(frames); };
+
+    std::cout << std::left << std::setw(8) << name << std::setw(8) << output << std::right << std::setw(8) << frames
+              << std::fixed << std::setprecision(1) << std::setw(14) << per_frame(bytes.total) << std::setw(14)
+              << per_frame(bytes.escape) << std::setw(9)
+              << (100.0 * static_cast<double>(bytes.escape) / static_cast<double>(bytes.total)) << "%\n";
+  }
+
+  /**
+   * @brief Displays the machine every given number of steps like the viewer and counts the bytes of the frames
+   *
+   * The full frame is the colored text of the debugger view. The screen output only updates the cells that have changed
+   * since the previous frame, which is what the viewer writes to a terminal.
+   */
+  void run(std::string_view name, std::uint64_t steps_per_frame, std::uint64_t frames)
+  {
+    machine m;
+    setup_scan(m.main_memory());
+
+    machine_state previous_state = m.state();
+    auto previous_memory = std::make_unique<memory::value_type[]>(window_size);
+
+    utils::screen screen;
+    std::string text;
+    std::string out;
+
+    frame_bytes full;
+    frame_bytes incremental;
+
+    for (std::uint64_t frame = 0; frame < frames; ++frame)
+    {
+      std::memcpy(previous_memory.get(), m.main_memory().data() + window_base, window_size);
+      previous_state = m.state();
+
+      m.execute(steps_per_frame);
+
+      // The viewer does not highlight the instruction pointer because it changes almost always
+      registers_view previous_registers{previous_state.reg};
+      const registers_view current_registers = m.state_view();
+      previous_registers.named.set_ip(current_registers.named.ip());
+      previous_registers.instruction = current_registers.instruction;
+
+      const debugger_view view{
+        nullptr,
+        current_registers,
+        m.main_memory(window_base, window_size),
+        previous_registers,
+        memory_view{previous_memory.get(), window_size, window_base, &previous_state},
+        "",
+        ""};
+
+      text.clear();
+      output_to(text, view, output_format::colored);
+      full.add(text);
+
+      out.clear();
+      screen.render(text, out);
+      incremental.add(out);
+    }
+
+    print(name, "full", frames, full);
+    print(name, "screen", frames, incremental);
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  try
+  {
+    const std::uint64_t frames = (argc > 1) ? std::stoull(argv[1]) : 1000;
+
+    std::cout << "run     output    frames   bytes/frame  escape/frame   escape\n";
+
+    run("step", 1, frames);
+    run("live", 0x1000, frames);
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -5,36 +5,180 @@
 
 #include <emu/emulator.hpp>
 
+#include <emu/gdb_stub.hpp>
+
+#include <yarisc/arch/condition.hpp>
 #include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/history.hpp>
 #include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/monitor.hpp>
+#include <yarisc/arch/output.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/ios.hpp>
+#include <yarisc/utils/screen.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <charconv>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <utility>
 
+#if defined(_WIN32)
+#include <conio.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 namespace yarisc::emu
 {
   namespace
   {
-    template <utils::color::context Ctx>
-    [[nodiscard]] auto reset_cursor(Ctx& ctx, bool clear_screen)
+    /**
+     * @brief Parses a decimal or hexadecimal address with the prefix `0x`
+     */
+    [[nodiscard]] std::optional<arch::address_t> parse_address(std::string_view str) noexcept
     {
-      using namespace std::string_view_literals;
+      const bool hex = str.starts_with("0x") || str.starts_with("0X");
+
+      if (hex)
+        str.remove_prefix(2);
+
+      arch::address_t address = 0;
+      const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), address, hex ? 16 : 10);
+
+      if (str.empty() || (ec != std::errc{}) || (ptr != str.data() + str.size()))
+        return std::nullopt;
+
+      return address;
+    }
+
+    /**
+     * @brief Waits until there is input on standard input or the timeout has elapsed
+     *
+     * @return whether there is input
+     */
+    [[nodiscard]] bool wait_for_input(std::chrono::milliseconds timeout)
+    {
+      if (std::cin.rdbuf()->in_avail() > 0)
+        return true;
+
+#if defined(_WIN32)
+      const auto end = std::chrono::steady_clock::now() + timeout;
+
+      while (!::_kbhit())
+      {
+        if (std::chrono::steady_clock::now() >= end)
+          return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+
+      return true;
+#else
+      pollfd fd{STDIN_FILENO, POLLIN, 0};
+
+      return ::poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+#endif
+    }
+
+    [[nodiscard]] std::string format_address(arch::address_t address)
+    {
+      std::ostringstream oss;
+      oss << "0x" << std::setfill('0') << std::setw(4) << std::hex << address;
+
+      return std::move(oss).str();
+    }
+
+    /**
+     * @brief Writes a string as JSON string literal
+     */
+    std::ostream& output_json_string(std::ostream& os, std::string_view str)
+    {
+      constexpr std::string_view digits = "0123456789abcdef";
 
-      return utils::color::manip(ctx, clear_screen ? "\033[H\033[2J"sv : "\033[H"sv);
+      os << '"';
+
+      for (const char ch : str)
+      {
+        if ((ch == '"') || (ch == '\\'))
+          os << '\\' << ch;
+        else if (static_cast<unsigned char>(ch) < 0x20)
+          os << "\\u00" << digits[static_cast<unsigned char>(ch) >> 4] << digits[ch & 0xf];
+        else
+          os << ch;
+      }
+
+      return os << '"';
     }
 
   } // namespace
 
+  void output_json(std::ostream& os, const run_report& report)
+  {
+    using namespace std::string_view_literals;
+
+    constexpr std::array<std::string_view, arch::num_registers> names{{"r0", "r1", "r2", "r3", "r4", "r5", "sp", "ip"}};
+
+    const utils::ostream_guard guard{os};
+
+    os << "{\"reason\":"sv;
+
+    switch (report.reason)
+    {
+    case stop_reason::halt:
+      os << "\"halt\""sv;
+      break;
+    case stop_reason::step_limit:
+      os << "\"step_limit\""sv;
+      break;
+    case stop_reason::panic:
+      os << "\"panic\""sv;
+      break;
+    }
+
+    os << ",\"steps\":"sv;
+
+    if (report.steps)
+      os << std::dec << *report.steps;
+    else
+      os << "null"sv;
+
+    os << ",\"wall_time\":"sv << std::fixed << std::setprecision(6) << report.wall_time.count() << ",\"mips\":"sv;
+
+    if (const auto mips = report.mips())
+      os << std::setprecision(3) << *mips;
+    else
+      os << "null"sv;
+
+    output_json_string(os << ",\"message\":"sv, report.message) << ",\"registers\":{"sv;
+
+    for (std::size_t i = 0; i < names.size(); ++i)
+      os << '"' << names[i] << "\":"sv << std::dec << report.registers.named.r[i] << ',';
+
+    os << "\"status\":"sv << report.registers.status.s << "}}\n"sv;
+  }
+
   class emulator::viewer : public viewer_base
   {
   public:
@@ -48,6 +192,7 @@ namespace yarisc::emu
       const arch::debugger_ptr dbg = get_debugger();
 
       session_->set_clear_display();
+      session_->reset_history(m);
 
       for (;;)
       {
@@ -55,7 +200,7 @@ namespace yarisc::emu
 
         session_->display(m, ctx, dbg.get());
 
-        const auto [exit, steps] = user_prompt(m, ctx, dbg.get());
+        const auto [exit, steps] = user_prompt(m, ctx, mode, dbg.get());
 
         if (exit)
         {
@@ -81,8 +226,11 @@ namespace yarisc::emu
   private:
     static constexpr std::string_view info_message = "Type 'h' for a list of commands";
     static constexpr std::string_view help_message =
-      "Commands: h: help, hh: more help, e: exit, r: reset, l <path>: load image";
-    static constexpr std::string_view more_help_message = "Commands: s: single step, x: execute";
+      "Commands: h: help, hh: more, hb: breakpoints, e: exit, r: reset, l <path>: load";
+    static constexpr std::string_view more_help_message =
+      "Commands: s: step, x: execute, lx: execute live, b: back, rc: reverse continue";
+    static constexpr std::string_view breakpoint_help_message =
+      "Commands: b <addr> [if <cond>]: add, bd <addr>: delete, bl: list, bc: clear";
 
     static constexpr std::string_view finished_message = "Program has finished";
 
@@ -101,29 +249,16 @@ namespace yarisc::emu
 
       void display(const arch::machine& m, utils::color::dynamic_context& ctx, const arch::debugger* dbg)
       {
-        const arch::registers_view current_registers = m.state_view();
-        const arch::memory_view current_memory =
-          m.main_memory(static_cast<size_type>(memory_debug_base_), memory_debug_size_);
-
-        const arch::registers_view previous_registers{previous_state_.reg};
-        const arch::memory_view previous_memory{
-          previous_memory_.get(), memory_debug_size_, memory_debug_base_, &previous_state_};
-
         const std::string_view info = info_message_.empty() && error_message_.empty() ? info_message : info_message_;
-        const std::string_view error = error_message_;
-
-        const arch::debugger_view view{
-          dbg, current_registers, current_memory, previous_registers, previous_memory, info, error};
 
-        // It is faster to accumulate everyting in a string first and then output the whole string at once
-        std::ostringstream oss;
-        oss << reset_cursor(ctx, clear_display_) << utils::color::reset(ctx) << view;
-
-        assert(!ctx.dirty());
+        display(
+          m.state_view(),
+          m.main_memory(static_cast<size_type>(memory_debug_base_), memory_debug_size_),
+          ctx,
+          dbg,
+          info,
+          error_message_);
 
-        std::cout << std::move(oss).str();
-
-        clear_display_ = false;
         message_displayed_ = true;
       }
 
@@ -136,7 +271,7 @@ namespace yarisc::emu
       {
         if (check_execute(m))
         {
-          finished_ = m.execute(mode) || (dbg && dbg->panic());
+          finished_ = history_.execute(m, mode) || (dbg && dbg->panic());
           previous_steps_ = 0;
         }
       }
@@ -145,13 +280,151 @@ namespace yarisc::emu
       {
         if ((steps > 0) && check_execute(m))
         {
-          const auto result = m.execute(steps, mode);
+          const auto result = history_.execute(m, steps, mode);
 
           finished_ = result.first || (dbg && dbg->panic());
           previous_steps_ = result.second;
         }
       }
 
+      /**
+       * @brief Executes on a worker thread until the machine stops or input arrives, displaying samples meanwhile
+       *
+       * The worker executes in chunks of steps and publishes a sample of the registers and the displayed memory after
+       * each chunk, unless the display is just copying the previous sample. The display never blocks the worker.
+       */
+      void execute_live(
+        arch::machine& m, arch::execution_mode mode, const arch::debugger* dbg, utils::color::dynamic_context& ctx)
+      {
+        if (!check_execute(m))
+          return;
+
+        live_sample shared{memory_debug_size_};
+        live_sample displayed{memory_debug_size_};
+        std::mutex mutex;
+
+        std::atomic<bool> pause{false};
+        std::atomic<bool> done{false};
+        std::exception_ptr error{};
+        std::pair<bool, std::uint64_t> result{false, 0};
+
+        std::thread worker{[&]() {
+          try
+          {
+            for (bool first = true; !pause.load(std::memory_order_relaxed); first = false)
+            {
+              const auto [halted, steps] = first ? history_.execute(m, live_chunk_steps, mode)
+                                                 : history_.continue_execution(m, live_chunk_steps, mode);
+
+              result.first = halted;
+              result.second += steps;
+
+              if (const std::unique_lock lock{mutex, std::try_to_lock}; lock.owns_lock())
+                shared.take(m, memory_debug_base_, memory_debug_size_, history_.step());
+
+              if (halted || (steps < live_chunk_steps))
+                break;
+            }
+          }
+          catch (...)
+          {
+            error = std::current_exception();
+          }
+
+          done.store(true, std::memory_order_release);
+        }};
+
+        while (!done.load(std::memory_order_acquire))
+        {
+          if (wait_for_input(live_frame_interval))
+          {
+            pause.store(true, std::memory_order_relaxed);
+
+            std::string ignored;
+            std::getline(std::cin, ignored);
+
+            break;
+          }
+
+          if (!ctx.enabled())
+            continue;
+
+          {
+            const std::lock_guard lock{mutex};
+            displayed.copy(shared, memory_debug_size_);
+          }
+
+          const std::string info = "Executing live at step " + std::to_string(displayed.step) + ", Enter pauses";
+
+          display(
+            displayed.registers(),
+            arch::memory_view{displayed.memory.get(), memory_debug_size_, memory_debug_base_, &displayed.state},
+            ctx,
+            dbg,
+            info,
+            {});
+
+          std::cout << std::flush;
+        }
+
+        worker.join();
+
+        if (error)
+          std::rethrow_exception(error);
+
+        finished_ = result.first || (dbg && dbg->panic());
+        previous_steps_ = result.second;
+
+        if (pause.load(std::memory_order_relaxed) && !finished_)
+          set_info_message("Paused at step " + std::to_string(history_.step()));
+      }
+
+      void step_back(arch::machine& m, arch::execution_mode mode, arch::debugger* dbg)
+      {
+        if (history_.step() == 0)
+        {
+          set_error_message("Already at the first step");
+
+          return;
+        }
+
+        rewind(m, dbg);
+        history_.step_back(m, 1, mode);
+
+        if (dbg)
+          dbg->reset_message();
+
+        finished_ = false;
+        set_info_message("Stepped back to step " + std::to_string(history_.step()));
+      }
+
+      void reverse_continue(arch::machine& m, arch::execution_mode mode, arch::debugger* dbg)
+      {
+        const bool panic = rewind(m, dbg);
+
+        if (const auto step = history_.reverse_continue(m, mode))
+        {
+          finished_ = false;
+
+          // The message of a watchpoint is displayed like for forward execution
+          if (!dbg || dbg->message().empty())
+            set_info_message("Reverse continued to step " + std::to_string(*step));
+        }
+        else
+        {
+          if (dbg)
+            dbg->reset_message();
+
+          finished_ = finished_ && !panic;
+          set_error_message("No earlier breakpoint");
+        }
+      }
+
+      void reset_history(const arch::machine& m)
+      {
+        history_.reset(m);
+      }
+
       template <typename Arg>
       void set_info_message(Arg&& msg)
       {
@@ -211,16 +484,136 @@ namespace yarisc::emu
       std::string info_message_{};
       std::string error_message_{};
 
+      utils::screen screen_{};
+      std::string view_{};
+      std::string frame_{};
+
       using size_type = arch::memory::size_type;
 
       arch::address_t memory_debug_base_{0};
       size_type memory_debug_size_{256};
 
+      /**
+       * @brief Number of steps the worker of the live execution executes between two samples
+       */
+      static constexpr std::uint64_t live_chunk_steps = 0x10000;
+
+      /**
+       * @brief Interval between two displays of the live execution, which are about 30 per second
+       */
+      static constexpr std::chrono::milliseconds live_frame_interval{33};
+
+      /**
+       * @brief Consistent copy of the registers and the displayed memory taken between two steps
+       */
+      struct live_sample final
+      {
+        arch::machine_state state{};
+        std::optional<std::array<arch::word_t, 2>> instruction{};
+        std::unique_ptr<arch::memory::value_type[]> memory;
+        std::uint64_t step{0};
+
+        explicit live_sample(size_type size)
+          : memory{std::make_unique<arch::memory::value_type[]>(size)}
+        {
+        }
+
+        void take(const arch::machine& m, arch::address_t base, size_type size, std::uint64_t s)
+        {
+          state = m.state();
+          instruction = m.state_view().instruction;
+          std::memcpy(memory.get(), m.main_memory().data() + base, size);
+          step = s;
+        }
+
+        void copy(const live_sample& that, size_type size)
+        {
+          state = that.state;
+          instruction = that.instruction;
+          std::memcpy(memory.get(), that.memory.get(), size);
+          step = that.step;
+        }
+
+        [[nodiscard]] arch::registers_view registers() const
+        {
+          arch::registers_view reg{state.reg};
+          reg.instruction = instruction;
+
+          return reg;
+        }
+      };
+
       std::uint64_t previous_steps_{0};
+      arch::execution_history history_{};
       arch::machine_state previous_state_{};
       std::unique_ptr<arch::memory::value_type[]> previous_memory_{
         std::make_unique<arch::memory::value_type[]>(memory_debug_size_)};
 
+      void display(
+        const arch::registers_view& current_registers,
+        const arch::memory_view& current_memory,
+        utils::color::dynamic_context& ctx,
+        const arch::debugger* dbg,
+        std::string_view info,
+        std::string_view error)
+      {
+        const arch::registers_view previous_registers{previous_state_.reg};
+        const arch::memory_view previous_memory{
+          previous_memory_.get(), memory_debug_size_, memory_debug_base_, &previous_state_};
+
+        const arch::debugger_view view{
+          dbg, current_registers, current_memory, previous_registers, previous_memory, info, error};
+
+        // It is faster to accumulate everyting in a string first and then output the whole string at once
+        view_.clear();
+
+        utils::text_buffer buf{view_};
+        buf << utils::color::reset(ctx);
+
+        arch::output_to(view_, view, ctx.enabled() ? arch::output_format::colored : arch::output_format::plain);
+
+        assert(!ctx.dirty());
+
+        if (ctx.enabled())
+        {
+          // Only the cells that have changed since the previous display are output
+          if (clear_display_)
+            screen_.invalidate();
+
+          frame_.clear();
+          screen_.render(view_, frame_);
+
+          std::cout << frame_;
+        }
+        else
+        {
+          std::cout << view_;
+        }
+
+        clear_display_ = false;
+      }
+
+      /**
+       * @brief Prepares going back in the history, which leaves any panic behind
+       *
+       * @return whether the debugger has panicked
+       */
+      bool rewind(const arch::machine& m, arch::debugger* dbg)
+      {
+        reset_messages();
+        update_state(m);
+
+        const bool panic = dbg && dbg->panic();
+
+        if (dbg)
+        {
+          dbg->reset_panic();
+          dbg->reset_message();
+        }
+
+        return panic;
+      }
+
       [[nodiscard]] bool check_execute(const arch::machine& m)
       {
         if (finished_)
@@ -242,7 +635,7 @@ namespace yarisc::emu
     bool already_clear_{true};
 
     [[nodiscard]] std::pair<bool, std::optional<std::uint64_t>> user_prompt(
-      arch::machine& m, utils::color::dynamic_context& ctx, arch::debugger* dbg)
+      arch::machine& m, utils::color::dynamic_context& ctx, arch::execution_mode mode, arch::debugger* dbg)
     {
       using namespace std::string_view_literals;
 
@@ -288,18 +681,39 @@ namespace yarisc::emu
           session_->set_info_message(help_message);
         else if (command == "hh")
           session_->set_info_message(more_help_message);
+        else if (command == "hb")
+          session_->set_info_message(breakpoint_help_message);
         else if (command == "e")
           exit = true;
         else if (command == "s")
           steps = 1;
         else if (command == "x")
           steps.reset();
+        else if (command == "lx")
+          session_->execute_live(m, mode, dbg, ctx);
+        else if (command == "b")
+          session_->step_back(m, mode, dbg);
+        else if (command == "rc")
+          session_->reverse_continue(m, mode, dbg);
         else if (command == "r")
           reset_machine(m, dbg);
         else if (command == "l")
           session_->set_error_message("Load command expects an image file path: l path/to/image");
         else if (command.starts_with("l "))
           reset_machine(m, dbg, command.substr(2));
+        else if (command == "bd")
+          session_->set_error_message("Delete breakpoint command expects an address: bd 0x0100");
+        else if (command.starts_with("b "))
+          add_breakpoint(dbg, std::string_view{command}.substr(2));
+        else if (command.starts_with("bd "))
+          remove_breakpoint(dbg, std::string_view{command}.substr(3));
+        else if (command == "bl")
+          list_breakpoints(dbg);
+        else if (command == "bc")
+        {
+          dbg->clear_breakpoints();
+          session_->set_info_message("All breakpoints removed");
+        }
         else
           session_->set_error_message("Unknown command: " + command);
       }
@@ -309,6 +723,63 @@ namespace yarisc::emu
       return {exit, steps};
     }
 
+    void add_breakpoint(arch::debugger* dbg, std::string_view args)
+    {
+      using namespace std::string_literals;
+
+      const std::size_t separator = args.find(" if ");
+      const std::optional<arch::address_t> address = parse_address(args.substr(0, separator));
+
+      if (!address)
+      {
+        session_->set_error_message("Breakpoint command expects an address: b 0x0100 [if r0 == 0x10]");
+
+        return;
+      }
+
+      try
+      {
+        if (separator != std::string_view::npos)
+          dbg->add_breakpoint(*address, arch::breakpoint_condition{args.substr(separator + 4)});
+        else
+          dbg->add_breakpoint(*address);
+
+        session_->set_info_message("Breakpoint at " + format_address(*address));
+      }
+      catch (const std::exception& ex)
+      {
+        session_->set_error_message("Error: "s + ex.what());
+      }
+    }
+
+    void remove_breakpoint(arch::debugger* dbg, std::string_view args)
+    {
+      const std::optional<arch::address_t> address = parse_address(args);
+
+      if (!address || !arch::detail::is_aligned(*address))
+        session_->set_error_message("Delete command expects a word-aligned address: bd 0x0100");
+      else if (dbg->remove_breakpoint(*address))
+        session_->set_info_message("Breakpoint at " + format_address(*address) + " removed");
+      else
+        session_->set_error_message("No breakpoint at " + format_address(*address));
+    }
+
+    void list_breakpoints(const arch::debugger* dbg)
+    {
+      std::string list;
+
+      for (const arch::address_t address : dbg->breakpoints())
+      {
+        list += list.empty() ? "Breakpoints: " : ", ";
+        list += format_address(address);
+
+        if (const arch::breakpoint_condition* condition = dbg->condition(address))
+          list += " if " + condition->source();
+      }
+
+      session_->set_info_message(list.empty() ? "No breakpoints" : list);
+    }
+
     void reset_machine(
       arch::machine& m, arch::debugger* dbg, const std::optional<std::filesystem::path>& image = std::nullopt)
     {
@@ -346,11 +817,48 @@ namespace yarisc::emu
       {
         session_->set_info_message("Reset to initial state");
       }
+
+      session_->reset_history(m);
+    }
+  };
+
+  class emulator::remote : public viewer_base
+  {
+  public:
+    remote()
+      : viewer_base{std::make_shared<arch::debugger>()}
+    {
+#if defined(_WIN32)
+      // Binary packets must not be translated
+      _setmode(_fileno(stdin), _O_BINARY);
+      _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    bool execute(arch::machine& m, arch::execution_mode mode) override
+    {
+      gdb_stub{m, *get_debugger(), std::cin, std::cout}.serve(mode);
+
+      // The session is always ended by the frontend
+      return true;
     }
   };
 
+  std::unique_ptr<emulator::viewer_base> emulator::make_viewer(emulator_mode mode)
+  {
+    switch (mode)
+    {
+    case emulator_mode::interactive:
+      return std::make_unique<viewer>();
+    case emulator_mode::remote:
+      return std::make_unique<remote>();
+    default:
+      return nullptr;
+    }
+  }
+
   emulator::emulator(arch::feature_level level, emulator_mode mode)
-    : viewer_{(mode == emulator_mode::interactive) ? std::make_unique<viewer>() : nullptr}
+    : viewer_{make_viewer(mode)}
     , machine_{viewer_ ? viewer_->get_debugger() : nullptr, level}
   {
   }
@@ -359,7 +867,158 @@ namespace yarisc::emu
     : emulator{level, mode}
   {
     if (!image.empty())
+    {
       machine_.load(image);
+
+      image_ = image;
+      image_size_ = static_cast<std::size_t>(std::filesystem::file_size(image));
+    }
+  }
+
+  void emulator::enable_trace(std::size_t capacity)
+  {
+    monitor().enable_trace(capacity);
+  }
+
+  void emulator::enable_profile()
+  {
+    monitor().enable_profile();
+  }
+
+  void emulator::enable_statistics()
+  {
+    monitor().enable_statistics();
+  }
+
+  void emulator::enable_coverage(const std::filesystem::path& path, arch::coverage_format format)
+  {
+    monitor().enable_coverage();
+
+    coverage_path_ = path;
+    coverage_format_ = format;
+  }
+
+  void emulator::enable_cycles()
+  {
+    monitor().enable_cycles(machine_.level());
+  }
+
+  arch::execution_monitor& emulator::monitor()
+  {
+    if (!machine_.monitor())
+      machine_.set_monitor(std::make_shared<arch::execution_monitor>());
+
+    return *machine_.monitor();
+  }
+
+  run_report emulator::run(std::uint64_t steps, arch::execution_mode mode)
+  {
+    if (viewer_)
+      throw std::runtime_error{"Only an unattended emulator can run without viewer"};
+
+    run_report report;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+      const auto [halted, executed] = machine_.execute(steps, mode);
+
+      report.wall_time = std::chrono::steady_clock::now() - start;
+      report.reason = halted ? stop_reason::halt : stop_reason::step_limit;
+      report.steps = executed;
+    }
+    catch (const std::exception& ex)
+    {
+      report.wall_time = std::chrono::steady_clock::now() - start;
+      report.reason = stop_reason::panic;
+      report.message = ex.what();
+
+      write_trace();
+    }
+
+    report.registers = machine_.state().reg;
+
+    write_reports();
+
+    return report;
+  }
+
+  bool emulator::execute_unattended(arch::execution_mode mode)
+  {
+    try
+    {
+      const bool halted = machine_.execute(mode);
+
+      write_reports();
+
+      return halted;
+    }
+    catch (const std::exception&)
+    {
+      write_reports();
+      write_trace();
+
+      throw;
+    }
+  }
+
+  void emulator::write_reports() const
+  {
+    const arch::execution_monitor* mon = machine_.monitor().get();
+
+    if (!mon)
+      return;
+
+    // Standard output is kept free for the JSON report of an unattended run
+    if (mon->profile())
+      std::cerr << arch::profile_view{mon->profile(), &machine_.main_memory(), 20, machine_.level()} << std::flush;
+
+    if (mon->statistics())
+      std::cerr << *mon->statistics() << std::flush;
+
+    if (mon->cycles())
+      std::cerr << *mon->cycles() << std::flush;
+
+    if (mon->coverage())
+      write_coverage();
+  }
+
+  void emulator::write_trace() const
+  {
+    const arch::execution_monitor* mon = machine_.monitor().get();
+
+    if (mon && mon->trace())
+    {
+      std::cerr << "Last executed instructions:\n";
+      arch::output(std::cerr, *mon->trace());
+      std::cerr << std::flush;
+    }
+  }
+
+  void emulator::write_coverage() const
+  {
+    const arch::memory& mem = machine_.main_memory();
+    const std::string source = image_.string();
+
+    std::ofstream fs{coverage_path_};
+
+    if (!fs.is_open())
+      throw std::runtime_error{"could not open coverage file"};
+
+    arch::output(
+      fs,
+      arch::coverage_view{
+        machine_.monitor()->coverage(),
+        &mem,
+        image_.empty() ? mem.size() : image_size_,
+        coverage_format_,
+        source,
+        machine_.level()},
+      arch::output_format::plain);
+
+    if (!fs)
+      throw std::runtime_error{"could not write coverage file"};
   }
 
 } // namespace yarisc::emu
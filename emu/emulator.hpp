@@ -8,9 +8,17 @@
 
 #include <yarisc/arch/feature_level.hpp>
 #include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/monitor.hpp>
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <iosfwd>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace yarisc::emu
 {
@@ -28,8 +36,75 @@ namespace yarisc::emu
      * @brief Execute with prompt and debug viewer
      */
     interactive,
+
+    /**
+     * @brief Serve the GDB remote serial protocol over standard input and output to a debugger frontend
+     */
+    remote,
+  };
+
+  /**
+   * @brief Reason why an unattended run has stopped
+   */
+  enum class stop_reason
+  {
+    /**
+     * @brief A halt instruction was executed
+     */
+    halt,
+
+    /**
+     * @brief The maximum number of steps was executed
+     */
+    step_limit,
+
+    /**
+     * @brief The machine panicked, e.g. on an invalid instruction
+     */
+    panic,
+  };
+
+  /**
+   * @brief Summary of an unattended run
+   */
+  struct run_report final
+  {
+    stop_reason reason{stop_reason::halt};
+
+    /**
+     * @brief Number of executed steps, which is unknown after a panic
+     */
+    std::optional<std::uint64_t> steps{};
+
+    std::chrono::duration<double> wall_time{};
+
+    /**
+     * @brief Panic message
+     */
+    std::string message{};
+
+    arch::machine_registers registers{};
+
+    /**
+     * @brief Returns the executed million instructions per second, if the steps are known
+     */
+    [[nodiscard]] std::optional<double> mips() const noexcept
+    {
+      if (!steps || (wall_time.count() <= 0.0))
+        return std::nullopt;
+
+      return static_cast<double>(*steps) / wall_time.count() / 1e6;
+    }
   };
 
+  /**
+   * @brief Writes a report as a JSON object on a single line
+   *
+   * The object has the members `reason`, `steps`, `wall_time` in seconds, `mips`, `message`, and `registers`, which
+   * maps the register names to their values. Unknown values are null.
+   */
+  void output_json(std::ostream& os, const run_report& report);
+
   /**
    * @brief Emulator that executes a program on an emulated YaRISC CPU
    */
@@ -68,9 +143,73 @@ namespace yarisc::emu
      */
     bool execute(arch::execution_mode mode = arch::execution_mode::normal)
     {
-      return viewer_ ? viewer_->execute(machine_, mode) : machine_.execute(mode);
+      return viewer_ ? viewer_->execute(machine_, mode) : execute_unattended(mode);
     }
 
+    /**
+     * @brief Executes the program at address zero without viewer and summarizes the run
+     *
+     * The reports that are enabled in the emulator are written like after unattended execution, which keeps standard
+     * output free for the summary, but a panic is reported instead of thrown.
+     *
+     * @param steps maximum number of steps
+     * @param mode execution mode normal or strict
+     */
+    [[nodiscard]] run_report run(
+      std::uint64_t steps = std::numeric_limits<std::uint64_t>::max(),
+      arch::execution_mode mode = arch::execution_mode::normal);
+
+    /**
+     * @brief Sets the engine of the emulated machine
+     */
+    void set_engine(arch::execution_engine engine) noexcept
+    {
+      machine_.set_engine(engine);
+    }
+
+    /**
+     * @brief Records the last executed instructions, which are written to standard error if the machine panics
+     *
+     * The machine executes with the reference interpreter while the trace is enabled.
+     *
+     * @param capacity minimum number of instructions kept
+     */
+    void enable_trace(std::size_t capacity);
+
+    /**
+     * @brief Counts the executed instructions, whose report is written to standard error after unattended execution
+     *
+     * The machine executes with the reference interpreter while the profile is enabled.
+     */
+    void enable_profile();
+
+    /**
+     * @brief Counts the executed instructions per opcode and operand form, whose statistics are written to standard
+     * error after unattended execution
+     *
+     * The machine executes with the reference interpreter while the statistics are enabled.
+     */
+    void enable_statistics();
+
+    /**
+     * @brief Records the code coverage, which is written to a file after unattended execution
+     *
+     * The coverage lists the instructions of the loaded image, or of the whole main memory if no image was loaded. The
+     * machine executes with the reference interpreter while the coverage is enabled.
+     *
+     * @param path path to the file to be written
+     * @param format file format lcov or CSV
+     */
+    void enable_coverage(const std::filesystem::path& path, arch::coverage_format format);
+
+    /**
+     * @brief Estimates the cycles of the executed instructions, which are written to standard error after unattended
+     * execution
+     *
+     * The machine executes with the reference interpreter while the cycles are counted.
+     */
+    void enable_cycles();
+
   private:
     class viewer_base
     {
@@ -88,7 +227,7 @@ namespace yarisc::emu
       viewer_base& operator=(const viewer_base& that) = delete;
       viewer_base& operator=(viewer_base&& that) = delete;
 
-      [[nodsicard]] const arch::debugger_ptr& get_debugger() const noexcept
+      [[nodiscard]] const arch::debugger_ptr& get_debugger() const noexcept
       {
         return debugger_;
       }
@@ -100,9 +239,28 @@ namespace yarisc::emu
     };
 
     class viewer;
+    class remote;
+
+    [[nodiscard]] static std::unique_ptr<viewer_base> make_viewer(emulator_mode mode);
+
+    [[nodiscard]] arch::execution_monitor& monitor();
+
+    bool execute_unattended(arch::execution_mode mode);
+
+    void write_reports() const;
+
+    void write_trace() const;
+
+    void write_coverage() const;
 
     std::unique_ptr<viewer_base> viewer_{};
     arch::machine machine_{};
+
+    std::filesystem::path image_{};
+    std::size_t image_size_{0};
+
+    std::filesystem::path coverage_path_{};
+    arch::coverage_format coverage_format_{arch::coverage_format::lcov};
   };
 
 } // namespace yarisc::emu
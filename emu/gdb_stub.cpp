@@ -0,0 +1,591 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <emu/gdb_stub.hpp>
+
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/registers.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace yarisc::emu
+{
+  namespace
+  {
+    using namespace std::string_view_literals;
+
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+
+    /**
+     * @brief Named registers followed by the status register
+     */
+    constexpr std::size_t num_registers = arch::num_registers + 1;
+
+    constexpr std::string_view target_description =
+      R"(<?xml version="1.0"?><!DOCTYPE target SYSTEM "gdb-target.dtd"><target version="1.0">)"
+      R"(<feature name="org.yarisc.core">)"
+      R"(<reg name="r0" bitsize="16" type="int"/><reg name="r1" bitsize="16" type="int"/>)"
+      R"(<reg name="r2" bitsize="16" type="int"/><reg name="r3" bitsize="16" type="int"/>)"
+      R"(<reg name="r4" bitsize="16" type="int"/><reg name="r5" bitsize="16" type="int"/>)"
+      R"(<reg name="sp" bitsize="16" type="data_ptr"/><reg name="ip" bitsize="16" type="code_ptr"/>)"
+      R"(<reg name="status" bitsize="16" type="int"/>)"
+      R"(</feature></target>)";
+
+    /**
+     * @brief Characters that have to be escaped in packets
+     */
+    [[nodiscard]] bool escaped(char c) noexcept
+    {
+      return (c == '$') || (c == '#') || (c == '}') || (c == '*');
+    }
+
+    void append_byte(std::string& str, std::uint8_t value)
+    {
+      str.push_back(hex_digits[value >> 4]);
+      str.push_back(hex_digits[value & 0xf]);
+    }
+
+    /**
+     * @brief Appends a word in the byte order of the machine
+     */
+    void append_word(std::string& str, arch::word_t value)
+    {
+      append_byte(str, static_cast<std::uint8_t>(value & 0xff));
+      append_byte(str, static_cast<std::uint8_t>(value >> 8));
+    }
+
+    [[nodiscard]] std::string encode(std::string_view text)
+    {
+      std::string result;
+      result.reserve(2 * text.size());
+
+      for (const char c : text)
+        append_byte(result, static_cast<std::uint8_t>(c));
+
+      return result;
+    }
+
+    /**
+     * @brief Parses a hexadecimal number, which has to span the whole string
+     */
+    template <typename T>
+    [[nodiscard]] std::optional<T> parse_number(std::string_view str) noexcept
+    {
+      T value{};
+      const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value, 16);
+
+      if (str.empty() || (ec != std::errc{}) || (ptr != str.data() + str.size()))
+        return {};
+
+      return value;
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> parse_byte(std::string_view str) noexcept
+    {
+      return (str.size() == 2) ? parse_number<std::uint8_t>(str) : std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<arch::word_t> parse_word(std::string_view str) noexcept
+    {
+      if (str.size() != 4)
+        return {};
+
+      const auto low = parse_byte(str.substr(0, 2));
+      const auto high = parse_byte(str.substr(2, 2));
+
+      if (!low || !high)
+        return {};
+
+      return static_cast<arch::word_t>(*low | (*high << 8));
+    }
+
+    /**
+     * @brief Parses `address,length`
+     */
+    [[nodiscard]] std::optional<std::pair<std::uint32_t, std::uint32_t>> parse_range(std::string_view str) noexcept
+    {
+      const std::size_t comma = str.find(',');
+
+      if (comma == std::string_view::npos)
+        return {};
+
+      const auto address = parse_number<std::uint32_t>(str.substr(0, comma));
+      const auto length = parse_number<std::uint32_t>(str.substr(comma + 1));
+
+      if (!address || !length)
+        return {};
+
+      return std::pair{*address, *length};
+    }
+
+  } // namespace
+
+  void gdb_stub::serve(arch::execution_mode mode)
+  {
+    while (const std::optional<std::string> packet = receive())
+    {
+      if (*packet == "D"sv)
+      {
+        send("OK"sv);
+
+        return;
+      }
+
+      const std::optional<std::string> reply = handle(*packet, mode);
+
+      if (!reply)
+        return;
+
+      send(*reply);
+    }
+  }
+
+  std::optional<std::string> gdb_stub::receive()
+  {
+    for (;;)
+    {
+      int c = in_.get();
+
+      if (c == std::istream::traits_type::eof())
+        return {};
+
+      if (c == '-')
+      {
+        out_ << last_packet_ << std::flush;
+        continue;
+      }
+
+      // Acknowledgments and interrupts outside of packets are ignored
+      if (c != '$')
+        continue;
+
+      std::string data;
+      unsigned int sum = 0;
+
+      while (((c = in_.get()) != std::istream::traits_type::eof()) && (c != '#'))
+      {
+        data.push_back(static_cast<char>(c));
+        sum += static_cast<unsigned char>(c);
+      }
+
+      char checksum[2];
+
+      if ((c == std::istream::traits_type::eof()) || !in_.read(checksum, 2))
+        return {};
+
+      if (parse_byte(std::string_view{checksum, 2}) != static_cast<std::uint8_t>(sum & 0xff))
+      {
+        if (ack_)
+          out_ << '-' << std::flush;
+
+        continue;
+      }
+
+      if (ack_)
+        out_ << '+' << std::flush;
+
+      std::string packet;
+      packet.reserve(data.size());
+
+      for (std::size_t i = 0; i < data.size(); ++i)
+      {
+        if ((data[i] == '}') && (i + 1 < data.size()))
+          packet.push_back(static_cast<char>(data[++i] ^ 0x20));
+        else
+          packet.push_back(data[i]);
+      }
+
+      return packet;
+    }
+  }
+
+  void gdb_stub::send(std::string_view data)
+  {
+    unsigned int sum = 0;
+
+    last_packet_.assign(1, '$');
+
+    for (const char c : data)
+    {
+      if (escaped(c))
+      {
+        last_packet_.push_back('}');
+        sum += static_cast<unsigned char>('}');
+      }
+
+      const char ch = escaped(c) ? static_cast<char>(c ^ 0x20) : c;
+
+      last_packet_.push_back(ch);
+      sum += static_cast<unsigned char>(ch);
+    }
+
+    last_packet_.push_back('#');
+    append_byte(last_packet_, static_cast<std::uint8_t>(sum & 0xff));
+
+    out_ << last_packet_ << std::flush;
+  }
+
+  std::optional<std::string> gdb_stub::handle(std::string_view packet, arch::execution_mode mode)
+  {
+    if (packet.empty())
+      return std::string{};
+
+    const std::string_view args = packet.substr(1);
+
+    switch (packet[0])
+    {
+    case '?':
+      return last_stop_;
+    case 'g':
+      return read_registers();
+    case 'G':
+      return write_registers(args);
+    case 'p':
+      return read_register(args);
+    case 'P':
+      return write_register(args);
+    case 'm':
+      return read_memory(args);
+    case 'M':
+      return write_memory(args, false);
+    case 'X':
+      return write_memory(args, true);
+    case 'c':
+    case 's':
+    {
+      if (!args.empty())
+      {
+        const auto address = parse_number<arch::word_t>(args);
+
+        if (!address)
+          return std::string{"E01"};
+
+        arch::machine_registers reg = machine_.state().reg;
+        reg.named.r[7] = *address;
+
+        machine_.set_registers(reg);
+      }
+
+      return resume((packet[0] == 's') ? std::optional<std::uint64_t>{1} : std::nullopt, mode);
+    }
+    case 'Z':
+      return set_breakpoint(args, true);
+    case 'z':
+      return set_breakpoint(args, false);
+    case 'H':
+      return std::string{"OK"};
+    case 'k':
+      return {};
+    case 'q':
+      return query(packet);
+    case 'Q':
+      if (packet == "QStartNoAckMode"sv)
+      {
+        // The acknowledgment of this packet has already been sent
+        ack_ = false;
+
+        return std::string{"OK"};
+      }
+
+      return std::string{};
+    default:
+      // Unsupported packets are answered with an empty reply
+      return std::string{};
+    }
+  }
+
+  std::string gdb_stub::read_registers() const
+  {
+    const arch::machine_registers& reg = machine_.state().reg;
+
+    std::string result;
+    result.reserve(4 * num_registers);
+
+    for (const arch::word_t value : reg.named.r)
+      append_word(result, value);
+
+    append_word(result, reg.status.s);
+
+    return result;
+  }
+
+  std::string gdb_stub::write_registers(std::string_view args)
+  {
+    if (args.size() != 4 * num_registers)
+      return "E01";
+
+    arch::machine_registers reg = machine_.state().reg;
+
+    for (std::size_t i = 0; i < num_registers; ++i)
+    {
+      const auto value = parse_word(args.substr(4 * i, 4));
+
+      if (!value)
+        return "E01";
+
+      if (i < reg.named.r.size())
+        reg.named.r[i] = *value;
+      else
+        reg.status.s = *value;
+    }
+
+    machine_.set_registers(reg);
+
+    return "OK";
+  }
+
+  std::string gdb_stub::read_register(std::string_view args) const
+  {
+    const auto index = parse_number<std::size_t>(args);
+
+    if (!index || (*index >= num_registers))
+      return "E01";
+
+    const arch::machine_registers& reg = machine_.state().reg;
+
+    std::string result;
+    append_word(result, (*index < reg.named.r.size()) ? reg.named.r[*index] : reg.status.s);
+
+    return result;
+  }
+
+  std::string gdb_stub::write_register(std::string_view args)
+  {
+    const std::size_t equal = args.find('=');
+
+    if (equal == std::string_view::npos)
+      return "E01";
+
+    const auto index = parse_number<std::size_t>(args.substr(0, equal));
+    const auto value = parse_word(args.substr(equal + 1));
+
+    if (!index || !value || (*index >= num_registers))
+      return "E01";
+
+    arch::machine_registers reg = machine_.state().reg;
+
+    if (*index < reg.named.r.size())
+      reg.named.r[*index] = *value;
+    else
+      reg.status.s = *value;
+
+    machine_.set_registers(reg);
+
+    return "OK";
+  }
+
+  std::string gdb_stub::read_memory(std::string_view args) const
+  {
+    const auto range = parse_range(args);
+
+    // Reading through the constant memory keeps the decoded and translated code
+    const arch::memory& mem = std::as_const(machine_).main_memory();
+
+    if (!range || (range->first >= mem.size()))
+      return "E01";
+
+    // Reads beyond the end of main memory return the bytes up to it
+    const std::size_t length = std::min<std::size_t>(range->second, mem.size() - range->first);
+
+    std::string result;
+    result.reserve(2 * length);
+
+    for (std::size_t i = 0; i < length; ++i)
+      append_byte(result, static_cast<std::uint8_t>(mem.data()[range->first + i]));
+
+    return result;
+  }
+
+  std::string gdb_stub::write_memory(std::string_view args, bool binary)
+  {
+    const std::size_t colon = args.find(':');
+
+    if (colon == std::string_view::npos)
+      return "E01";
+
+    const auto range = parse_range(args.substr(0, colon));
+    const std::string_view data = args.substr(colon + 1);
+
+    if (!range || (data.size() != (binary ? 1 : 2) * std::size_t{range->second}) ||
+        (std::size_t{range->first} + range->second > std::as_const(machine_).main_memory().size()))
+      return "E01";
+
+    std::string bytes;
+
+    if (binary)
+    {
+      bytes = data;
+    }
+    else
+    {
+      for (std::size_t i = 0; i < data.size(); i += 2)
+      {
+        const auto value = parse_byte(data.substr(i, 2));
+
+        if (!value)
+          return "E01";
+
+        bytes.push_back(static_cast<char>(*value));
+      }
+    }
+
+    // Writing through the mutable memory invalidates the decoded instructions
+    if (!bytes.empty())
+      std::copy_n(
+        reinterpret_cast<const arch::memory::value_type*>(bytes.data()),
+        bytes.size(),
+        machine_.main_memory().data() + range->first);
+
+    return "OK";
+  }
+
+  std::string gdb_stub::set_breakpoint(std::string_view args, bool insert)
+  {
+    const std::size_t comma = args.find(',');
+
+    if (comma != 1)
+      return "E01";
+
+    const auto range = parse_range(args.substr(2));
+
+    if (!range || (range->first > 0xffff))
+      return "E01";
+
+    const auto address = static_cast<arch::address_t>(range->first);
+
+    try
+    {
+      switch (args[0])
+      {
+      case '0':
+      case '1':
+        if (insert)
+          debugger_.add_breakpoint(address);
+        else
+          debugger_.remove_breakpoint(address);
+
+        return "OK";
+      case '2':
+      case '3':
+      case '4':
+      {
+        constexpr arch::watch_access access[]{
+          arch::watch_access::write, arch::watch_access::read, arch::watch_access::read_write};
+
+        const arch::watchpoint watch{address, range->second, access[args[0] - '2']};
+
+        if (insert)
+          debugger_.add_watchpoint(watch);
+        else
+          debugger_.remove_watchpoint(watch);
+
+        return "OK";
+      }
+      default:
+        return "";
+      }
+    }
+    catch (const std::invalid_argument&)
+    {
+      return "E01";
+    }
+  }
+
+  std::string gdb_stub::query(std::string_view packet) const
+  {
+    constexpr auto features = "qXfer:features:read:target.xml:"sv;
+
+    if (packet.starts_with("qSupported"sv))
+      return "PacketSize=4000;QStartNoAckMode+;qXfer:features:read+";
+    if (packet == "qAttached"sv)
+      return "1";
+    if (packet == "qC"sv)
+      return "QC1";
+    if (packet == "qfThreadInfo"sv)
+      return "m1";
+    if (packet == "qsThreadInfo"sv)
+      return "l";
+    if (packet == "qOffsets"sv)
+      return "Text=0;Data=0;Bss=0";
+
+    if (packet.starts_with(features))
+    {
+      const auto range = parse_range(packet.substr(features.size()));
+
+      if (!range)
+        return "E01";
+
+      if (range->first >= target_description.size())
+        return "l";
+
+      const std::string_view chunk = target_description.substr(range->first, range->second);
+      const bool last = (range->first + chunk.size() == target_description.size());
+
+      std::string reply{last ? "l" : "m"};
+      reply += chunk;
+
+      return reply;
+    }
+
+    return "";
+  }
+
+  std::string gdb_stub::resume(std::optional<std::uint64_t> steps, arch::execution_mode mode)
+  {
+    // Once the machine has halted it is reported as exited
+    if (exited_)
+      return "W00";
+
+    const bool halted = steps ? machine_.execute(*steps, mode).first : machine_.execute(mode);
+
+    std::string reply;
+
+    if (debugger_.panic())
+    {
+      // The frontend shows the message as console output of the program
+      std::string output{"O"};
+      output += encode(debugger_.message());
+      output += encode("\n"sv);
+
+      send(output);
+
+      debugger_.reset_panic();
+      debugger_.reset_message();
+
+      reply = "S04";
+    }
+    else if (halted)
+    {
+      exited_ = true;
+      reply = "W00";
+    }
+    else if (const std::optional<arch::watchpoint_hit>& hit = debugger_.hit())
+    {
+      constexpr std::string_view kinds[]{"", "rwatch", "watch", "awatch"};
+
+      reply = "T05" + std::string{kinds[static_cast<std::size_t>(hit->watch.access)]} + ':';
+      append_byte(reply, static_cast<std::uint8_t>(hit->address >> 8));
+      append_byte(reply, static_cast<std::uint8_t>(hit->address & 0xff));
+      reply += ';';
+    }
+    else
+    {
+      reply = "S05";
+    }
+
+    last_stop_ = reply;
+
+    return reply;
+  }
+
+} // namespace yarisc::emu
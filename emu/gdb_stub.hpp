@@ -0,0 +1,104 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_EMU_GDB_STUB_HPP
+#define YARISC_EMU_GDB_STUB_HPP
+
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace yarisc::emu
+{
+  /**
+   * @brief Stub of the GDB remote serial protocol, which lets a debugger frontend control a machine
+   *
+   * The registers are `r0` to `r5`, `sp`, `ip`, and `status` in this order, each 16 bits in little endian byte order.
+   * Software and hardware breakpoints are both breakpoints of the debugger, which must be word-aligned. Watchpoints are
+   * watchpoints of the debugger and stop before the access. The execution cannot be interrupted by the frontend.
+   */
+  class gdb_stub final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param m machine, which must execute with the debugger
+     * @param dbg debugger of the machine
+     * @param in stream of the packets from the frontend
+     * @param out stream of the packets to the frontend
+     */
+    gdb_stub(arch::machine& m, arch::debugger& dbg, std::istream& in, std::ostream& out) noexcept
+      : machine_{m}
+      , debugger_{dbg}
+      , in_{in}
+      , out_{out}
+    {
+    }
+
+    gdb_stub(const gdb_stub& that) = delete;
+    gdb_stub(gdb_stub&& that) = delete;
+
+    ~gdb_stub() = default;
+
+    gdb_stub& operator=(const gdb_stub& that) = delete;
+    gdb_stub& operator=(gdb_stub&& that) = delete;
+
+    /**
+     * @brief Serves packets until the frontend detaches or kills the program, or the input ends
+     *
+     * @param mode execution mode normal or strict
+     */
+    void serve(arch::execution_mode mode);
+
+  private:
+    arch::machine& machine_;
+    arch::debugger& debugger_;
+
+    std::istream& in_;
+    std::ostream& out_;
+
+    bool ack_{true};
+    bool exited_{false};
+
+    std::string last_packet_{};
+    std::string last_stop_{"S05"};
+
+    [[nodiscard]] std::optional<std::string> receive();
+
+    void send(std::string_view data);
+
+    /**
+     * @brief Handles a packet
+     *
+     * @return the reply or nothing if the session ends
+     */
+    [[nodiscard]] std::optional<std::string> handle(std::string_view packet, arch::execution_mode mode);
+
+    [[nodiscard]] std::string read_registers() const;
+    [[nodiscard]] std::string write_registers(std::string_view args);
+    [[nodiscard]] std::string read_register(std::string_view args) const;
+    [[nodiscard]] std::string write_register(std::string_view args);
+    [[nodiscard]] std::string read_memory(std::string_view args) const;
+    [[nodiscard]] std::string write_memory(std::string_view args, bool binary);
+    [[nodiscard]] std::string set_breakpoint(std::string_view args, bool insert);
+    [[nodiscard]] std::string query(std::string_view packet) const;
+
+    /**
+     * @brief Executes and returns the stop reply
+     *
+     * @param steps number of steps or nothing to continue until the machine stops
+     */
+    [[nodiscard]] std::string resume(std::optional<std::uint64_t> steps, arch::execution_mode mode);
+  };
+
+} // namespace yarisc::emu
+
+#endif
@@ -5,19 +5,285 @@
 
 #include <emu/emulator.hpp>
 
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/monitor.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 
-int main(int argc, char* argv[])
+namespace
 {
+  using namespace std::string_view_literals;
   using namespace yarisc::arch;
   using namespace yarisc::emu;
 
+  constexpr std::string_view usage = R"(Usage: yarisc-emu [options] [image]
+
+Executes the image with the interactive viewer unless it runs unattended.
+
+Options:
+  -h, --help                   show this help
+  -u, --unattended             execute without viewer and write a report in JSON
+  --gdb                        serve the GDB remote serial protocol on standard input and output
+  --level <min|v1>             feature level of the machine (default v1)
+  --mode <normal|strict>       execution mode (default strict)
+  --engine <name>              interpreter, predecoded, threaded, block, or jit (default jit)
+  --steps <n>                  maximum number of steps of an unattended run
+  --report <path>              write the report to a file instead of standard output
+  --trace <n>                  write the last n instructions to standard error on a panic
+  --profile                    write a profile of the hot blocks to standard error after an unattended run
+  --stats                      write the opcode statistics to standard error after an unattended run
+  --cycles                     write the estimated cycles to standard error after an unattended run
+  --coverage <path>            write the code coverage to a file after an unattended run
+  --coverage-format <lcov|csv> file format of the code coverage (default lcov)
+)";
+
+  /**
+   * @brief Options of the command line
+   */
+  struct options final
+  {
+    std::filesystem::path image{};
+    emulator_mode mode{emulator_mode::interactive};
+    feature_level level{emulator::default_level};
+    execution_mode exec_mode{execution_mode::strict};
+    std::optional<execution_engine> engine{};
+    std::uint64_t steps{std::numeric_limits<std::uint64_t>::max()};
+    std::filesystem::path report{};
+    std::optional<std::size_t> trace{};
+    bool profile{false};
+    bool statistics{false};
+    bool cycles{false};
+    std::filesystem::path coverage{};
+    coverage_format cov_format{coverage_format::lcov};
+    bool help{false};
+  };
+
+  [[nodiscard]] std::uint64_t parse_number(std::string_view option, std::string_view str)
+  {
+    std::uint64_t value = 0;
+    const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    if (str.empty() || (ec != std::errc{}) || (ptr != str.data() + str.size()))
+      throw std::invalid_argument{"Invalid number " + std::string{str} + " for " + std::string{option}};
+
+    return value;
+  }
+
+  [[nodiscard]] options parse_options(int argc, char* argv[])
+  {
+    options opts;
+
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string_view arg{argv[i]};
+
+      const auto value = [&]() {
+        if (i + 1 >= argc)
+          throw std::invalid_argument{"Missing value for " + std::string{arg}};
+
+        return std::string_view{argv[++i]};
+      };
+
+      if ((arg == "-h"sv) || (arg == "--help"sv))
+      {
+        opts.help = true;
+      }
+      else if ((arg == "-u"sv) || (arg == "--unattended"sv))
+      {
+        opts.mode = emulator_mode::unattended;
+      }
+      else if (arg == "--gdb"sv)
+      {
+        opts.mode = emulator_mode::remote;
+      }
+      else if (arg == "--level"sv)
+      {
+        const std::string_view level = value();
+
+        if (level == "min"sv)
+          opts.level = feature_level::min;
+        else if (level == "v1"sv)
+          opts.level = feature_level::v1;
+        else
+          throw std::invalid_argument{"Invalid feature level " + std::string{level}};
+      }
+      else if (arg == "--mode"sv)
+      {
+        const std::string_view mode = value();
+
+        if (mode == "normal"sv)
+          opts.exec_mode = execution_mode::normal;
+        else if (mode == "strict"sv)
+          opts.exec_mode = execution_mode::strict;
+        else
+          throw std::invalid_argument{"Invalid execution mode " + std::string{mode}};
+      }
+      else if (arg == "--engine"sv)
+      {
+        const std::string_view engine = value();
+
+        if (engine == "interpreter"sv)
+          opts.engine = execution_engine::interpreter;
+        else if (engine == "predecoded"sv)
+          opts.engine = execution_engine::predecoded;
+        else if (engine == "threaded"sv)
+          opts.engine = execution_engine::threaded;
+        else if (engine == "block"sv)
+          opts.engine = execution_engine::block;
+        else if (engine == "jit"sv)
+          opts.engine = execution_engine::jit;
+        else
+          throw std::invalid_argument{"Invalid execution engine " + std::string{engine}};
+      }
+      else if (arg == "--steps"sv)
+      {
+        opts.steps = parse_number(arg, value());
+      }
+      else if (arg == "--report"sv)
+      {
+        opts.report = value();
+      }
+      else if (arg == "--trace"sv)
+      {
+        opts.trace = static_cast<std::size_t>(parse_number(arg, value()));
+      }
+      else if (arg == "--profile"sv)
+      {
+        opts.profile = true;
+      }
+      else if (arg == "--stats"sv)
+      {
+        opts.statistics = true;
+      }
+      else if (arg == "--cycles"sv)
+      {
+        opts.cycles = true;
+      }
+      else if (arg == "--coverage"sv)
+      {
+        opts.coverage = value();
+      }
+      else if (arg == "--coverage-format"sv)
+      {
+        const std::string_view format = value();
+
+        if (format == "lcov"sv)
+          opts.cov_format = coverage_format::lcov;
+        else if (format == "csv"sv)
+          opts.cov_format = coverage_format::csv;
+        else
+          throw std::invalid_argument{"Invalid coverage format " + std::string{format}};
+      }
+      else if (arg.starts_with('-'))
+      {
+        throw std::invalid_argument{"Unknown option " + std::string{arg}};
+      }
+      else if (opts.image.empty())
+      {
+        opts.image = arg;
+      }
+      else
+      {
+        throw std::invalid_argument{"Only one image can be executed"};
+      }
+    }
+
+    return opts;
+  }
+
+  /**
+   * @brief Runs unattended and writes the report
+   *
+   * @return exit code, which is zero if the machine has halted
+   */
+  [[nodiscard]] int run(emulator& em, const options& opts)
+  {
+    const run_report report = em.run(opts.steps, opts.exec_mode);
+
+    if (opts.report.empty())
+    {
+      output_json(std::cout, report);
+      std::cout << std::flush;
+    }
+    else
+    {
+      std::ofstream fs{opts.report};
+
+      if (!fs.is_open())
+        throw std::runtime_error{"could not open report file"};
+
+      output_json(fs, report);
+
+      if (!fs.flush())
+        throw std::runtime_error{"could not write report file"};
+    }
+
+    return (report.reason == stop_reason::halt) ? 0 : 1;
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  options opts;
+
+  try
+  {
+    opts = parse_options(argc, argv);
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << ex.what() << "\n\n" << usage << std::flush;
+
+    return 2;
+  }
+
+  if (opts.help)
+  {
+    std::cout << usage << std::flush;
+
+    return 0;
+  }
+
   try
   {
-    emulator em{emulator::default_level, emulator_mode::interactive};
+    emulator em{opts.image, opts.level, opts.mode};
+
+    if (opts.engine)
+      em.set_engine(*opts.engine);
+
+    if (opts.trace)
+      em.enable_trace(*opts.trace);
+
+    if (opts.profile)
+      em.enable_profile();
+
+    if (opts.statistics)
+      em.enable_statistics();
+
+    if (opts.cycles)
+      em.enable_cycles();
+
+    if (!opts.coverage.empty())
+      em.enable_coverage(opts.coverage, opts.cov_format);
+
+    if (opts.mode == emulator_mode::unattended)
+      return run(em, opts);
 
-    if (!em.execute(execution_mode::strict))
+    if (!em.execute(opts.exec_mode))
     {
       std::cerr << "A breakpoint was hit" << std::endl;
 
@@ -0,0 +1,40 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <tests/aot_image.hpp>
+
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <ios>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+  using namespace yarisc::arch;
+
+  if (argc != 2)
+  {
+    std::cerr << "Usage: yarisc-aot-image <image>" << std::endl;
+
+    return 2;
+  }
+
+  const std::vector<word_t> words = yarisc::test::aot_test_image();
+
+  // Store the words through memory, so the image has the byte order of the machine
+  memory mem{words.size() * sizeof(word_t)};
+
+  for (std::size_t i = 0; i < words.size(); ++i)
+    mem.store(static_cast<address_t>(i * sizeof(word_t)), words[i]);
+
+  std::ofstream os{argv[1], std::ios::binary};
+  os.write(reinterpret_cast<const char*>(mem.data()), static_cast<std::streamsize>(mem.size()));
+
+  return os ? 0 : 1;
+}
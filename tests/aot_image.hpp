@@ -0,0 +1,65 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_TESTS_AOT_IMAGE_HPP
+#define YARISC_TESTS_AOT_IMAGE_HPP
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <vector>
+
+namespace yarisc::test
+{
+  /**
+   * @brief Image which is translated by `yarisc-aot` at build time for the tests of the ahead of time translation
+   *
+   * It sums up a count-down loop which stores to data, calls a subroutine, loads, and adds with carry. Then it patches
+   * the subroutine and the word following the patching store before it halts. Every halt resumes with more code, and
+   * the last one restarts the image from the beginning.
+   */
+  [[nodiscard]] inline std::vector<arch::word_t> aot_test_image()
+  {
+    using namespace yarisc::arch;
+    using namespace yarisc::arch::assembly;
+
+    return {
+      assemble<opcode::move>(r1, immediate), // 0x0000
+      0x0100,
+      assemble<opcode::move>(r2, short_immediate{0x5}),
+      assemble<opcode::add>(r0, r0, r2), // 0x0006: loop
+      assemble<opcode::store>(r0, r1),
+      assemble<opcode::add>(r1, accumulator, short_immediate{0x2}),
+      assemble<opcode::add>(r2, accumulator, short_immediate{0xffff}),
+      assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+      assemble<opcode::move>(r5, immediate), // 0x0010
+      0x0016,
+      assemble<opcode::jump>(short_jump_address{0x003a}),
+      assemble<opcode::halt>(),
+      assemble<opcode::add>(r1, accumulator, short_immediate{0xfffe}), // 0x0018
+      assemble<opcode::load>(r3, r1),
+      assemble<opcode::add>(r4, r3, immediate),
+      0xfff5,
+      assemble<opcode::add_with_carry>(r4, accumulator, short_immediate{0x0}), // 0x0020
+      assemble<opcode::move>(r2, immediate),
+      0x003a,
+      assemble<opcode::move>(r3, immediate),
+      assemble<opcode::add>(r0, accumulator, short_immediate{0x2}),
+      assemble<opcode::store>(r3, r2), // 0x002a: patches the subroutine
+      assemble<opcode::move>(r2, immediate),
+      0x0036,
+      assemble<opcode::move>(r3, immediate), // 0x0030
+      assemble<opcode::halt>(),
+      assemble<opcode::store>(r3, r2),
+      assemble<opcode::noop>(), // 0x0036: patched to halt
+      assemble<opcode::jump>(short_jump_address{0x0000}),
+      assemble<opcode::add>(r0, accumulator, short_immediate{0x1}), // 0x003a: subroutine
+      assemble<opcode::move>(ip, r5),
+    };
+  }
+
+} // namespace yarisc::test
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <tests/aot_image.hpp>
+#include <yarisc/arch/aot.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Translation of `yarisc::test::aot_test_image()` generated by `yarisc-aot` at build time
+ */
+extern const yarisc::arch::aot_program aot_test_program;
+
+namespace
+{
+  using namespace yarisc::arch;
+
+  void load_image(memory& mem)
+  {
+    const std::vector<word_t> words = yarisc::test::aot_test_image();
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+      mem.store(static_cast<address_t>(i * sizeof(word_t)), words[i]);
+  }
+
+} // namespace
+
+SCENARIO("executing an image translated ahead of time", "[aot]")
+{
+  GIVEN("the translated test image")
+  {
+    REQUIRE(!aot_test_program.blocks.empty());
+    CHECK(aot_test_program.level == feature_level_latest);
+
+    aot_runtime runtime{aot_test_program};
+
+    WHEN("a given number of steps is executed")
+    {
+      THEN("the state is the same as with the interpreter")
+      {
+        for (std::uint64_t steps = 0; steps < 120; ++steps)
+        {
+          machine expected;
+          expected.set_engine(execution_engine::interpreter);
+          load_image(expected.main_memory());
+
+          detail::machine_data data;
+          load_image(data.mem.main);
+
+          runtime.reset();
+
+          CHECK(runtime.execute(data, steps) == expected.execute(steps));
+          CHECK(data.state.reg == expected.state().reg);
+          CHECK(data.mem.main == std::as_const(expected).main_memory());
+        }
+      }
+    }
+
+    WHEN("it is executed until it halts several times")
+    {
+      machine expected;
+      expected.set_engine(execution_engine::interpreter);
+      load_image(expected.main_memory());
+
+      detail::machine_data data;
+      load_image(data.mem.main);
+
+      THEN("every halt is at the same state as with the interpreter")
+      {
+        for (int i = 0; i < 8; ++i)
+        {
+          const auto [halted, steps] = runtime.execute(data);
+
+          CHECK(halted);
+          CHECK(steps == expected.execute(1000).second);
+          CHECK(data.state.reg == expected.state().reg);
+          CHECK(data.mem.main == std::as_const(expected).main_memory());
+        }
+      }
+    }
+  }
+}
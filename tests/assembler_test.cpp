@@ -0,0 +1,227 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/assembler.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/detail/endianness.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  [[nodiscard]] std::vector<word_t> words_of(const std::vector<std::byte>& image)
+  {
+    std::vector<word_t> words(image.size() / sizeof(word_t));
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+      words[i] = detail::load_word(image.data() + i * sizeof(word_t));
+
+    return words;
+  }
+
+  [[nodiscard]] std::vector<word_t> assemble_words(std::string_view source, feature_level level = feature_level_latest)
+  {
+    assembler_options options;
+    options.level = level;
+
+    return words_of(assemble_source(source, options));
+  }
+
+} // namespace
+
+SCENARIO("assemble instructions", "[assembler]")
+{
+  GIVEN("the text of every instruction format")
+  {
+    struct instruction_text final
+    {
+      std::string_view text;
+      std::vector<word_t> words;
+    };
+
+    const std::initializer_list<instruction_text> instructions{
+      {"MOV r2, r3", {assemble<opcode::move>(r2, r3)}},
+      {"MOV r4, 7", {assemble<opcode::move>(r4, short_immediate{0x7})}},
+      {"MOV r4, -8", {assemble<opcode::move>(r4, short_immediate{0xfff8})}},
+      {"MOV r0, 0xabcd", {assemble<opcode::move>(r0, immediate), 0xabcd}},
+      {"LDR r2, r1", {assemble<opcode::load>(r2, r1)}},
+      {"LDR r4, 0x20", {assemble<opcode::load>(r4, immediate), 0x0020}},
+      {"STR r3, sp", {assemble<opcode::store>(r3, sp)}},
+      {"ADD r0, r1, r2", {assemble<opcode::add>(r0, r1, r2)}},
+      {"ADD r2, 0xf555, r4", {assemble<opcode::add>(r2, immediate, r4), 0xf555}},
+      {"ADD r3, r0, 0x0203", {assemble<opcode::add>(r3, r0, immediate), 0x0203}},
+      {"ADD r4, r4, 5", {assemble<opcode::add>(r4, accumulator, short_immediate{0x5})}},
+      {"ADD r5, 6, r5", {assemble<opcode::add>(r5, short_immediate{0x6}, accumulator)}},
+      {"ADD r1, r2, 5", {assemble<opcode::add>(r1, r2, immediate), 0x0005}},
+      {"ADC r1, r1, r1", {assemble<opcode::add_with_carry>(r1, r1, r1)}},
+      {"JMP 0x01fc", {assemble<opcode::jump>(short_jump_address{0x01fc})}},
+      {"JMP 0x6124", {assemble<opcode::jump>(immediate), 0x6124}},
+      {"JMC 0x001a", {assemble<opcode::cond_jump>(jc, short_cond_jump_address{0x001a})}},
+      {"JNZ 0xffe0", {assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0xffe0})}},
+      {"JNC 0x1ff0", {assemble<opcode::cond_jump>(jnc, immediate), 0x1ff0}},
+      {"JMZ 0x1234", {assemble<opcode::cond_jump>(jz, immediate), 0x1234}},
+      {"NOP", {assemble<opcode::noop>()}},
+      {"HLT", {assemble<opcode::halt>()}},
+    };
+
+    THEN("each instruction shall be assembled to the shortest encoding")
+    {
+      for (const instruction_text& instr : instructions)
+      {
+        INFO(instr.text);
+        CHECK(assemble_words(instr.text) == instr.words);
+      }
+    }
+
+    THEN("the text of the disassembly shall be equal to the source")
+    {
+      for (const instruction_text& instr : instructions)
+      {
+        // The disassembly prints small values in decimal and short negative values as words
+        if ((instr.text == "MOV r4, -8") || (instr.text == "ADD r1, r2, 5"))
+          continue;
+
+        const word_t arg = (instr.words.size() > 1) ? instr.words[1] : word_t{0};
+        const disassembly dis = disassemble(instr.words[0], arg);
+
+        CHECK(dis.text == instr.text);
+        CHECK(dis.words == static_cast<int>(instr.words.size()));
+      }
+    }
+
+    THEN("mnemonics and registers shall be case-insensitive")
+    {
+      CHECK(assemble_words("mov R2, r3\njnz 0xffe0\nhlt") ==
+            std::vector<word_t>{
+              assemble<opcode::move>(r2, r3),
+              assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0xffe0}),
+              assemble<opcode::halt>(),
+            });
+    }
+  }
+}
+
+SCENARIO("assemble labels, constants, and data", "[assembler]")
+{
+  GIVEN("a source with a backward and a forward reference to labels")
+  {
+    constexpr std::string_view source = R"(
+; count down
+count = 3
+start:  MOV r0, count         ; 0x0000
+loop:   ADD r0, r0, -1        ; 0x0002
+        JNZ loop              ; 0x0004
+        JMP done              ; 0x0006
+        NOP                   ; 0x000a
+done:   HLT                   ; 0x000c
+table:  .word count, done - start + 2, -1
+        .zero 4
+end:
+)";
+
+    THEN("known values shall be short and forward references shall take an additional word")
+    {
+      CHECK(assemble_words(source) ==
+            std::vector<word_t>{
+              assemble<opcode::move>(r0, short_immediate{0x3}),
+              assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+              assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0002}),
+              assemble<opcode::jump>(immediate),
+              0x000c,
+              assemble<opcode::noop>(),
+              assemble<opcode::halt>(),
+              0x0003,
+              0x000e,
+              0xffff,
+              0x0000,
+              0x0000,
+            });
+    }
+
+    THEN("the assembled program shall count down and halt")
+    {
+      const std::vector<std::byte> image = assemble_source(source);
+
+      machine m;
+      std::memcpy(m.main_memory().data(), image.data(), image.size());
+
+      CHECK(m.execute(execution_mode::strict));
+      CHECK(m.state().reg.named.r[0] == 0x0000);
+      CHECK(m.state().reg.named.ip() == 0x000e);
+    }
+  }
+
+  GIVEN("a large generated source")
+  {
+    std::string source;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      source += 'l';
+      source += std::to_string(i);
+      source += ": ADD r0, r0, 1\n        JMP l";
+      source += std::to_string((i + 1) % 1000);
+      source += '\n';
+    }
+
+    THEN("every forward reference shall be resolved")
+    {
+      const std::vector<word_t> words = assemble_words(source);
+
+      REQUIRE(words.size() == 999 * 3 + 2);
+      CHECK(words[1] == assemble<opcode::jump>(immediate));
+      CHECK(words[2] == 0x0006);
+      CHECK(words[words.size() - 1] == assemble<opcode::jump>(short_jump_address{0x0000}));
+    }
+  }
+}
+
+SCENARIO("report errors of the source", "[assembler]")
+{
+  GIVEN("invalid sources")
+  {
+    THEN("the error shall name the line and column")
+    {
+      CHECK_THROWS_WITH(assemble_source("NOP\n  FOO r0"), "<source>:2:3: unknown instruction 'FOO'");
+      CHECK_THROWS_WITH(assemble_source("JMP nowhere"), "<source>:1:5: undefined symbol 'nowhere'");
+      CHECK_THROWS_WITH(
+        assemble_source("ADD r0, 1, 2"), "<source>:1:12: only one operand can be an immediate constant");
+      CHECK_THROWS_WITH(assemble_source("a: NOP\na: HLT"), "<source>:2:1: symbol 'a' is already defined");
+      CHECK_THROWS_WITH(assemble_source("MOV r0, 0x10000"), "<source>:1:9: number exceeds a word");
+      CHECK_THROWS_WITH(assemble_source("MOV r0 r1"), "<source>:1:8: expected ',' instead of 'r1'");
+      CHECK_THROWS_WITH(assemble_source("HLT r0"), "<source>:1:5: unexpected 'r0'");
+    }
+
+    THEN("other errors shall be reported too")
+    {
+      CHECK_THROWS_AS(assemble_source("MOV 1, r0"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source("sp = 2"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source("a = b\nb = 1"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source(".zero 3"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source(".byte 3"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source("JMCC 0"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source("MOV r0, $"), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_source(".zero 0xfffe\n.word 1, 2"), std::invalid_argument);
+    }
+
+    THEN("instructions of a later feature level shall be rejected")
+    {
+      CHECK_NOTHROW(assemble_words("JMZ 0\nHLT", feature_level::min));
+      CHECK_THROWS_AS(assemble_words("JMP 0", feature_level::min), std::invalid_argument);
+      CHECK_THROWS_AS(assemble_words("NOP", feature_level::min), std::invalid_argument);
+    }
+  }
+}
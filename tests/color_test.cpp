@@ -0,0 +1,88 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/output.hpp>
+#include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+SCENARIO("color contexts only output sequences that change the colors", "[color]")
+{
+  using namespace yarisc::utils;
+
+  GIVEN("a colored context")
+  {
+    color::colored_context ctx;
+
+    std::string str;
+    text_buffer buf{str};
+
+    THEN("a repeated color shall be output once")
+    {
+      buf << color::white(ctx) << 'a' << color::white(ctx) << 'b' << color::reset(ctx);
+
+      CHECK(str == "\033[37mab\033[0m");
+    }
+
+    THEN("the foreground and the background color shall be tracked separately")
+    {
+      buf << color::manip(ctx, color::yellow_background_seq) << color::white(ctx) << 'a';
+      buf << color::manip(ctx, color::yellow_background_seq) << color::red(ctx) << 'b' << color::reset(ctx);
+
+      CHECK(str == "\033[43m\033[37ma\033[31mb\033[0m");
+    }
+
+    THEN("a color shall be output again after a reset")
+    {
+      buf << color::white(ctx) << 'a' << color::reset(ctx) << color::white(ctx) << 'b' << color::reset(ctx);
+
+      CHECK(str == "\033[37ma\033[0m\033[37mb\033[0m");
+    }
+
+    THEN("a reset without any color shall not be output")
+    {
+      buf << 'a' << color::reset(ctx);
+
+      CHECK(str == "a");
+      CHECK_FALSE(ctx.dirty());
+    }
+
+    THEN("an unknown sequence shall be output and any following color too")
+    {
+      buf << color::white(ctx) << color::manip(ctx, "\033[1m") << color::white(ctx) << 'a' << color::reset(ctx);
+
+      CHECK(str == "\033[37m\033[1m\033[37ma\033[0m");
+    }
+  }
+}
+
+SCENARIO("colored memory keeps the color between words", "[color]")
+{
+  using namespace yarisc::arch;
+
+  GIVEN("a memory view")
+  {
+    std::array<std::byte, 8> data{};
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<std::byte>(i + 0x41);
+
+    const memory_view mem{data.data(), data.size()};
+
+    THEN("the color shall only be reset before the characters")
+    {
+      std::string str;
+      output_to(str, mem, output_format::colored);
+
+      CHECK(str == "0x0000: \033[97m41 \033[37m42  \033[97m43 \033[37m44  "
+                   "\033[97m45 \033[37m46  \033[97m47 \033[37m48  \033[0mABCDEFGH\n");
+    }
+  }
+}
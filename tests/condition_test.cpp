@@ -0,0 +1,86 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/condition.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+
+#include <stdexcept>
+#include <string_view>
+
+SCENARIO("evaluate breakpoint conditions", "[condition]")
+{
+  using namespace yarisc::arch;
+
+  GIVEN("registers and memory")
+  {
+    machine_registers reg;
+    reg.named.set_r0(0x0003);
+    reg.named.set_r3(0x0010);
+    reg.named.set_sp(0xfffe);
+    reg.status.set_zero();
+
+    memory mem;
+    mem.store(0x8000, 0x1234);
+
+    const auto holds = [&reg, &mem](std::string_view source) { return breakpoint_condition{source}(reg, mem); };
+
+    THEN("registers, flags, and memory shall be read")
+    {
+      CHECK(holds("r3 == 0x10 && status.zero"));
+      CHECK(holds("r3 == 16"));
+      CHECK(holds("r6 == sp"));
+      CHECK(holds("status == 0x2"));
+      CHECK_FALSE(holds("status.carry"));
+      CHECK(holds("[0x8000] == 0x1234"));
+      CHECK(holds("[0x8001] == 0x1234"));
+      CHECK(holds("[r3 + 0x7ff0] == 0x1234"));
+      CHECK(holds("[0xfffe] == 0"));
+    }
+
+    THEN("the operators of C shall be evaluated with their precedences")
+    {
+      CHECK(holds("r0 + 1 == 4"));
+      CHECK(holds("r0 - 4 == 0xffff"));
+      CHECK(holds("-r0 == 0xfffd"));
+      CHECK(holds("~r0 == 0xfffc"));
+      CHECK(holds("!(r0 == 3) == 0"));
+      CHECK(holds("r0 & 1 == 1"));
+      CHECK(holds("(r0 & 2) == 2"));
+      CHECK(holds("r0 | 4 ^ 4"));
+      CHECK(holds("r0 < 4 && r0 <= 3 && r0 > 2 && r0 >= 3 && r0 != 2"));
+      CHECK(holds("0 || r0"));
+      CHECK_FALSE(holds("0 && r0"));
+      CHECK_FALSE(holds("0xffff < 1"));
+    }
+
+    THEN("changed shall compare the word with the previous evaluation")
+    {
+      breakpoint_condition changed{"changed([0x8000])"};
+
+      CHECK_FALSE(changed(reg, mem));
+      CHECK_FALSE(changed(reg, mem));
+
+      mem.store(0x8000, 0x4321);
+
+      CHECK(changed(reg, mem));
+      CHECK_FALSE(changed(reg, mem));
+      CHECK(changed.source() == "changed([0x8000])");
+    }
+  }
+
+  GIVEN("malformed conditions")
+  {
+    THEN("an exception shall be thrown")
+    {
+      for (const std::string_view source :
+           {"", "  ", "r8 == 0", "r0 ==", "(r0", "[r0", "0x10000", "0xg", "12ab", "r0 = 1", "changed(r0)", "r0 r1"})
+      {
+        CHECK_THROWS_AS(breakpoint_condition{source}, std::invalid_argument);
+      }
+    }
+  }
+}
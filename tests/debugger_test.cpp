@@ -0,0 +1,462 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  void store_program(memory& mem, address_t address, std::initializer_list<word_t> words)
+  {
+    for (const word_t word : words)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+} // namespace
+
+SCENARIO("manage the breakpoints of a debugger", "[debugger]")
+{
+  GIVEN("a debugger without breakpoints")
+  {
+    debugger dbg;
+
+    THEN("there shall be no breakpoint")
+    {
+      CHECK_FALSE(dbg.has_breakpoints());
+      CHECK_FALSE(dbg.breakpoint(0x0000));
+      CHECK_FALSE(dbg.breakpoint_in(0x0000, 0x10000));
+      CHECK(dbg.breakpoints().empty());
+    }
+
+    WHEN("breakpoints are added")
+    {
+      CHECK(dbg.add_breakpoint(0x0102));
+      CHECK(dbg.add_breakpoint(0xfffe));
+      CHECK(dbg.add_breakpoint(0x0000));
+      CHECK_FALSE(dbg.add_breakpoint(0x0102));
+
+      THEN("they shall be listed in ascending order")
+      {
+        CHECK(dbg.has_breakpoints());
+        CHECK(dbg.breakpoints() == std::vector<address_t>{0x0000, 0x0102, 0xfffe});
+      }
+
+      THEN("they shall be hit at their word addresses only")
+      {
+        CHECK(dbg.breakpoint(0x0102));
+        CHECK(dbg.breakpoint(0x0103));
+        CHECK_FALSE(dbg.breakpoint(0x0100));
+        CHECK_FALSE(dbg.breakpoint(0x0104));
+        CHECK(dbg.breakpoint(0xfffe));
+      }
+
+      THEN("the ranges containing them shall have a breakpoint")
+      {
+        CHECK(dbg.breakpoint_in(0x0102, 2));
+        CHECK(dbg.breakpoint_in(0x0100, 4));
+        CHECK(dbg.breakpoint_in(0x0080, 0x0100));
+        CHECK(dbg.breakpoint_in(0xfff0, 0x10));
+        CHECK(dbg.breakpoint_in(0xfffe, 4));
+        CHECK_FALSE(dbg.breakpoint_in(0x0100, 2));
+        CHECK_FALSE(dbg.breakpoint_in(0x0104, 0x1000));
+        CHECK_FALSE(dbg.breakpoint_in(0x0002, 0x0100));
+        CHECK_FALSE(dbg.breakpoint_in(0x0102, 0));
+      }
+
+      THEN("they shall be removed one by one")
+      {
+        CHECK(dbg.remove_breakpoint(0x0102));
+        CHECK_FALSE(dbg.remove_breakpoint(0x0102));
+        CHECK_FALSE(dbg.breakpoint(0x0102));
+        CHECK(dbg.breakpoints() == std::vector<address_t>{0x0000, 0xfffe});
+      }
+
+      THEN("they shall be removed all at once")
+      {
+        dbg.clear_breakpoints();
+
+        CHECK_FALSE(dbg.has_breakpoints());
+        CHECK(dbg.breakpoints().empty());
+      }
+    }
+
+    WHEN("a breakpoint is added at an unaligned address")
+    {
+      THEN("an exception shall be thrown")
+      {
+        CHECK_THROWS_AS(dbg.add_breakpoint(0x0101), std::invalid_argument);
+      }
+    }
+  }
+}
+
+SCENARIO("stop execution at breakpoints", "[debugger]")
+{
+  GIVEN("machines with a breakpoint in a loop for each engine and mode")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      for (const execution_mode mode : {execution_mode::normal, execution_mode::strict})
+      {
+        const auto dbg = std::make_shared<debugger>();
+
+        machine m{dbg};
+        m.set_engine(engine);
+
+        store_program(
+          m.main_memory(),
+          0x0000,
+          {
+            assemble<opcode::move>(r0, short_immediate{0x3}),
+            assemble<opcode::add>(r1, accumulator, short_immediate{0x1}), // 0x0002
+            assemble<opcode::add>(r2, accumulator, short_immediate{0x1}), // 0x0004: breakpoint
+            assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+            assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0002}),
+            assemble<opcode::halt>(),
+          });
+
+        dbg->add_breakpoint(0x0004);
+
+        const auto [first_halted, first_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(first_halted);
+        CHECK(first_steps == 2);
+        CHECK(m.state().reg.named.ip() == 0x0004);
+        CHECK(m.state().reg.named.r2() == 0x0000);
+
+        // Resuming steps over the breakpoint and stops at it in the next iteration
+        const auto [second_halted, second_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(second_halted);
+        CHECK(second_steps == 4);
+        CHECK(m.state().reg.named.ip() == 0x0004);
+        CHECK(m.state().reg.named.r2() == 0x0001);
+
+        CHECK_FALSE(m.execute(mode));
+        CHECK(m.state().reg.named.ip() == 0x0004);
+        CHECK(m.state().reg.named.r2() == 0x0002);
+
+        // A single step at the breakpoint executes its instruction
+        const auto [step_halted, step_steps] = m.execute(1, mode);
+
+        CHECK_FALSE(step_halted);
+        CHECK(step_steps == 1);
+        CHECK(m.state().reg.named.ip() == 0x0006);
+
+        dbg->remove_breakpoint(0x0004);
+
+        const auto [final_halted, final_steps] = m.execute(100, mode);
+
+        CHECK(final_halted);
+        CHECK(final_steps == 2);
+        CHECK(m.state().reg.named.r0() == 0x0000);
+        CHECK(m.state().reg.named.r1() == 0x0003);
+        CHECK(m.state().reg.named.r2() == 0x0003);
+        CHECK_FALSE(dbg->panic());
+      }
+    }
+  }
+
+  GIVEN("machines with a debugger without breakpoints for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m{std::make_shared<debugger>()};
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r0, immediate),
+          0x0100,
+          assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+          assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+          assemble<opcode::halt>(),
+        });
+
+      const auto [halted, steps] = m.execute(1000);
+
+      CHECK(halted);
+      CHECK(steps == 1 + 2 * 0x0100);
+      CHECK(m.state().reg.named.r0() == 0x0000);
+      CHECK(m.state().reg.named.ip() == 0x000a);
+    }
+  }
+}
+
+SCENARIO("manage the watchpoints of a debugger", "[debugger]")
+{
+  GIVEN("a debugger without watchpoints")
+  {
+    debugger dbg;
+
+    THEN("no access shall fire a watchpoint")
+    {
+      CHECK_FALSE(dbg.has_watchpoints());
+      CHECK_FALSE(dbg.watch_read(0x0000, 0x0000));
+      CHECK_FALSE(dbg.watch_write(0xfffe, 0x0000));
+      CHECK_FALSE(dbg.hit());
+    }
+
+    WHEN("watchpoints are added")
+    {
+      const watchpoint reads{0x0100, 0x0001, watch_access::read};
+      const watchpoint writes{0x0200, 0x0200, watch_access::write, 0x1234};
+      const watchpoint accesses{0xfff0, 0x0010, watch_access::read_write};
+
+      CHECK(dbg.add_watchpoint(reads));
+      CHECK(dbg.add_watchpoint(writes));
+      CHECK(dbg.add_watchpoint(accesses));
+      CHECK_FALSE(dbg.add_watchpoint(reads));
+
+      THEN("they shall be listed in the order they have been added")
+      {
+        CHECK(dbg.has_watchpoints());
+        CHECK(dbg.watchpoints() == std::vector<watchpoint>{reads, writes, accesses});
+      }
+
+      THEN("they shall fire on the accesses to a byte of their ranges only")
+      {
+        CHECK(dbg.watch_read(0x0100, 0x0000));
+        CHECK(dbg.watch_read(0x00ff, 0x0000));
+        CHECK_FALSE(dbg.watch_read(0x00fe, 0x0000));
+        CHECK_FALSE(dbg.watch_read(0x0102, 0x0000));
+        CHECK_FALSE(dbg.watch_write(0x0100, 0x0000));
+
+        CHECK(dbg.watch_read(0xfffe, 0x0000));
+        CHECK(dbg.watch_write(0xfff0, 0x0000));
+        CHECK_FALSE(dbg.watch_write(0xffee, 0x0000));
+      }
+
+      THEN("they shall fire on the watched values only")
+      {
+        CHECK(dbg.watch_write(0x0200, 0x1234));
+        CHECK(dbg.watch_write(0x03fe, 0x1234));
+        CHECK_FALSE(dbg.watch_write(0x0200, 0x1235));
+        CHECK_FALSE(dbg.watch_write(0x0400, 0x1234));
+        CHECK_FALSE(dbg.watch_read(0x0200, 0x1234));
+      }
+
+      THEN("the last hit shall be recorded")
+      {
+        CHECK(dbg.watch_write(0x0300, 0x1234));
+
+        REQUIRE(dbg.hit());
+        CHECK(dbg.hit()->watch == writes);
+        CHECK(dbg.hit()->address == 0x0300);
+        CHECK(dbg.hit()->value == 0x1234);
+        CHECK(dbg.hit()->access == watch_access::write);
+        CHECK_FALSE(dbg.message().empty());
+
+        dbg.reset_hit();
+
+        CHECK_FALSE(dbg.hit());
+      }
+
+      THEN("suspended watchpoints shall not fire")
+      {
+        dbg.suspend_watchpoints(true);
+
+        CHECK_FALSE(dbg.watch_read(0x0100, 0x0000));
+        CHECK(dbg.has_watchpoints());
+
+        dbg.suspend_watchpoints(false);
+
+        CHECK(dbg.watch_read(0x0100, 0x0000));
+      }
+
+      THEN("they shall be removed one by one")
+      {
+        CHECK(dbg.remove_watchpoint(reads));
+        CHECK_FALSE(dbg.remove_watchpoint(reads));
+        CHECK_FALSE(dbg.watch_read(0x0100, 0x0000));
+        CHECK(dbg.watchpoints() == std::vector<watchpoint>{writes, accesses});
+      }
+
+      THEN("they shall be removed all at once")
+      {
+        dbg.clear_watchpoints();
+
+        CHECK_FALSE(dbg.has_watchpoints());
+        CHECK_FALSE(dbg.watch_read(0xfffe, 0x0000));
+      }
+    }
+
+    WHEN("an invalid watchpoint is added")
+    {
+      THEN("an exception shall be thrown")
+      {
+        CHECK_THROWS_AS(dbg.add_watchpoint(watchpoint{0x0100, 0x0000}), std::invalid_argument);
+        CHECK_THROWS_AS(dbg.add_watchpoint(watchpoint{0xff00, 0x0101}), std::invalid_argument);
+        CHECK_THROWS_AS(
+          dbg.add_watchpoint(watchpoint{0x0100, 0x0002, static_cast<watch_access>(0x0)}), std::invalid_argument);
+      }
+    }
+  }
+}
+
+SCENARIO("stop execution at watchpoints", "[debugger]")
+{
+  GIVEN("machines with watchpoints on a loop for each engine and mode")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      for (const execution_mode mode : {execution_mode::normal, execution_mode::strict})
+      {
+        const auto dbg = std::make_shared<debugger>();
+
+        machine m{dbg};
+        m.set_engine(engine);
+
+        store_program(
+          m.main_memory(),
+          0x0000,
+          {
+            assemble<opcode::move>(r0, short_immediate{0x3}),
+            assemble<opcode::move>(r1, immediate), // 0x0002
+            0x0200,
+            assemble<opcode::store>(r0, r1),       // 0x0006: watched if it writes 0x0002
+            assemble<opcode::load>(r2, immediate), // 0x0008: watched
+            0x0300,
+            assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+            assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+            assemble<opcode::halt>(),
+          });
+
+        m.main_memory().store(0x0300, 0x1234);
+
+        const watchpoint reads{0x0300, 0x0001, watch_access::read};
+
+        dbg->add_watchpoint(reads);
+        dbg->add_watchpoint(watchpoint{0x0200, 0x0002, watch_access::write, 0x0002});
+
+        // The load stops before it is executed
+        const auto [first_halted, first_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(first_halted);
+        CHECK(first_steps == 3);
+        CHECK(m.state().reg.named.ip() == 0x0008);
+        CHECK(m.state().reg.named.r2() == 0x0000);
+        REQUIRE(dbg->hit());
+        CHECK(dbg->hit()->access == watch_access::read);
+        CHECK(dbg->hit()->address == 0x0300);
+        CHECK(dbg->hit()->value == 0x1234);
+
+        // Resuming executes the load and stops at the store of the watched value
+        const auto [second_halted, second_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(second_halted);
+        CHECK(second_steps == 3);
+        CHECK(m.state().reg.named.ip() == 0x0006);
+        CHECK(m.state().reg.named.r2() == 0x1234);
+        CHECK(m.main_memory().load(0x0200) == 0x0003);
+        REQUIRE(dbg->hit());
+        CHECK(dbg->hit()->access == watch_access::write);
+        CHECK(dbg->hit()->value == 0x0002);
+
+        dbg->remove_watchpoint(reads);
+
+        const auto [final_halted, final_steps] = m.execute(100, mode);
+
+        CHECK(final_halted);
+        CHECK(final_steps == 8);
+        CHECK_FALSE(dbg->hit());
+        CHECK(m.main_memory().load(0x0200) == 0x0001);
+        CHECK(m.state().reg.named.r0() == 0x0000);
+        CHECK_FALSE(dbg->panic());
+      }
+    }
+  }
+}
+
+SCENARIO("stop execution at conditional breakpoints", "[debugger]")
+{
+  GIVEN("machines with a conditional breakpoint in a loop for each engine and mode")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      for (const execution_mode mode : {execution_mode::normal, execution_mode::strict})
+      {
+        const auto dbg = std::make_shared<debugger>();
+
+        machine m{dbg};
+        m.set_engine(engine);
+
+        store_program(
+          m.main_memory(),
+          0x0000,
+          {
+            assemble<opcode::move>(r0, short_immediate{0x5}),
+            assemble<opcode::add>(r1, accumulator, short_immediate{0x1}),      // 0x0002
+            assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),   // 0x0004
+            assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0002}), // 0x0006: breakpoint
+            assemble<opcode::halt>(),
+          });
+
+        // The zero flag is evaluated lazily by the decoded engines
+        dbg->add_breakpoint(0x0006, breakpoint_condition{"r0 == 2 || status.zero"});
+
+        const auto [first_halted, first_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(first_halted);
+        CHECK(first_steps == 1 + 3 + 3 + 2);
+        CHECK(m.state().reg.named.ip() == 0x0006);
+        CHECK(m.state().reg.named.r0() == 0x0002);
+
+        // Resuming keeps the condition
+        const auto [second_halted, second_steps] = m.execute(100, mode);
+
+        CHECK_FALSE(second_halted);
+        CHECK(second_steps == 1 + 3 + 2);
+        CHECK(m.state().reg.named.r0() == 0x0000);
+        CHECK(m.state().reg.status.zero());
+        REQUIRE(dbg->condition(0x0006));
+        CHECK(dbg->condition(0x0006)->source() == "r0 == 2 || status.zero");
+
+        CHECK(m.execute(mode));
+        CHECK(m.state().reg.named.r1() == 0x0005);
+
+        // An unconditional breakpoint replaces the condition
+        CHECK_FALSE(dbg->add_breakpoint(0x0006));
+        CHECK(dbg->condition(0x0006) == nullptr);
+      }
+    }
+  }
+}
@@ -0,0 +1,770 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  void store_program(memory& mem, address_t address, std::initializer_list<word_t> words)
+  {
+    for (const word_t word : words)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+  /**
+   * @brief Executes the reference interpreter without any decode cache in strict mode
+   */
+  class reference_machine final
+  {
+  public:
+    explicit reference_machine(const machine& m)
+      : registers_{m.state().reg}
+      , memory_{m.main_memory()}
+    {
+    }
+
+    std::uint64_t execute(std::uint64_t steps)
+    {
+      auto policy = detail::make_execution_policy<machine_profile<feature_level_latest>>(
+        detail::debug_execution_policy{debugger_.get()}, detail::strict_execution_policy{});
+
+      std::uint64_t s = 0;
+      detail::execute_result result{};
+
+      // Like the machine we don't count the final instruction that halts or hits a breakpoint
+      while (s < steps)
+      {
+        result = detail::execute_instruction(policy, registers_, memory_);
+
+        if (!result.keep_going)
+          break;
+
+        ++s;
+      }
+
+      return s;
+    }
+
+    [[nodiscard]] const machine_registers& registers() const noexcept
+    {
+      return registers_;
+    }
+
+    [[nodiscard]] const memory& main_memory() const noexcept
+    {
+      return memory_.main;
+    }
+
+    [[nodiscard]] bool panic() const noexcept
+    {
+      return debugger_->panic();
+    }
+
+  private:
+    machine_registers registers_;
+    machine_memory memory_;
+
+    std::shared_ptr<debugger> debugger_{std::make_shared<debugger>()};
+  };
+
+  [[nodiscard]] word_t random_instruction(std::mt19937& gen)
+  {
+    constexpr std::array<opcode, 9> opcodes{{
+      opcode::move,
+      opcode::load,
+      opcode::store,
+      opcode::add,
+      opcode::add_with_carry,
+      opcode::jump,
+      opcode::cond_jump,
+      opcode::noop,
+      opcode::halt,
+    }};
+
+    std::uniform_int_distribution<unsigned int> word_dist{0, 0xffff};
+    std::uniform_int_distribution<std::size_t> opcode_dist{0, 2 * opcodes.size()};
+
+    const std::size_t index = opcode_dist(gen);
+
+    // Generate an invalid instruction word once in a while
+    if (index == 2 * opcodes.size())
+      return static_cast<word_t>(word_dist(gen));
+
+    // Prefer the instructions with operands over NOP and HLT
+    const opcode code = opcodes[index % (opcodes.size() - 2)];
+    const optype type = detail::instruction_table[static_cast<std::size_t>(code)].type;
+
+    for (;;)
+    {
+      const auto word = static_cast<word_t>((word_dist(gen) & operand_mask) | static_cast<word_t>(code));
+
+      if (!detail::check_instruction_bits(type, word))
+        return word;
+    }
+  }
+
+  /**
+   * @brief Generates instructions without memory accesses, which may run in normal mode without a debugger
+   *
+   * Jumps only target the even addresses of the program and the instruction pointer is never written otherwise.
+   */
+  [[nodiscard]] word_t random_branch_instruction(std::mt19937& gen, std::size_t program_size)
+  {
+    constexpr std::uint8_t ip_index = 7;
+
+    for (;;)
+    {
+      const word_t word = random_instruction(gen);
+      const auto instr = detail::decode_instruction<machine_profile<feature_level_latest>>(word);
+
+      if ((instr.form == detail::operand_form::fallback) || !instr.valid() || instr.long_immediate())
+        continue;
+
+      switch (instr.get_opcode())
+      {
+      case opcode::load:
+      case opcode::store:
+        continue;
+      case opcode::jump:
+      case opcode::cond_jump:
+        if (!detail::is_aligned(instr.imm) || (instr.imm >= program_size * sizeof(word_t)))
+          continue;
+        break;
+      default:
+        if (instr.op0 == ip_index)
+          continue;
+        break;
+      }
+
+      return word;
+    }
+  }
+
+} // namespace
+
+SCENARIO("execute programs with decoded instructions", "[execution]")
+{
+  GIVEN("a machine with a count down loop")
+  {
+    machine m;
+
+    store_program(
+      m.main_memory(),
+      0x0000,
+      {
+        assemble<opcode::move>(r0, immediate),
+        0x0010,
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+        assemble<opcode::halt>(),
+      });
+
+    WHEN("the program is executed")
+    {
+      const auto [halted, steps] = m.execute(1000);
+
+      THEN("the loop shall count down to zero")
+      {
+        CHECK(halted);
+        CHECK(steps == 33);
+        CHECK(m.state().reg.named.r0() == 0x0000);
+        CHECK(m.state().reg.status.zero());
+      }
+    }
+  }
+
+  GIVEN("a machine with a loop that overwrites its own first instruction")
+  {
+    machine m;
+
+    store_program(
+      m.main_memory(),
+      0x0000,
+      {
+        assemble<opcode::move>(r1, immediate),
+        assemble<opcode::add>(r0, accumulator, short_immediate{0x2}),
+        assemble<opcode::move>(r2, immediate),
+        0x000a,
+        assemble<opcode::move>(r3, short_immediate{0x3}),
+        assemble<opcode::add>(r0, accumulator, short_immediate{0x1}), // 0x000a: patched in the first iteration
+        assemble<opcode::store>(r1, r2),
+        assemble<opcode::add>(r3, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x000a}),
+        assemble<opcode::halt>(),
+      });
+
+    WHEN("the program is executed")
+    {
+      REQUIRE(m.execute());
+
+      THEN("the patched instruction shall be executed in the following iterations")
+      {
+        CHECK(m.state().reg.named.r0() == 0x0005);
+      }
+    }
+  }
+
+  GIVEN("a machine with a loop that overwrites the long immediate constant of its first instruction")
+  {
+    machine m;
+
+    store_program(
+      m.main_memory(),
+      0x0000,
+      {
+        assemble<opcode::move>(r3, short_immediate{0x3}),
+        assemble<opcode::move>(r1, short_immediate{0x7}),
+        assemble<opcode::add>(r0, r0, immediate), // 0x0004: long immediate patched in the first iteration
+        0x0001,
+        assemble<opcode::store>(r1, immediate),
+        0x0006,
+        assemble<opcode::add>(r3, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+        assemble<opcode::halt>(),
+      });
+
+    WHEN("the program is executed")
+    {
+      REQUIRE(m.execute());
+
+      THEN("the patched immediate constant shall be used in the following iterations")
+      {
+        CHECK(m.state().reg.named.r0() == 0x000f);
+      }
+    }
+  }
+
+  GIVEN("machines with a store that overwrites the following instruction for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r1, immediate),
+          assemble<opcode::add>(r0, accumulator, short_immediate{0x1}),
+          assemble<opcode::move>(r2, immediate),
+          0x000a,
+          assemble<opcode::store>(r1, r2),
+          assemble<opcode::halt>(), // 0x000a: patched by the store right before
+          assemble<opcode::halt>(),
+        });
+
+      const auto [halted, steps] = m.execute(100);
+
+      CHECK(halted);
+      CHECK(steps == 4);
+      CHECK(m.state().reg.named.r0() == 0x0001);
+      CHECK(m.state().reg.named.ip() == 0x000e);
+    }
+  }
+
+  GIVEN("machines with a loop that overwrites the long immediate constant in every iteration for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r3, immediate),
+          0x0028,
+          assemble<opcode::add>(r0, r0, immediate), // 0x0004: long immediate patched in every iteration
+          0x0000,
+          assemble<opcode::add>(r1, accumulator, short_immediate{0x1}),
+          assemble<opcode::store>(r1, immediate),
+          0x0006,
+          assemble<opcode::add>(r3, accumulator, short_immediate{0xffff}),
+          assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+          assemble<opcode::halt>(),
+        });
+
+      const auto [halted, steps] = m.execute(1000);
+
+      CHECK(halted);
+      CHECK(steps == 1 + 5 * 40);
+      CHECK(m.state().reg.named.r0() == 40 * 39 / 2);
+      CHECK(m.main_memory().load(0x0006) == 40);
+    }
+  }
+
+  GIVEN("machines with a hot loop that overwrites its own jump for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      // The stores fill the words from 0x0036 down to the jump with NOP, so the loop falls through to the halt
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r1, immediate),
+          assemble<opcode::noop>(),
+          assemble<opcode::move>(r2, immediate),
+          0x0036,
+          assemble<opcode::add>(r0, accumulator, short_immediate{0x1}), // 0x0008
+          assemble<opcode::store>(r1, r2),
+          assemble<opcode::add>(r2, accumulator, short_immediate{0xfffe}),
+          assemble<opcode::jump>(short_jump_address{0x0008}), // 0x000e: patched in the last iteration
+        });
+
+      m.main_memory().store(0x0038, assemble<opcode::halt>());
+
+      const auto [halted, steps] = m.execute(1000);
+
+      CHECK(halted);
+      CHECK(steps == 2 + 20 * 4 + 3 + 21);
+      CHECK(m.state().reg.named.r0() == 21);
+      CHECK(m.state().reg.named.ip() == 0x003a);
+    }
+  }
+
+  GIVEN("machines with random programs without memory accesses in normal mode")
+  {
+    std::mt19937 gen{0xc0de};
+
+    for (int i = 0; i < 100; ++i)
+    {
+      std::vector<word_t> program(0x40);
+
+      for (word_t& word : program)
+        word = random_branch_instruction(gen, program.size());
+
+      program.back() = assemble<opcode::halt>();
+
+      machine expected;
+      expected.set_engine(execution_engine::interpreter);
+
+      machine m;
+      m.set_engine(execution_engine::jit);
+
+      for (std::size_t i = 0; i < program.size(); ++i)
+      {
+        expected.main_memory().store(static_cast<address_t>(i * sizeof(word_t)), program[i]);
+        m.main_memory().store(static_cast<address_t>(i * sizeof(word_t)), program[i]);
+      }
+
+      const auto [expected_halted, expected_steps] = expected.execute(5000);
+      const auto [halted, steps] = m.execute(5000);
+
+      CHECK(halted == expected_halted);
+      CHECK(steps == expected_steps);
+      CHECK(m.state().reg == expected.state().reg);
+    }
+  }
+
+  GIVEN("machines with random programs")
+  {
+    constexpr std::array<execution_engine, 5> engines{{
+      execution_engine::interpreter,
+      execution_engine::predecoded,
+      execution_engine::threaded,
+      execution_engine::block,
+      execution_engine::jit,
+    }};
+
+    std::mt19937 gen{0x5eed};
+
+    for (int i = 0; i < 200; ++i)
+    {
+      std::vector<word_t> program(0x80);
+
+      for (word_t& word : program)
+        word = random_instruction(gen);
+
+      std::optional<reference_machine> expected;
+      std::uint64_t expected_steps = 0;
+
+      for (const execution_engine engine : engines)
+      {
+        machine copy{std::make_shared<debugger>()};
+        copy.set_engine(engine);
+
+        for (std::size_t i = 0; i < program.size(); ++i)
+          copy.main_memory().store(static_cast<address_t>(i * sizeof(word_t)), program[i]);
+
+        if (!expected)
+        {
+          expected.emplace(copy);
+          expected_steps = expected->execute(500);
+        }
+
+        const auto [halted, steps] = copy.execute(500, execution_mode::strict);
+
+        CHECK(steps == expected_steps);
+        CHECK(copy.state().reg == expected->registers());
+        CHECK(copy.main_memory() == expected->main_memory());
+      }
+    }
+  }
+
+  GIVEN("the decode tables of all feature levels")
+  {
+    const auto check_table = []<typename Profile>(std::type_identity<Profile>)
+    {
+      const detail::decode_table& table = detail::decode_table_of<Profile>();
+
+      std::size_t mismatches = 0;
+
+      for (std::size_t i = 0; i < detail::decode_table::num_entries; ++i)
+      {
+        const auto word = static_cast<word_t>(i);
+
+        if (table[word] != detail::decode_instruction<Profile>(word))
+          ++mismatches;
+      }
+
+      return mismatches;
+    };
+
+    THEN("every entry shall be the decoded instruction word")
+    {
+      CHECK(check_table(std::type_identity<machine_profile<feature_level::min>>{}) == 0);
+      CHECK(check_table(std::type_identity<machine_profile<feature_level::v1>>{}) == 0);
+    }
+  }
+
+  GIVEN("a decode cache with fused pairs")
+  {
+    using profile = machine_profile<feature_level_latest>;
+
+    machine m;
+    store_program(
+      m.main_memory(),
+      0x0000,
+      {
+        assemble<opcode::load>(r2, r1),
+        assemble<opcode::store>(r2, r3),
+        assemble<opcode::add>(r4, accumulator, short_immediate{0x1}),
+        assemble<opcode::add_with_carry>(r5, accumulator, short_immediate{0x0}),
+        assemble<opcode::add_with_carry>(r5, r5, immediate),
+        0x0000,
+        assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0000}),
+        assemble<opcode::add>(ip, accumulator, short_immediate{0x2}),
+        assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0000}),
+      });
+
+    detail::decode_cache cache;
+
+    const auto fused = [&](address_t address)
+    { return cache.get<profile>(std::as_const(m).main_memory(), address).fused(); };
+
+    THEN("the pairs shall be fused with the instruction following them")
+    {
+      CHECK(fused(0x0000) == detail::fusion::store);
+      CHECK(fused(0x0002) == detail::fusion::none);
+      CHECK(fused(0x0004) == detail::fusion::add_with_carry);
+      CHECK(fused(0x0006) == detail::fusion::add_with_carry);
+      CHECK(fused(0x0008) == detail::fusion::none);
+      CHECK(fused(0x000c) == detail::fusion::cond_jump);
+      CHECK(fused(0x0010) == detail::fusion::none);
+    }
+
+    WHEN("the second instruction of a pair is overwritten")
+    {
+      static_cast<void>(fused(0x0000));
+
+      m.main_memory().store(0x0002, assemble<opcode::noop>());
+      cache.invalidate(0x0002);
+
+      THEN("the fusion shall be dropped")
+      {
+        CHECK(fused(0x0000) == detail::fusion::none);
+      }
+    }
+  }
+
+  GIVEN("machines with fused pairs for each step count")
+  {
+    constexpr std::array<execution_engine, 5> engines{{
+      execution_engine::interpreter,
+      execution_engine::predecoded,
+      execution_engine::threaded,
+      execution_engine::block,
+      execution_engine::jit,
+    }};
+
+    // A copy loop with an addition chain, which copies over its own tail and replaces its jump by a NOP
+    const std::initializer_list<word_t> program{
+      assemble<opcode::move>(r1, immediate),
+      0x0100,
+      assemble<opcode::move>(r3, immediate),
+      0x0016,
+      assemble<opcode::move>(r0, short_immediate{0x4}),
+      assemble<opcode::load>(r2, r1), // 0x000a
+      assemble<opcode::store>(r2, r3),
+      assemble<opcode::add>(r1, accumulator, short_immediate{0x2}),
+      assemble<opcode::add>(r3, accumulator, short_immediate{0x2}),
+      assemble<opcode::add>(r4, accumulator, short_immediate{0xffff}),
+      assemble<opcode::add_with_carry>(r5, accumulator, short_immediate{0x0}),
+      assemble<opcode::add_with_carry>(sp, accumulator, short_immediate{0x0}), // 0x0016
+      assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+      assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x000a}), // 0x001a: patched by the third copy
+      assemble<opcode::halt>(),
+    };
+
+    for (std::uint64_t n = 0; n < 40; ++n)
+    {
+      std::optional<reference_machine> expected;
+      std::uint64_t expected_steps = 0;
+
+      for (const execution_engine engine : engines)
+      {
+        machine m{std::make_shared<debugger>()};
+        m.set_engine(engine);
+
+        store_program(m.main_memory(), 0x0000, program);
+        store_program(
+          m.main_memory(),
+          0x0100,
+          {
+            assemble<opcode::add_with_carry>(sp, accumulator, short_immediate{0x0}),
+            assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+            assemble<opcode::noop>(),
+          });
+
+        if (!expected)
+        {
+          expected.emplace(m);
+          expected_steps = expected->execute(n);
+        }
+
+        const auto [halted, steps] = m.execute(n, execution_mode::strict);
+
+        CHECK(steps == expected_steps);
+        CHECK(m.state().reg == expected->registers());
+        CHECK(m.main_memory() == expected->main_memory());
+      }
+    }
+  }
+
+  GIVEN("machines with an idle polling loop for each engine")
+  {
+    constexpr std::array<execution_engine, 5> engines{{
+      execution_engine::interpreter,
+      execution_engine::predecoded,
+      execution_engine::threaded,
+      execution_engine::block,
+      execution_engine::jit,
+    }};
+
+    constexpr std::uint64_t n = 1'000'000'000'001;
+
+    for (const execution_engine engine : engines)
+    {
+      for (const bool debug : {false, true})
+      {
+        machine m = debug ? machine{std::make_shared<debugger>()} : machine{};
+        m.set_engine(engine);
+
+        store_program(
+          m.main_memory(),
+          0x0000,
+          {
+            assemble<opcode::move>(r1, immediate),
+            0x0100,
+            assemble<opcode::load>(r0, r1), // 0x0004: polls a word that is never written
+            assemble<opcode::add>(r0, accumulator, short_immediate{0x0}),
+            assemble<opcode::cond_jump>(jz, short_cond_jump_address{0x0004}),
+            assemble<opcode::halt>(),
+          });
+
+        // The state repeats every three steps after the first iteration
+        reference_machine expected{m};
+        expected.execute(1 + 2 * 3 + (n - 1) % 3);
+
+        const auto [halted, steps] = m.execute(n, debug ? execution_mode::strict : execution_mode::normal);
+
+        CHECK_FALSE(halted);
+        CHECK(steps == n);
+        CHECK(m.state().reg == expected.registers());
+        CHECK(m.state().reg.named.ip() == 0x0006);
+      }
+    }
+  }
+
+  GIVEN("machines with a loop that jumps to itself for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r0, short_immediate{0x1}),
+          assemble<opcode::jump>(short_jump_address{0x0002}),
+        });
+
+      const auto [halted, steps] = m.execute(std::numeric_limits<std::uint64_t>::max());
+
+      CHECK_FALSE(halted);
+      CHECK(steps == std::numeric_limits<std::uint64_t>::max());
+      CHECK(m.state().reg.named.r0() == 0x0001);
+      CHECK(m.state().reg.named.ip() == 0x0002);
+    }
+  }
+
+  GIVEN("machines with a long loop that is not idle for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      // The loop only repeats its state after 2 * 65536 steps, so it is executed step by step
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::add>(r0, accumulator, short_immediate{0x1}),
+          assemble<opcode::jump>(short_jump_address{0x0000}),
+        });
+
+      const auto [halted, steps] = m.execute(3'000'001);
+
+      CHECK_FALSE(halted);
+      CHECK(steps == 3'000'001);
+      CHECK(m.state().reg.named.r0() == static_cast<word_t>(1'500'001));
+      CHECK(m.state().reg.named.ip() == 0x0002);
+    }
+  }
+
+  GIVEN("machines with a long count down loop for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r0, immediate),
+          0x0100,
+          assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+          assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+          assemble<opcode::halt>(),
+        });
+
+      const auto [halted, steps] = m.execute(301);
+
+      CHECK_FALSE(halted);
+      CHECK(steps == 301);
+      CHECK(m.state().reg.named.r0() == 0x0100 - 150);
+      CHECK(m.state().reg.named.ip() == 0x0004);
+
+      const auto [final_halted, final_steps] = m.execute(1000);
+
+      CHECK(final_halted);
+      CHECK(final_steps == 2 * 0x0100 - 300);
+      CHECK(m.state().reg.named.r0() == 0x0000);
+      CHECK(m.state().reg.status.zero());
+      CHECK(m.state().reg.named.ip() == 0x000a);
+    }
+  }
+
+  GIVEN("machines with a count down loop for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      machine m;
+      m.set_engine(engine);
+
+      store_program(
+        m.main_memory(),
+        0x0000,
+        {
+          assemble<opcode::move>(r0, immediate),
+          0x0010,
+          assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+          assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0004}),
+          assemble<opcode::halt>(),
+        });
+
+      const auto [halted, steps] = m.execute(20);
+
+      CHECK_FALSE(halted);
+      CHECK(steps == 20);
+      CHECK(m.state().reg.named.r0() == 0x0006);
+
+      REQUIRE(m.execute());
+
+      CHECK(m.state().reg.named.r0() == 0x0000);
+      CHECK(m.state().reg.named.ip() == 0x000a);
+    }
+  }
+}
@@ -0,0 +1,424 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <emu/gdb_stub.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+  using yarisc::emu::gdb_stub;
+
+  /**
+   * @brief Frames the data of a packet with its checksum
+   */
+  [[nodiscard]] std::string frame(std::string_view data)
+  {
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+
+    unsigned int sum = 0;
+
+    for (const char c : data)
+      sum += static_cast<unsigned char>(c);
+
+    std::string packet{"$"};
+    packet += data;
+    packet += '#';
+    packet += hex_digits[(sum >> 4) & 0xf];
+    packet += hex_digits[sum & 0xf];
+
+    return packet;
+  }
+
+  /**
+   * @brief Serves the input and returns everything the stub has written
+   */
+  [[nodiscard]] std::string serve_input(
+    machine& m, debugger& dbg, const std::string& input, execution_mode mode = execution_mode::strict)
+  {
+    std::istringstream in{input};
+    std::ostringstream out;
+
+    gdb_stub{m, dbg, in, out}.serve(mode);
+
+    return std::move(out).str();
+  }
+
+  /**
+   * @brief Serves the packets and returns the data of the replies without acknowledgments and checksums
+   */
+  [[nodiscard]] std::vector<std::string> serve_packets(
+    machine& m,
+    debugger& dbg,
+    std::initializer_list<std::string_view> packets,
+    execution_mode mode = execution_mode::strict)
+  {
+    std::string input;
+
+    for (const std::string_view packet : packets)
+      input += frame(packet);
+
+    const std::string output = serve_input(m, dbg, input, mode);
+
+    std::vector<std::string> replies;
+
+    for (std::size_t first = output.find('$'); first != std::string::npos; first = output.find('$', first))
+    {
+      const std::size_t last = output.find('#', first);
+
+      replies.push_back(output.substr(first + 1, last - first - 1));
+      first = last;
+    }
+
+    return replies;
+  }
+
+  /**
+   * @brief Stores a program, which stores to a watched address, halts, and is followed by an invalid instruction
+   */
+  void store_program(memory& mem)
+  {
+    address_t address = 0x0000;
+
+    for (const word_t word : {
+           assemble<opcode::move>(r0, short_immediate{0x3}),
+           assemble<opcode::move>(r1, immediate), // 0x0002
+           word_t{0x0200},
+           assemble<opcode::store>(r0, r1), // 0x0006
+           assemble<opcode::halt>(),        // 0x0008
+           word_t{0x0000},                  // 0x000a
+         })
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+} // namespace
+
+SCENARIO("frame the packets of the GDB remote serial protocol", "[gdb_stub]")
+{
+  GIVEN("a machine with a debugger")
+  {
+    const auto dbg = std::make_shared<debugger>();
+    machine m{dbg};
+
+    WHEN("a packet with a valid checksum is received")
+    {
+      const std::string output = serve_input(m, *dbg, frame("?"));
+
+      THEN("it shall be acknowledged and answered")
+      {
+        CHECK(output == "+$S05#b8");
+      }
+    }
+
+    WHEN("a packet with a bad checksum is received")
+    {
+      const std::string output = serve_input(m, *dbg, "$?#00" + frame("?"));
+
+      THEN("it shall be rejected and the retransmitted packet shall be answered")
+      {
+        CHECK(output == "-+$S05#b8");
+      }
+    }
+
+    WHEN("the frontend rejects a reply")
+    {
+      const std::string output = serve_input(m, *dbg, frame("?") + '-');
+
+      THEN("the reply shall be retransmitted")
+      {
+        CHECK(output == "+$S05#b8$S05#b8");
+      }
+    }
+
+    WHEN("the no-acknowledgment mode is started")
+    {
+      const std::string output = serve_input(m, *dbg, frame("QStartNoAckMode") + "$?#00" + frame("?"));
+
+      THEN("only the packet that starts it shall be acknowledged")
+      {
+        CHECK(output == std::string{"+"} + frame("OK") + frame("S05"));
+      }
+    }
+
+    WHEN("the frontend detaches")
+    {
+      const std::string output = serve_input(m, *dbg, frame("D") + frame("?"));
+
+      THEN("the session shall end")
+      {
+        CHECK(output == std::string{"+"} + frame("OK"));
+      }
+    }
+
+    WHEN("unsupported or malformed packets are received")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"vMustReplyEmpty", "m100", "p9", "G0000"});
+
+      THEN("they shall be answered with an empty reply or an error")
+      {
+        CHECK(replies == std::vector<std::string>{"", "E01", "E01", "E01"});
+      }
+    }
+  }
+}
+
+SCENARIO("access registers and memory through the GDB stub", "[gdb_stub]")
+{
+  GIVEN("a machine with a debugger")
+  {
+    const auto dbg = std::make_shared<debugger>();
+    machine m{dbg};
+
+    WHEN("all registers are written and read")
+    {
+      const std::vector<std::string> replies =
+        serve_packets(m, *dbg, {"G010002000300040005000600fe0f10000300", "g", "p8"});
+
+      THEN("they shall be transferred in the byte order of the machine")
+      {
+        REQUIRE(replies.size() == 3);
+        CHECK(replies[0] == "OK");
+        CHECK(replies[1] == "010002000300040005000600fe0f10000300");
+        CHECK(replies[2] == "0300");
+        CHECK(m.state().reg.named.r0() == 0x0001);
+        CHECK(m.state().reg.named.sp() == 0x0ffe);
+        CHECK(m.state().reg.named.ip() == 0x0010);
+        CHECK(m.state().reg.status.s == 0x0003);
+      }
+    }
+
+    WHEN("a single register is written and read")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"P7=0201", "p7"});
+
+      THEN("only that register shall change")
+      {
+        CHECK(replies == std::vector<std::string>{"OK", "0201"});
+        CHECK(m.state().reg.named.ip() == 0x0102);
+        CHECK(m.state().reg.named.r0() == 0x0000);
+      }
+    }
+
+    WHEN("memory is written in hexadecimal and read")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"M100,2:3412", "m100,2", "mfffe,4"});
+
+      THEN("the bytes shall be stored at the address")
+      {
+        REQUIRE(replies.size() == 3);
+        CHECK(replies[0] == "OK");
+        CHECK(replies[1] == "3412");
+        CHECK(replies[2].size() == 4);
+        CHECK(m.main_memory().load(0x0100) == 0x1234);
+      }
+    }
+
+    WHEN("memory is written in binary with escaped bytes")
+    {
+      // The bytes 0x7d and 0x23 are escaped as '}' followed by the byte xor 0x20
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"X200,3:}]}\x03\x01", "m200,3"});
+
+      THEN("the unescaped bytes shall be stored")
+      {
+        CHECK(replies == std::vector<std::string>{"OK", "7d2301"});
+      }
+    }
+
+    WHEN("memory is written beyond the address space or with too few bytes")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"Mffff,2:0102", "X0,2:\x01"});
+
+      THEN("the writes shall fail")
+      {
+        CHECK(replies == std::vector<std::string>{"E01", "E01"});
+      }
+    }
+  }
+}
+
+SCENARIO("control the execution through the GDB stub", "[gdb_stub]")
+{
+  GIVEN("a machine with a debugger and a program")
+  {
+    const auto dbg = std::make_shared<debugger>();
+    machine m{dbg};
+
+    store_program(m.main_memory());
+
+    WHEN("a single step is executed")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"s"});
+
+      THEN("the machine shall stop after the instruction")
+      {
+        CHECK(replies == std::vector<std::string>{"S05"});
+        CHECK(m.state().reg.named.ip() == 0x0002);
+      }
+    }
+
+    WHEN("the execution continues to a breakpoint and a write watchpoint")
+    {
+      const std::vector<std::string> replies =
+        serve_packets(m, *dbg, {"Z0,6,2", "c", "z0,6,2", "Z2,200,2", "c", "?", "z2,200,2", "c", "c", "?"});
+
+      THEN("the stop replies shall name the reason")
+      {
+        CHECK(
+          replies == std::vector<std::string>{
+                       "OK", "S05", "OK", "OK", "T05watch:0200;", "T05watch:0200;", "OK", "W00", "W00", "W00"});
+        CHECK(m.main_memory().load(0x0200) == 0x0003);
+        CHECK_FALSE(dbg->has_breakpoints());
+        CHECK_FALSE(dbg->has_watchpoints());
+      }
+    }
+
+    WHEN("memory is read between two steps of the block and the translating engine")
+    {
+      THEN("the decoded and translated code shall be kept")
+      {
+        for (const execution_engine engine : {execution_engine::block, execution_engine::jit})
+        {
+          m.set_engine(engine);
+          m.reset();
+          store_program(m.main_memory());
+
+          const std::vector<std::string> stepped = serve_packets(m, *dbg, {"s"}, execution_mode::normal);
+          const std::uint64_t generation = m.code_generation();
+
+          const std::vector<std::string> replies =
+            serve_packets(m, *dbg, {"m0,a", "m200,2", "s"}, execution_mode::normal);
+
+          CHECK(stepped == std::vector<std::string>{"S05"});
+          REQUIRE(replies.size() == 3);
+          CHECK(replies[2] == "S05");
+          CHECK(m.code_generation() == generation);
+        }
+      }
+    }
+
+    WHEN("read and access watchpoints are set and removed")
+    {
+      const std::vector<std::string> inserted = serve_packets(m, *dbg, {"Z1,8,2", "Z3,300,1", "Z4,400,2"});
+
+      THEN("they shall be set in the debugger")
+      {
+        CHECK(inserted == std::vector<std::string>{"OK", "OK", "OK"});
+        CHECK(dbg->breakpoints() == std::vector<address_t>{0x0008});
+        CHECK(
+          dbg->watchpoints() ==
+          std::vector<watchpoint>{
+            watchpoint{0x0300, 0x0001, watch_access::read}, watchpoint{0x0400, 0x0002, watch_access::read_write}});
+      }
+
+      AND_WHEN("they are removed")
+      {
+        const std::vector<std::string> removed = serve_packets(m, *dbg, {"z1,8,2", "z3,300,1", "z4,400,2"});
+
+        THEN("the debugger shall have none")
+        {
+          CHECK(removed == std::vector<std::string>{"OK", "OK", "OK"});
+          CHECK_FALSE(dbg->has_breakpoints());
+          CHECK_FALSE(dbg->has_watchpoints());
+        }
+      }
+    }
+
+    WHEN("invalid breakpoints are set")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"Z0,3,2", "Z0,10000,2", "Z5,0,2"});
+
+      THEN("they shall be rejected")
+      {
+        CHECK(replies == std::vector<std::string>{"E01", "E01", ""});
+      }
+    }
+
+    WHEN("an invalid instruction is executed")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"P7=0a00", "c", "?"});
+
+      THEN("the message shall be sent as output and the stop reply shall report the signal")
+      {
+        REQUIRE(replies.size() == 4);
+        CHECK(replies[0] == "OK");
+        CHECK(replies[1].starts_with("O496e76616c6964")); // "Invalid" in hexadecimal
+        CHECK(replies[2] == "S04");
+        CHECK(replies[3] == "S04");
+        CHECK_FALSE(dbg->panic());
+      }
+    }
+  }
+}
+
+SCENARIO("query the GDB stub", "[gdb_stub]")
+{
+  GIVEN("a machine with a debugger")
+  {
+    const auto dbg = std::make_shared<debugger>();
+    machine m{dbg};
+
+    WHEN("the features are queried")
+    {
+      const std::vector<std::string> replies = serve_packets(m, *dbg, {"qSupported:multiprocess+", "qAttached"});
+
+      THEN("the no-acknowledgment mode and the target description shall be supported")
+      {
+        REQUIRE(replies.size() == 2);
+        CHECK(replies[0].find("QStartNoAckMode+") != std::string::npos);
+        CHECK(replies[0].find("qXfer:features:read+") != std::string::npos);
+        CHECK(replies[1] == "1");
+      }
+    }
+
+    WHEN("the target description is read in chunks")
+    {
+      std::string description;
+      std::string chunk;
+
+      for (std::size_t offset = 0; chunk.empty() || (chunk[0] == 'm'); offset += 0x40)
+      {
+        std::ostringstream packet;
+        packet << "qXfer:features:read:target.xml:" << std::hex << offset << ",40";
+
+        const std::vector<std::string> replies = serve_packets(m, *dbg, {packet.str()});
+
+        REQUIRE(replies.size() == 1);
+        REQUIRE(!replies[0].empty());
+        REQUIRE(replies[0].size() <= 0x41);
+
+        chunk = replies[0];
+        description += chunk.substr(1);
+      }
+
+      THEN("the chunks shall form the whole description")
+      {
+        CHECK(description.starts_with("<?xml"));
+        CHECK(description.ends_with("</target>"));
+        CHECK(description.find("name=\"status\"") != std::string::npos);
+      }
+
+      THEN("a read beyond the end shall be empty")
+      {
+        CHECK(serve_packets(m, *dbg, {"qXfer:features:read:target.xml:1000,40"}) == std::vector<std::string>{"l"});
+      }
+    }
+  }
+}
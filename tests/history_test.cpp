@@ -0,0 +1,202 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/condition.hpp>
+#include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/history.hpp>
+#include <yarisc/arch/machine.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  /**
+   * @brief Stores the counter to consecutive words from 0x0200 up to the end of memory and halts
+   */
+  void store_program(memory& mem)
+  {
+    const std::initializer_list<word_t> words{
+      assemble<opcode::move>(r0, short_immediate{0x0}),
+      assemble<opcode::move>(r1, immediate), // 0x0002
+      0x0200,
+      assemble<opcode::add>(r0, accumulator, short_immediate{0x1}), // 0x0006
+      assemble<opcode::store>(r0, r1),                               // 0x0008
+      assemble<opcode::add>(r1, accumulator, short_immediate{0x2}), // 0x000a
+      assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+      assemble<opcode::halt>(),
+    };
+
+    address_t address = 0x0000;
+
+    for (const word_t word : words)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+  [[nodiscard]] bool same_state(const machine& lhs, const machine& rhs)
+  {
+    const memory& a = lhs.main_memory();
+    const memory& b = rhs.main_memory();
+
+    return (lhs.state().reg == rhs.state().reg) && (a.size() == b.size()) &&
+           (std::memcmp(a.data(), b.data(), a.size()) == 0);
+  }
+
+} // namespace
+
+SCENARIO("step back through the execution history", "[history]")
+{
+  GIVEN("a machine executed through a history until it halts")
+  {
+    machine m;
+    store_program(m.main_memory());
+
+    execution_history history{64};
+    history.reset(std::as_const(m));
+
+    CHECK(history.execute(m));
+
+    const std::uint64_t last = history.step();
+
+    REQUIRE(last > 100000);
+
+    THEN("the number of snapshots shall be bounded")
+    {
+      CHECK(history.snapshots() <= execution_history::max_snapshots);
+      CHECK(history.interval() > 64);
+    }
+
+    THEN("stepping back shall restore the state of each earlier step")
+    {
+      for (const std::uint64_t back : {std::uint64_t{1}, std::uint64_t{3}, std::uint64_t{4097}, std::uint64_t{50000}})
+      {
+        const std::uint64_t target = history.step() - back;
+
+        CHECK(history.step_back(m, back) == back);
+        CHECK(history.step() == target);
+
+        machine expected;
+        store_program(expected.main_memory());
+
+        CHECK(expected.execute(target).second == target);
+        CHECK(same_state(m, expected));
+      }
+    }
+
+    THEN("stepping back beyond the first step shall stop at step zero")
+    {
+      CHECK(history.step_back(m, last + 10) == last);
+      CHECK(history.step() == 0);
+      CHECK(m.state().reg == machine{}.state().reg);
+
+      AND_THEN("executing again shall get to the same final state")
+      {
+        machine expected;
+        store_program(expected.main_memory());
+        CHECK(expected.execute());
+
+        CHECK(history.execute(m));
+        CHECK(history.step() == last);
+        CHECK(same_state(m, expected));
+      }
+    }
+  }
+}
+
+SCENARIO("reverse continue to earlier breakpoints", "[history]")
+{
+  GIVEN("machines with a conditional breakpoint at a snapshot boundary for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      const auto dbg = std::make_shared<debugger>();
+
+      machine m{dbg};
+      m.set_engine(engine);
+      store_program(m.main_memory());
+
+      dbg->add_breakpoint(0x000a, breakpoint_condition{"r0 == 100"});
+
+      execution_history history{4};
+      history.reset(std::as_const(m));
+
+      // The breakpoint is hit at a multiple of the interval, where the execution is split
+      CHECK_FALSE(history.execute(m));
+      CHECK(history.step() == 400);
+      CHECK(m.state().reg.named.ip() == 0x000a);
+      CHECK(m.state().reg.named.r0() == 100);
+
+      CHECK(history.execute(m, 1000) == std::pair<bool, std::uint64_t>{false, 1000});
+      CHECK(history.step() == 1400);
+
+      const std::optional<std::uint64_t> found = history.reverse_continue(m);
+
+      CHECK(found == std::optional<std::uint64_t>{400});
+      CHECK(history.step() == 400);
+      CHECK(m.state().reg.named.ip() == 0x000a);
+      CHECK(m.state().reg.named.r0() == 100);
+
+      // There is no earlier stop, so the machine remains where it is
+      CHECK_FALSE(history.reverse_continue(m));
+      CHECK(history.step() == 400);
+      CHECK(m.state().reg.named.r0() == 100);
+
+      // Resuming steps over the breakpoint
+      CHECK(history.execute(m, 4) == std::pair<bool, std::uint64_t>{false, 4});
+      CHECK(m.state().reg.named.ip() == 0x000a);
+      CHECK(m.state().reg.named.r0() == 101);
+      CHECK_FALSE(dbg->panic());
+    }
+  }
+}
+
+SCENARIO("execute through the history in chunks", "[history]")
+{
+  GIVEN("a machine stopped at the end of a chunk on a breakpoint")
+  {
+    const auto dbg = std::make_shared<debugger>();
+
+    machine m{dbg};
+    store_program(m.main_memory());
+
+    dbg->add_breakpoint(0x000a, breakpoint_condition{"r0 == 100"});
+
+    execution_history history{64};
+    history.reset(std::as_const(m));
+
+    CHECK(history.execute(m, 400) == std::pair<bool, std::uint64_t>{false, 400});
+    CHECK(m.state().reg.named.ip() == 0x000a);
+    CHECK(m.state().reg.named.r0() == 100);
+
+    THEN("continuing the execution shall stop at the breakpoint")
+    {
+      CHECK(history.continue_execution(m, 10) == std::pair<bool, std::uint64_t>{false, 0});
+      CHECK(history.step() == 400);
+    }
+
+    THEN("executing shall step over the breakpoint")
+    {
+      CHECK(history.execute(m, 10) == std::pair<bool, std::uint64_t>{false, 10});
+      CHECK(history.step() == 410);
+    }
+  }
+}
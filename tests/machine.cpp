@@ -6,6 +6,8 @@
 #include <tests/machine.hpp>
 
 #include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
 #include <yarisc/arch/detail/execution.hpp>
 #include <yarisc/arch/machine_profile.hpp>
 
@@ -13,6 +15,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <stdexcept>
 
 namespace yarisc::test
@@ -21,6 +24,27 @@ namespace yarisc::test
   {
     constexpr auto max_size = static_cast<machine::size_type>(std::numeric_limits<arch::address_t>::max()) + 1;
 
+    using profile = arch::machine_profile<arch::feature_level_latest>;
+
+    /**
+     * @brief Executes one instruction like the decoded engines, from a decode cache with lazily evaluated flags
+     */
+    [[nodiscard]] arch::detail::execute_result execute_decoded_instruction(
+      arch::machine_registers& reg, arch::machine_memory& mem, arch::debugger& dbg)
+    {
+      arch::detail::decode_cache cache;
+      arch::detail::block_cache blocks;
+
+      auto policy = arch::detail::make_lazy_flags_policy(arch::detail::make_execution_policy<profile>(
+        arch::detail::debug_execution_policy{&dbg},
+        arch::detail::strict_execution_policy{},
+        arch::detail::cache_execution_policy{&cache, &blocks, nullptr}));
+
+      arch::detail::flags_scope scope{policy, reg};
+
+      return arch::detail::execute_decoded_instruction(policy, reg, mem);
+    }
+
   } // namespace
 
   machine::machine() = default;
@@ -75,12 +99,32 @@ namespace yarisc::test
 
   bool machine::execute_instruction(bool throw_on_breakpoint)
   {
-    auto policy = arch::detail::make_execution_policy<arch::machine_profile<arch::feature_level_latest>>(
+    // The step is executed a second time on a copy like the decoded engines, which must end in the same state. The
+    // decode cache covers the whole address space, so the copy has the maximum memory with the same initial contents.
+    arch::machine_registers decoded_registers = registers_;
+    arch::machine_memory decoded_memory{initial_memory(max_size)};
+    arch::debugger decoded_debugger;
+
+    std::ranges::copy(memory_.main, decoded_memory.main.begin());
+
+    const arch::detail::execute_result decoded =
+      execute_decoded_instruction(decoded_registers, decoded_memory, decoded_debugger);
+
+    // The reference interpreter evaluates the status flags eagerly
+    auto policy = arch::detail::make_execution_policy<profile>(
       arch::detail::debug_execution_policy{debugger_.get()}, arch::detail::strict_execution_policy{});
 
     const auto [keep_going, breakpoint] = arch::detail::execute_instruction(policy, registers_, memory_);
 
-    if (debugger_ && debugger_->panic())
+    const bool panic = debugger_ && debugger_->panic();
+    const std::span<const std::byte> decoded_main{decoded_memory.main.data(), memory_.main.size()};
+
+    if ((decoded.keep_going != keep_going) || (decoded.breakpoint != breakpoint) ||
+        (decoded_registers != registers_) || !std::ranges::equal(memory_.main, decoded_main) ||
+        (decoded_debugger.panic() != panic) || (panic && (decoded_debugger.message() != debugger_->message())))
+      throw std::runtime_error{"decoded execution with lazy flags differs from the reference interpreter"};
+
+    if (panic)
       throw std::runtime_error{debugger_->message()};
 
     if (throw_on_breakpoint && breakpoint)
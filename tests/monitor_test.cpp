@@ -0,0 +1,441 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/monitor.hpp>
+#include <yarisc/arch/output.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace yarisc::arch;
+  using namespace yarisc::arch::assembly;
+
+  void store_program(memory& mem)
+  {
+    const std::initializer_list<word_t> words{
+      assemble<opcode::move>(r0, short_immediate{0x3}),
+      assemble<opcode::move>(r1, immediate), // 0x0002
+      0x0200,
+      assemble<opcode::store>(r0, r1), // 0x0006
+      assemble<opcode::add>(r0, accumulator, short_immediate{0xffff}),
+      assemble<opcode::cond_jump>(jnz, short_cond_jump_address{0x0006}),
+      assemble<opcode::halt>(),
+    };
+
+    address_t address = 0x0000;
+
+    for (const word_t word : words)
+    {
+      mem.store(address, word);
+      address += sizeof(word_t);
+    }
+  }
+
+} // namespace
+
+SCENARIO("trace the executed instructions", "[monitor]")
+{
+  GIVEN("machines with a monitor recording a trace for each engine")
+  {
+    for (const execution_engine engine :
+         {execution_engine::interpreter,
+          execution_engine::predecoded,
+          execution_engine::threaded,
+          execution_engine::block,
+          execution_engine::jit})
+    {
+      const auto mon = std::make_shared<execution_monitor>();
+      mon->enable_trace(16);
+
+      machine m;
+      m.set_engine(engine);
+      m.set_monitor(mon);
+      store_program(m.main_memory());
+
+      machine reference;
+      reference.set_engine(engine);
+      store_program(reference.main_memory());
+
+      const auto [halted, steps] = m.execute(100);
+      const auto [reference_halted, reference_steps] = reference.execute(100);
+
+      THEN("the execution shall not be affected by the monitor")
+      {
+        CHECK(halted == reference_halted);
+        CHECK(steps == reference_steps);
+        CHECK(m.state().reg.named.r0() == reference.state().reg.named.r0());
+        CHECK(m.main_memory().load(0x0200) == reference.main_memory().load(0x0200));
+      }
+
+      THEN("the trace shall contain the retired instructions with their effects")
+      {
+        REQUIRE(mon->trace() != nullptr);
+
+        const trace_ring& trace = *mon->trace();
+
+        CHECK(trace.capacity() == 16);
+        CHECK(trace.count() == 11);
+
+        const std::vector<trace_entry> entries = trace.entries();
+
+        REQUIRE(entries.size() == 11);
+
+        CHECK(entries[0].ip == 0x0000);
+        CHECK(entries[0].size == 1);
+        CHECK(entries[0].reg == 0);
+        CHECK(entries[0].value == 0x0003);
+        CHECK_FALSE(entries[0].store);
+
+        CHECK(entries[1].ip == 0x0002);
+        CHECK(entries[1].size == 2);
+        CHECK(entries[1].words[1] == 0x0200);
+        CHECK(entries[1].reg == 1);
+        CHECK(entries[1].value == 0x0200);
+
+        CHECK(entries[2].ip == 0x0006);
+        CHECK(entries[2].reg == trace_entry::no_register);
+        CHECK(entries[2].store);
+        CHECK(entries[2].address == 0x0200);
+        CHECK(entries[2].data == 0x0003);
+
+        CHECK(entries[3].reg == 0);
+        CHECK(entries[3].value == 0x0002);
+        CHECK((entries[3].status & status_register::zero_flag) == 0);
+
+        CHECK(entries[9].value == 0x0000);
+        CHECK((entries[9].status & status_register::zero_flag) != 0);
+
+        CHECK(entries[10].ip == 0x000a);
+        CHECK(entries[10].reg == trace_entry::no_register);
+      }
+
+      THEN("the output shall have one line per entry")
+      {
+        std::ostringstream os;
+        output(os, *mon->trace(), output_format::plain);
+
+        const std::string text = os.str();
+
+        CHECK(std::count(text.begin(), text.end(), '\n') == 11);
+        CHECK(text.find("[0200] = 0003") != std::string::npos);
+      }
+    }
+  }
+
+  GIVEN("a machine with a trace smaller than the execution")
+  {
+    const auto mon = std::make_shared<execution_monitor>();
+    mon->enable_trace(3);
+
+    machine m;
+    m.set_monitor(mon);
+    store_program(m.main_memory());
+
+    CHECK(m.execute(100).first);
+
+    THEN("the trace shall keep the latest instructions")
+    {
+      const trace_ring& trace = *mon->trace();
+
+      CHECK(trace.capacity() == 4);
+      CHECK(trace.size() == 4);
+      CHECK(trace.count() == 11);
+
+      const std::vector<trace_entry> entries = trace.entries();
+
+      REQUIRE(entries.size() == 4);
+      CHECK(entries[0].ip == 0x000a);
+      CHECK(entries[1].ip == 0x0006);
+      CHECK(entries[1].data == 0x0001);
+      CHECK(entries[2].ip == 0x0008);
+      CHECK(entries[3].ip == 0x000a);
+    }
+
+    WHEN("the trace is cleared")
+    {
+      mon->enable_trace(3);
+
+      THEN("it shall be empty")
+      {
+        CHECK(mon->trace()->size() == 0);
+        CHECK(mon->trace()->entries().empty());
+      }
+    }
+  }
+}
+
+SCENARIO("profile the executed instructions", "[monitor]")
+{
+  GIVEN("a machine with a monitor counting a profile")
+  {
+    const auto mon = std::make_shared<execution_monitor>();
+    mon->enable_profile();
+
+    machine m;
+    m.set_monitor(mon);
+    store_program(m.main_memory());
+
+    m.main_memory().store(0x0100, assemble<opcode::load>(r2, immediate));
+    m.main_memory().store(0x0102, 0x0300);
+
+    CHECK(m.execute(100).first);
+
+    THEN("the instructions shall be counted per address")
+    {
+      const execution_profile& profile = *mon->profile();
+
+      CHECK(profile.total() == 11);
+      CHECK(profile.instructions(0x0000) == 1);
+      CHECK(profile.instructions(0x0002) == 1);
+      CHECK(profile.instructions(0x0004) == 0);
+      CHECK(profile.instructions(0x0006) == 3);
+      CHECK(profile.instructions(0x0008) == 3);
+      CHECK(profile.instructions(0x000a) == 3);
+      CHECK(profile.instructions(0x000c) == 0);
+    }
+
+    THEN("the conditional jump shall be counted as taken until the loop ends")
+    {
+      CHECK(mon->profile()->taken(0x000a) == 2);
+    }
+
+    THEN("the stores shall be counted per page")
+    {
+      CHECK(mon->profile()->stores(0x0200) == 3);
+      CHECK(mon->profile()->stores(0x02ff) == 3);
+      CHECK(mon->profile()->stores(0x0300) == 0);
+      CHECK(mon->profile()->loads(0x0200) == 0);
+    }
+
+    THEN("the report shall list the loop as the hottest block")
+    {
+      std::ostringstream os;
+      output(os, profile_view{mon->profile(), &m.main_memory()}, output_format::plain);
+
+      const std::string text = os.str();
+
+      CHECK(text.find("Retired instructions: 11") != std::string::npos);
+      CHECK(text.find("0006-000a  3 x 3") != std::string::npos);
+      CHECK(text.find("taken 2, not taken 1") != std::string::npos);
+      CHECK(text.find("0200  loads 0, stores 3") != std::string::npos);
+      CHECK(text.find("0006-000a") < text.find("0000-0004"));
+    }
+
+    WHEN("a load is executed")
+    {
+      m.set_registers({});
+      m.main_memory().store(0x0000, assemble<opcode::move>(ip, immediate));
+      m.main_memory().store(0x0002, 0x0100);
+      m.main_memory().store(0x0104, assemble<opcode::halt>());
+
+      CHECK(m.execute(100).first);
+
+      THEN("it shall be counted for its page")
+      {
+        CHECK(mon->profile()->loads(0x0300) == 1);
+        CHECK(mon->profile()->instructions(0x0100) == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("collect opcode statistics", "[monitor]")
+{
+  GIVEN("a machine with a monitor collecting statistics")
+  {
+    const auto mon = std::make_shared<execution_monitor>();
+    mon->enable_statistics();
+
+    machine m;
+    m.set_monitor(mon);
+    store_program(m.main_memory());
+
+    CHECK(m.execute(100).first);
+
+    const execution_statistics& stats = *mon->statistics();
+
+    THEN("the instructions shall be counted per opcode")
+    {
+      CHECK(stats.total() == 11);
+      CHECK(stats.retired(opcode::move) == 2);
+      CHECK(stats.retired(opcode::store) == 3);
+      CHECK(stats.retired(opcode::add) == 3);
+      CHECK(stats.retired(opcode::cond_jump) == 3);
+      CHECK(stats.retired(opcode::load) == 0);
+    }
+
+    THEN("the instructions shall be counted per operand form")
+    {
+      CHECK(stats.retired(opcode::move, operand_form::short_immediate) == 1);
+      CHECK(stats.retired(opcode::move, operand_form::long_immediate) == 1);
+      CHECK(stats.retired(opcode::store, operand_form::register_operand) == 3);
+      CHECK(stats.retired(opcode::add, operand_form::short_immediate) == 3);
+      CHECK(stats.retired(opcode::cond_jump, operand_form::short_immediate) == 3);
+      CHECK(stats.retired(operand_form::long_immediate) == 1);
+    }
+
+    THEN("the conditional jumps shall be counted with the taken ones")
+    {
+      CHECK(stats.branches() == 3);
+      CHECK(stats.taken() == 2);
+    }
+
+    THEN("the report shall contain the counts")
+    {
+      std::ostringstream os;
+      output(os, stats, output_format::plain);
+
+      const std::string text = os.str();
+
+      CHECK(text.find("Retired instructions: 11") != std::string::npos);
+      CHECK(text.find("Conditional jumps: 3, taken 2") != std::string::npos);
+    }
+
+    WHEN("the statistics are enabled again")
+    {
+      mon->enable_statistics();
+
+      THEN("they shall be cleared")
+      {
+        CHECK(mon->statistics()->total() == 0);
+        CHECK(mon->statistics()->branches() == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("record the code coverage", "[monitor]")
+{
+  GIVEN("a machine with a monitor recording the coverage")
+  {
+    const auto mon = std::make_shared<execution_monitor>();
+    mon->enable_coverage();
+
+    machine m;
+    m.set_monitor(mon);
+    store_program(m.main_memory());
+
+    // Never executed
+    m.main_memory().store(0x000e, assemble<opcode::cond_jump>(jz, short_cond_jump_address{0x0000}));
+
+    CHECK(m.execute(100).first);
+
+    const execution_coverage& coverage = *mon->coverage();
+
+    THEN("the retired instructions shall be covered")
+    {
+      CHECK(coverage.count() == 5);
+      CHECK(coverage.covered(0x0000));
+      CHECK(coverage.covered(0x0002));
+      CHECK_FALSE(coverage.covered(0x0004));
+      CHECK(coverage.covered(0x0006));
+      CHECK(coverage.covered(0x000a));
+      CHECK_FALSE(coverage.covered(0x000c));
+      CHECK_FALSE(coverage.covered(0x000e));
+    }
+
+    THEN("both directions of the conditional jump shall be covered")
+    {
+      CHECK(coverage.taken(0x000a));
+      CHECK(coverage.not_taken(0x000a));
+      CHECK_FALSE(coverage.taken(0x0008));
+      CHECK_FALSE(coverage.not_taken(0x0008));
+    }
+
+    THEN("the CSV export shall have a row per instruction of the image")
+    {
+      std::ostringstream os;
+      output(os, coverage_view{&coverage, &m.main_memory(), 0x0010, coverage_format::csv}, output_format::plain);
+
+      const std::string text = os.str();
+
+      CHECK(std::count(text.begin(), text.end(), '\n') == 8);
+      CHECK(text.find("address,covered,taken,not_taken,instruction\n") == 0);
+      CHECK(text.find("0004,") == std::string::npos);
+      CHECK(text.find("000a,1,1,1,") != std::string::npos);
+      CHECK(text.find("000e,0,0,0,") != std::string::npos);
+    }
+
+    THEN("the lcov export shall have a line per instruction and two branches per conditional jump")
+    {
+      std::ostringstream os;
+      output(
+        os,
+        coverage_view{&coverage, &m.main_memory(), 0x0010, coverage_format::lcov, "program.bin"},
+        output_format::plain);
+
+      const std::string text = os.str();
+
+      CHECK(text.find("TN:\nSF:program.bin\n") == 0);
+      CHECK(text.find("DA:1,1\n") != std::string::npos);
+      CHECK(text.find("DA:3,") == std::string::npos);
+      CHECK(text.find("DA:8,0\n") != std::string::npos);
+      CHECK(text.find("BRDA:6,0,0,1\nBRDA:6,0,1,1\n") != std::string::npos);
+      CHECK(text.find("BRDA:8,0,0,-\nBRDA:8,0,1,-\n") != std::string::npos);
+      CHECK(text.find("BRF:4\nBRH:2\nLF:7\nLH:5\nend_of_record\n") != std::string::npos);
+    }
+  }
+}
+
+SCENARIO("count the cycles of the executed instructions", "[monitor]")
+{
+  GIVEN("the cycle tables of the feature levels")
+  {
+    THEN("unsupported instructions shall take no cycles")
+    {
+      constexpr auto jump = static_cast<std::size_t>(opcode::jump);
+
+      CHECK(machine_profile<feature_level::min>::instruction_cycles[jump] == 0);
+      CHECK(machine_profile<feature_level::v1>::instruction_cycles[jump] == 2);
+      CHECK(machine_profile<feature_level::v1>::instruction_cycles[0] == 0);
+    }
+  }
+
+  GIVEN("a machine with a monitor counting the cycles")
+  {
+    const auto mon = std::make_shared<execution_monitor>();
+    mon->enable_cycles(feature_level_latest);
+
+    machine m;
+    m.set_monitor(mon);
+    store_program(m.main_memory());
+
+    const auto [halted, steps] = m.execute(100);
+
+    CHECK(halted);
+
+    THEN("long immediate constants and memory accesses shall take additional cycles")
+    {
+      const cycle_counter& counter = *mon->cycles();
+
+      // MOV 2, MOV with long immediate 3, and three times STR 3, ADD 2, and J 2
+      CHECK(counter.steps() == steps);
+      CHECK(counter.cycles() == 26);
+      CHECK(counter.cpi() > 2.36);
+      CHECK(counter.cpi() < 2.37);
+      CHECK(counter.runtime(26.0) == 1.0);
+    }
+
+    THEN("the output shall contain the counts")
+    {
+      std::ostringstream os;
+      output(os, *mon->cycles(), output_format::plain);
+
+      CHECK(os.str() == "Steps: 11, cycles: 26, cycles per instruction: 2.36\n");
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/utils/screen.hpp>
+
+#include <string>
+
+SCENARIO("render frames incrementally", "[screen]")
+{
+  using yarisc::utils::screen;
+
+  GIVEN("a screen")
+  {
+    screen scr;
+
+    THEN("the first frame shall be drawn to a cleared terminal")
+    {
+      std::string out;
+      scr.render("ab\ncd\n", out);
+
+      CHECK(out == "\033[H\033[2Jab\033[2;1Hcd\033[3;1H");
+    }
+
+    WHEN("a frame has been drawn")
+    {
+      std::string out;
+      scr.render("r0 0000  r1 0000\nmessage\n", out);
+
+      THEN("an equal frame shall only move the cursor to the end")
+      {
+        out.clear();
+        scr.render("r0 0000  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[3;1H");
+      }
+
+      THEN("only the changed cells shall be drawn")
+      {
+        out.clear();
+        scr.render("r0 0001  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[1;7H1\033[3;1H");
+      }
+
+      THEN("close changes shall rewrite the unchanged cells in between")
+      {
+        out.clear();
+        scr.render("r0 1001  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[1;4H1001\033[3;1H");
+      }
+
+      THEN("shorter lines and fewer lines shall be erased")
+      {
+        out.clear();
+        scr.render("r0 0000\n", out);
+
+        CHECK(out == "\033[1;8H\033[K\033[2;1H\033[K");
+      }
+
+      THEN("colored cells shall be drawn with their color and the color shall be reset at the end")
+      {
+        out.clear();
+        scr.render("r0 \033[31m0001\033[0m  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[1;4H\033[31m0001\033[0m\033[3;1H");
+
+        AND_THEN("a color change alone shall redraw the cells")
+        {
+          out.clear();
+          scr.render("r0 0001  r1 0000\nmessage\n", out);
+
+          CHECK(out == "\033[1;4H0001\033[3;1H");
+        }
+      }
+
+      THEN("redundant color sequences shall be dropped")
+      {
+        out.clear();
+        scr.render("r0 \033[97m\033[37m0001\033[0m  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[1;4H\033[37m0001\033[0m\033[3;1H");
+      }
+
+      THEN("only the colors that change shall be output")
+      {
+        out.clear();
+        scr.render("r0 \033[43m\033[97m00\033[49m01\033[0m  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[1;4H\033[97;43m00\033[49m01\033[0m\033[3;1H");
+      }
+
+      THEN("extended colors and other attributes shall be ignored")
+      {
+        out.clear();
+        scr.render("r0 \033[1;38;5;31;4m0000\033[0m  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[3;1H");
+      }
+
+      THEN("an invalidated screen shall be cleared and drawn completely")
+      {
+        scr.invalidate();
+
+        out.clear();
+        scr.render("r0 0000  r1 0000\nmessage\n", out);
+
+        CHECK(out == "\033[H\033[2Jr0 0000  r1 0000\033[2;1Hmessage\033[3;1H");
+      }
+    }
+  }
+}
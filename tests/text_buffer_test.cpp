@@ -0,0 +1,102 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/output.hpp>
+#include <yarisc/utils/text_buffer.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+SCENARIO("format text into a buffer", "[text_buffer]")
+{
+  using namespace yarisc::utils;
+
+  GIVEN("a text buffer")
+  {
+    std::string str{"> "};
+    text_buffer buf{str};
+
+    THEN("text shall be appended to the string")
+    {
+      buf << "abc" << ' ' << std::string{"def"};
+
+      CHECK(str == "> abc def");
+    }
+
+    THEN("hexadecimal numbers shall be filled with leading zeros")
+    {
+      append_hex(buf, std::uint16_t{0x0000}) << ' ';
+      append_hex(buf, std::uint16_t{0x00af}) << ' ';
+      append_hex(buf, std::uint16_t{0xbeef}) << ' ';
+      append_hex(buf, std::uint8_t{0x7}) << ' ';
+      append_hex(buf, std::uint32_t{0x12345}, 0) << ' ';
+      append_hex(buf, std::uint16_t{0x10f}, 1) << ' ';
+      append_hex(buf, std::uint16_t{0x5}, 6);
+
+      CHECK(str == "> 0000 00af beef 07 12345 10f 000005");
+    }
+
+    THEN("decimal numbers shall be formatted without padding")
+    {
+      append_decimal(buf, 0) << ' ';
+      append_decimal(buf, -42) << ' ';
+      append_decimal(buf, std::uint64_t{18446744073709551615u});
+
+      CHECK(str == "> 0 -42 18446744073709551615");
+    }
+  }
+}
+
+SCENARIO("output to a stream formats into a string first", "[text_buffer]")
+{
+  using namespace yarisc::arch;
+
+  GIVEN("registers and memory")
+  {
+    machine_registers reg{};
+    reg.named.r[0] = 0x1234;
+    reg.named.set_ip(0x0010);
+
+    std::array<std::byte, 32> data{};
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<std::byte>(i + 60);
+
+    const registers_view regs{reg};
+    const memory_view mem{data.data(), data.size(), 0x0100};
+
+    THEN("the output to a string and to a stream shall be equal")
+    {
+      for (const output_format fmt : {output_format::plain, output_format::colored})
+      {
+        std::string str;
+        output_to(str, regs, fmt);
+        output_to(str, as_diff(mem, mem), fmt);
+
+        std::ostringstream os;
+        output(os, regs, fmt);
+        output(os, as_diff(mem, mem), fmt);
+
+        CHECK(os.str() == str);
+      }
+    }
+
+    THEN("the output shall be appended to the string")
+    {
+      std::string str{"Memory:\n"};
+      output_to(str, mem, output_format::plain);
+
+      CHECK(str == "Memory:\n"
+                   "0x0100: 3c 3d  3e 3f  40 41  42 43  44 45  46 47  48 49  4a 4b  <=>?@ABCDEFGHIJK\n"
+                   "0x0110: 4c 4d  4e 4f  50 51  52 53  54 55  56 57  58 59  5a 5b  LMNOPQRSTUVWXYZ[\n");
+    }
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/aot.hpp>
+
+#include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace yarisc::arch
+{
+  namespace
+  {
+    /**
+     * @brief Cache policy of the reference interpreter, which disables the blocks overwritten by its stores
+     */
+    struct aot_cache_policy final
+    {
+      static constexpr bool enabled = true;
+
+      aot_runtime* runtime_;
+
+      inline void invalidate(address_t address) noexcept
+      {
+        runtime_->invalidate(address);
+      }
+    };
+
+  } // namespace
+
+  aot_runtime::aot_runtime(const aot_program& program)
+    : program_{program}
+    , table_{std::make_unique<std::uint32_t[]>(detail::aot_num_words)}
+    , code_{std::make_unique<std::uint64_t[]>(detail::aot_num_words / 64)}
+  {
+    reset();
+  }
+
+  std::pair<bool, std::uint64_t> aot_runtime::execute(detail::machine_data& data, std::uint64_t steps)
+  {
+    switch (program_.level)
+    {
+    case feature_level::min:
+      return run<machine_profile<feature_level::min>>(data, steps);
+    case feature_level::v1:
+      return run<machine_profile<feature_level::v1>>(data, steps);
+    default:
+      throw std::runtime_error{
+        "Invalid feature level " + std::to_string(static_cast<std::underlying_type_t<feature_level>>(program_.level))};
+    }
+  }
+
+  void aot_runtime::reset() noexcept
+  {
+    std::fill_n(table_.get(), detail::aot_num_words, npos);
+    std::fill_n(code_.get(), detail::aot_num_words / 64, 0);
+
+    for (std::uint32_t i = 0; i < program_.blocks.size(); ++i)
+    {
+      const aot_block& b = program_.blocks[i];
+
+      table_[b.entry / sizeof(word_t)] = i;
+
+      for (std::uint32_t off = 0; off < b.length; off += sizeof(word_t))
+      {
+        const std::size_t word = ((b.entry + off) / sizeof(word_t)) % detail::aot_num_words;
+
+        code_[word / 64] |= std::uint64_t{1} << (word % 64);
+      }
+    }
+  }
+
+  void aot_runtime::invalidate(address_t address) noexcept
+  {
+    if (!detail::aot_covered(code_.get(), address)) [[likely]]
+      return;
+
+    // Stores are rare to hit code, so the blocks and the bitmap are simply rebuilt from the enabled blocks
+    const std::size_t first = address / sizeof(word_t);
+    const std::size_t last = (detail::is_aligned(address) ? first : first + 1) % detail::aot_num_words;
+
+    std::fill_n(code_.get(), detail::aot_num_words / 64, 0);
+
+    for (std::uint32_t i = 0; i < program_.blocks.size(); ++i)
+    {
+      const aot_block& b = program_.blocks[i];
+      std::uint32_t& index = table_[b.entry / sizeof(word_t)];
+
+      if (index != i)
+        continue;
+
+      bool overwritten = false;
+
+      for (std::uint32_t off = 0; off < b.length; off += sizeof(word_t))
+      {
+        const std::size_t word = ((b.entry + off) / sizeof(word_t)) % detail::aot_num_words;
+
+        overwritten = overwritten || (word == first) || (word == last);
+      }
+
+      if (overwritten)
+      {
+        index = npos;
+        continue;
+      }
+
+      for (std::uint32_t off = 0; off < b.length; off += sizeof(word_t))
+      {
+        const std::size_t word = ((b.entry + off) / sizeof(word_t)) % detail::aot_num_words;
+
+        code_[word / 64] |= std::uint64_t{1} << (word % 64);
+      }
+    }
+  }
+
+  template <typename Profile>
+  std::pair<bool, std::uint64_t> aot_runtime::run(detail::machine_data& data, std::uint64_t steps)
+  {
+    auto policy = detail::make_execution_policy<Profile>(
+      detail::noop_debug_execution_policy{}, detail::noop_strict_execution_policy{}, aot_cache_policy{this});
+
+    machine_registers& reg = data.state.reg;
+
+    aot_context ctx{reg, data.mem.main, code_.get()};
+    ctx.limit = steps;
+
+    while (ctx.steps < steps)
+    {
+      const auto ip = static_cast<address_t>(reg.named.ip());
+
+      if (detail::is_aligned(ip)) [[likely]]
+      {
+        const std::uint32_t index = table_[ip / sizeof(word_t)];
+
+        if ((index != npos) && (program_.blocks[index].size <= steps - ctx.steps)) [[likely]]
+        {
+          switch (program_.blocks[index].function(ctx))
+          {
+          case aot_exit::next:
+            continue;
+          case aot_exit::halt:
+            return {true, ctx.steps};
+          case aot_exit::code_modified:
+            invalidate(ctx.modified);
+            continue;
+          }
+        }
+      }
+
+      // Without a debugger the interpreter only stops at a halt instruction, panics are thrown
+      if (!detail::execute_instruction(policy, reg, data.mem).keep_going)
+        return {true, ctx.steps};
+
+      ++ctx.steps;
+    }
+
+    return {false, ctx.steps};
+  }
+
+} // namespace yarisc::arch
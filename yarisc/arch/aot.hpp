@@ -0,0 +1,250 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_AOT_HPP
+#define YARISC_ARCH_AOT_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/registers.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Reason why a translated block returned
+   */
+  enum class aot_exit : std::uint8_t
+  {
+    /**
+     * @brief The instruction pointer has been set to the next instruction
+     */
+    next = 0,
+
+    /**
+     * @brief A halt instruction has been executed, which has not been counted as a step
+     */
+    halt = 1,
+
+    /**
+     * @brief A store has written a word covered by a translated block
+     */
+    code_modified = 2,
+  };
+
+  /**
+   * @brief State passed to the translated blocks
+   */
+  struct aot_context final
+  {
+    machine_registers& reg;
+    memory& mem;
+
+    /**
+     * @brief Bitmap of the words covered by translated blocks which are still valid
+     */
+    const std::uint64_t* code;
+
+    /**
+     * @brief Number of executed steps, which the translated blocks increase before they return
+     */
+    std::uint64_t steps{0};
+
+    /**
+     * @brief Maximum number of steps, blocks only loop back to themselves while the limit covers another iteration
+     */
+    std::uint64_t limit{std::numeric_limits<std::uint64_t>::max()};
+
+    /**
+     * @brief Address of the store that returned `aot_exit::code_modified`
+     */
+    address_t modified{0};
+  };
+
+  /**
+   * @brief Translated block
+   *
+   * It is only called if the remaining steps cover all instructions of the block. On return the registers and the
+   * steps in the context are up to date.
+   */
+  using aot_function = aot_exit (*)(aot_context& ctx);
+
+  struct aot_block final
+  {
+    /**
+     * @brief Byte address of the first instruction
+     */
+    address_t entry{0};
+
+    /**
+     * @brief Number of bytes covered by the instructions of the block including long immediate constants
+     */
+    std::uint32_t length{0};
+
+    /**
+     * @brief Number of instructions
+     */
+    std::uint32_t size{0};
+
+    aot_function function{nullptr};
+  };
+
+  /**
+   * @brief Image translated ahead of time by `yarisc-aot`
+   */
+  struct aot_program final
+  {
+    /**
+     * @brief Feature level the image has been decoded for
+     */
+    feature_level level{feature_level_latest};
+
+    /**
+     * @brief Translated blocks sorted by entry address
+     */
+    std::span<const aot_block> blocks{};
+  };
+
+  namespace detail
+  {
+    inline constexpr std::size_t aot_num_words =
+      (static_cast<std::size_t>(std::numeric_limits<address_t>::max()) + 1) / sizeof(word_t);
+
+    /**
+     * @brief Updates the zero flag for a translated move or load
+     *
+     * @param s status register
+     * @param value value written to the destination register
+     * @return the new status register
+     */
+    [[nodiscard]] inline constexpr word_t aot_zero(word_t s, word_t value) noexcept
+    {
+      return (s & ~status_register::zero_flag) | ((value == 0x0) ? status_register::zero_flag : 0x0);
+    }
+
+    /**
+     * @brief Adds for a translated addition
+     *
+     * @param dst destination register
+     * @param op1 first operand
+     * @param op2 second operand
+     * @param carry incoming carry, which is zero or one
+     * @return the new status register
+     */
+    [[nodiscard]] inline constexpr word_t aot_add(word_t& dst, word_t op1, word_t op2, word_t carry) noexcept
+    {
+      static_assert(status_register::carry_flag == 0x1);
+
+      const auto result = static_cast<double_word_t>(double_word_t{op1} + op2 + carry);
+      dst = static_cast<word_t>(result);
+
+      return ((dst == 0x0) ? status_register::zero_flag : 0x0) | static_cast<word_t>(result >> (8 * sizeof(word_t)));
+    }
+
+    /**
+     * @brief Returns whether a store to the given address writes a word covered by a translated block
+     *
+     * @param code bitmap of the covered words
+     * @param address byte address of the store
+     */
+    [[nodiscard]] inline bool aot_covered(const std::uint64_t* code, address_t address) noexcept
+    {
+      const auto test = [code](std::size_t word) { return ((code[word / 64] >> (word % 64)) & 0x1) != 0; };
+
+      const std::size_t word = address / sizeof(word_t);
+
+      // Unaligned stores also write the first byte of the next word
+      if (!is_aligned(address))
+        return test(word) || test((word + 1) % aot_num_words);
+
+      return test(word);
+    }
+
+  } // namespace detail
+
+  /**
+   * @brief Executes a translated image on machine data
+   *
+   * The translated blocks are entered through a dispatch table indexed by the instruction pointer, which also covers
+   * indirect jumps to block entries. Addresses without a translated block are executed by the reference interpreter
+   * one instruction at a time, which raises the same panics as a machine in normal mode without a debugger.
+   *
+   * A store to a word covered by a block disables all blocks covering the word, so modified code is interpreted. The
+   * dispatch table is shared by all runs, therefore `reset()` has to be called before running a freshly loaded image
+   * after code has been modified.
+   */
+  class aot_runtime final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param program translated image, which must outlive the runtime
+     */
+    YARISC_ARCH_EXPORT explicit aot_runtime(const aot_program& program);
+
+    /**
+     * @brief Executes a given number of steps
+     *
+     * The instruction that halts is not counted as a step.
+     *
+     * @param data registers and memory of the machine
+     * @param steps maximum number of steps to execute
+     * @return a boolean whether the machine was halted and the number of executed steps
+     */
+    YARISC_ARCH_EXPORT std::pair<bool, std::uint64_t> execute(
+      detail::machine_data& data, std::uint64_t steps = std::numeric_limits<std::uint64_t>::max());
+
+    /**
+     * @brief Enables all translated blocks again
+     */
+    YARISC_ARCH_EXPORT void reset() noexcept;
+
+    /**
+     * @brief Disables all blocks covering the word written by a store
+     *
+     * @param address byte address of the store
+     */
+    YARISC_ARCH_EXPORT void invalidate(address_t address) noexcept;
+
+    /**
+     * @brief Returns the translated image
+     */
+    [[nodiscard]] const aot_program& program() const noexcept
+    {
+      return program_;
+    }
+
+  private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    aot_program program_;
+
+    /**
+     * @brief Index of the enabled block per word address or `npos`
+     */
+    std::unique_ptr<std::uint32_t[]> table_;
+
+    /**
+     * @brief Bitmap of the words covered by enabled blocks
+     */
+    std::unique_ptr<std::uint64_t[]> code_;
+
+    template <typename Profile>
+    [[nodiscard]] std::pair<bool, std::uint64_t> run(detail::machine_data& data, std::uint64_t steps);
+  };
+
+} // namespace yarisc::arch
+
+#endif
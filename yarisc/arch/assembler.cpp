@@ -0,0 +1,1056 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/assembler.hpp>
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/detail/endianness.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace yarisc::arch
+{
+  namespace
+  {
+    using assembly::regaddr;
+
+    inline constexpr std::uint8_t char_space = 0x1;
+    inline constexpr std::uint8_t char_digit = 0x2;
+    inline constexpr std::uint8_t char_identifier = 0x4;
+
+    [[nodiscard]] consteval std::array<std::uint8_t, 256> make_char_classes() noexcept
+    {
+      std::array<std::uint8_t, 256> classes{};
+
+      classes[' '] = char_space;
+      classes['\t'] = char_space;
+      classes['\r'] = char_space;
+      classes['\v'] = char_space;
+      classes['\f'] = char_space;
+
+      for (unsigned char c = '0'; c <= '9'; ++c)
+        classes[c] = char_digit | char_identifier;
+
+      for (unsigned char c = 'a'; c <= 'z'; ++c)
+        classes[c] = char_identifier;
+
+      for (unsigned char c = 'A'; c <= 'Z'; ++c)
+        classes[c] = char_identifier;
+
+      classes['_'] = char_identifier;
+      classes['.'] = char_identifier;
+
+      return classes;
+    }
+
+    /**
+     * @brief Character classes of the lexer, identifiers can contain digits but not start with one
+     */
+    inline constexpr std::array<std::uint8_t, 256> char_classes = make_char_classes();
+
+    [[nodiscard]] std::uint8_t char_class(char c) noexcept
+    {
+      return char_classes[static_cast<unsigned char>(c)];
+    }
+
+    [[nodiscard]] char to_upper(char c) noexcept
+    {
+      return ((c >= 'a') && (c <= 'z')) ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    [[nodiscard]] bool equals_upper(std::string_view str, std::string_view upper) noexcept
+    {
+      if (str.size() != upper.size())
+        return false;
+
+      for (std::size_t i = 0; i < str.size(); ++i)
+      {
+        if (to_upper(str[i]) != upper[i])
+          return false;
+      }
+
+      return true;
+    }
+
+    [[nodiscard]] consteval std::size_t count_mnemonics() noexcept
+    {
+      std::size_t count = 0;
+
+      for (const detail::instruction_descriptor& desc : detail::instruction_table)
+      {
+        if (!desc.mnemonic.empty())
+          ++count;
+      }
+
+      return count;
+    }
+
+    /**
+     * @brief Opcodes of all instructions that have a mnemonic
+     */
+    inline constexpr std::array<std::uint8_t, count_mnemonics()> mnemonic_opcodes = []() {
+      std::array<std::uint8_t, count_mnemonics()> codes{};
+      std::size_t i = 0;
+
+      for (std::size_t code = 0; code < detail::instruction_table.size(); ++code)
+      {
+        if (!detail::instruction_table[code].mnemonic.empty())
+          codes[i++] = static_cast<std::uint8_t>(code);
+      }
+
+      return codes;
+    }();
+
+    /**
+     * @brief Returns the register with the given case-insensitive name
+     */
+    [[nodiscard]] std::optional<regaddr> find_register(std::string_view name) noexcept
+    {
+      static_assert(num_registers == 8);
+
+      if (name.size() != 2)
+        return std::nullopt;
+
+      const char first = to_upper(name[0]);
+      const char second = to_upper(name[1]);
+
+      if ((first == 'R') && (second >= '0') && (second <= '5'))
+        return static_cast<regaddr>(second - '0');
+      if ((first == 'S') && (second == 'P'))
+        return regaddr::sp;
+      if ((first == 'I') && (second == 'P'))
+        return regaddr::ip;
+
+      return std::nullopt;
+    }
+
+    /**
+     * @brief Parses the condition suffix of a conditional jump, e.g. "NZ" of "JNZ"
+     *
+     * @param suffix the negation flag `M` or `N` followed by the status flags
+     * @return condition bits of the instruction word
+     */
+    [[nodiscard]] std::optional<word_t> parse_condition(std::string_view suffix) noexcept
+    {
+      if (suffix.size() < 2)
+        return std::nullopt;
+
+      word_t cond = 0;
+
+      switch (to_upper(suffix[0]))
+      {
+      case 'M':
+        break;
+      case 'N':
+        cond |= operand_cond_neg_mask;
+        break;
+      default:
+        return std::nullopt;
+      }
+
+      for (const char c : suffix.substr(1))
+      {
+        const char flag = to_upper(c);
+        const word_t mask = (flag == 'C') ? operand_cond_flag_carry_mask
+                                          : ((flag == 'Z') ? operand_cond_flag_zero_mask : word_t{0});
+
+        if ((mask == 0) || (cond & mask))
+          return std::nullopt;
+
+        cond |= mask;
+      }
+
+      return cond;
+    }
+
+    enum class token_kind : std::uint8_t
+    {
+      end,
+      newline,
+      identifier,
+      number,
+      comma,
+      colon,
+      equal,
+      plus,
+      minus,
+    };
+
+    struct token final
+    {
+      token_kind kind{token_kind::end};
+      std::string_view text{};
+      word_t value{0};
+      std::uint32_t line{1};
+      std::uint32_t column{1};
+
+      /**
+       * @brief FNV-1a hash of identifiers
+       */
+      std::uint32_t hash{0};
+    };
+
+    /**
+     * @brief Location in the source for error messages
+     */
+    struct location final
+    {
+      std::uint32_t line{1};
+      std::uint32_t column{1};
+    };
+
+    [[noreturn]] void throw_error(const assembler_options& options, location loc, const std::string& msg)
+    {
+      throw std::invalid_argument{
+        options.name + ":" + std::to_string(loc.line) + ":" + std::to_string(loc.column) + ": " + msg};
+    }
+
+    /**
+     * @brief Splits the source into tokens in a single scan
+     */
+    class lexer final
+    {
+    public:
+      lexer(std::string_view source, const assembler_options& options) noexcept
+        : pos_{source.data()}
+        , end_{source.data() + source.size()}
+        , line_begin_{source.data()}
+        , options_{options}
+      {
+      }
+
+      [[nodiscard]] token next()
+      {
+        skip_space();
+
+        token tok;
+        tok.line = line_;
+        tok.column = static_cast<std::uint32_t>(pos_ - line_begin_) + 1;
+
+        if (pos_ == end_)
+          return tok;
+
+        const char* const begin = pos_;
+        const std::uint8_t cls = char_class(*pos_);
+
+        if (cls & char_digit)
+        {
+          tok.kind = token_kind::number;
+          tok.value = number(tok);
+        }
+        else if (cls & char_identifier)
+        {
+          std::uint32_t hash = 2166136261u;
+
+          while ((pos_ != end_) && (char_class(*pos_) & char_identifier))
+            hash = (hash ^ static_cast<unsigned char>(*pos_++)) * 16777619u;
+
+          tok.kind = token_kind::identifier;
+          tok.hash = hash;
+        }
+        else
+        {
+          switch (*pos_++)
+          {
+          case '\n':
+            tok.kind = token_kind::newline;
+            ++line_;
+            line_begin_ = pos_;
+            break;
+          case ',':
+            tok.kind = token_kind::comma;
+            break;
+          case ':':
+            tok.kind = token_kind::colon;
+            break;
+          case '=':
+            tok.kind = token_kind::equal;
+            break;
+          case '+':
+            tok.kind = token_kind::plus;
+            break;
+          case '-':
+            tok.kind = token_kind::minus;
+            break;
+          default:
+            throw_error(options_, {tok.line, tok.column}, "unexpected character '" + std::string{begin, 1} + "'");
+          }
+        }
+
+        tok.text = std::string_view{begin, static_cast<std::size_t>(pos_ - begin)};
+
+        return tok;
+      }
+
+    private:
+      const char* pos_;
+      const char* end_;
+      const char* line_begin_;
+      std::uint32_t line_{1};
+      const assembler_options& options_;
+
+      void skip_space() noexcept
+      {
+        for (;;)
+        {
+          while ((pos_ != end_) && (char_class(*pos_) & char_space))
+            ++pos_;
+
+          if ((pos_ == end_) || (*pos_ != ';'))
+            return;
+
+          // Comments run until the end of the line, which is still a token
+          while ((pos_ != end_) && (*pos_ != '\n'))
+            ++pos_;
+        }
+      }
+
+      [[nodiscard]] word_t number(const token& tok)
+      {
+        int base = 10;
+
+        if ((end_ - pos_ > 2) && (pos_[0] == '0'))
+        {
+          if ((pos_[1] == 'x') || (pos_[1] == 'X'))
+            base = 16;
+          else if ((pos_[1] == 'b') || (pos_[1] == 'B'))
+            base = 2;
+
+          if (base != 10)
+            pos_ += 2;
+        }
+
+        word_t value = 0;
+        const auto [ptr, ec] = std::from_chars(pos_, end_, value, base);
+
+        if (ec == std::errc::result_out_of_range)
+          throw_error(options_, {tok.line, tok.column}, "number exceeds a word");
+        if ((ec != std::errc{}) || ((ptr != end_) && (char_class(*ptr) & char_identifier)))
+          throw_error(options_, {tok.line, tok.column}, "invalid number");
+
+        pos_ = ptr;
+
+        return value;
+      }
+    };
+
+    /**
+     * @brief How the operands of a statement are encoded
+     */
+    enum class encoding : std::uint8_t
+    {
+      data,
+      basic,
+      reg,
+      reg_reg,
+      reg_imm,
+      reg_reg_reg,
+      reg_imm_reg,
+      reg_reg_imm,
+      jump,
+      cond_jump,
+    };
+
+    inline constexpr std::uint32_t no_symbol = std::numeric_limits<std::uint32_t>::max();
+    inline constexpr std::uint32_t no_expression = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * @brief Statement that emits words, whose address and size are fixed by the first pass
+     */
+    struct statement final
+    {
+      address_t address{0};
+      encoding enc{encoding::data};
+
+      /**
+       * @brief Whether the immediate constant is stored in the next word
+       */
+      bool long_form{false};
+
+      /**
+       * @brief Opcode and condition bits of the instruction word
+       */
+      word_t code{0};
+
+      std::array<regaddr, 3> regs{};
+
+      /**
+       * @brief Index of the expression of the immediate constant or data word
+       */
+      std::uint32_t expr{no_expression};
+    };
+
+    /**
+     * @brief Number or symbol of an expression
+     */
+    struct term final
+    {
+      std::uint32_t symbol{no_symbol};
+      word_t value{0};
+      bool negate{false};
+    };
+
+    /**
+     * @brief Sum of consecutive terms
+     */
+    struct expression final
+    {
+      std::uint32_t first{0};
+      std::uint32_t count{0};
+      location loc{};
+    };
+
+    struct symbol final
+    {
+      std::string_view name{};
+      std::uint32_t hash{0};
+      word_t value{0};
+      bool defined{false};
+    };
+
+    /**
+     * @brief Interns the symbol names by open addressing with the hash computed by the lexer
+     *
+     * The names point into the source. Expressions refer to the symbols by index, so the second pass does not look up
+     * any names.
+     */
+    class symbol_table final
+    {
+    public:
+      explicit symbol_table(std::size_t capacity)
+        : slots_(std::bit_ceil(std::max<std::size_t>(2 * capacity, 64)), 0)
+      {
+        symbols_.reserve(capacity);
+      }
+
+      [[nodiscard]] symbol& operator[](std::uint32_t id) noexcept
+      {
+        return symbols_[id];
+      }
+
+      [[nodiscard]] const symbol& operator[](std::uint32_t id) const noexcept
+      {
+        return symbols_[id];
+      }
+
+      /**
+       * @brief Returns the index of the symbol with the given name, which is added if it is new
+       */
+      [[nodiscard]] std::uint32_t intern(std::string_view name, std::uint32_t hash)
+      {
+        const std::size_t mask = slots_.size() - 1;
+
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+          const std::uint32_t slot = slots_[i];
+
+          if (slot == 0)
+          {
+            const auto id = static_cast<std::uint32_t>(symbols_.size());
+            symbols_.push_back({name, hash});
+            slots_[i] = id + 1;
+
+            // Keep the load factor below one half
+            if (2 * symbols_.size() > slots_.size())
+              rehash();
+
+            return id;
+          }
+
+          const symbol& sym = symbols_[slot - 1];
+
+          if ((sym.hash == hash) && (sym.name == name))
+            return slot - 1;
+        }
+      }
+
+    private:
+      /**
+       * @brief Index plus one of the symbol in each slot, zero if the slot is empty
+       */
+      std::vector<std::uint32_t> slots_;
+      std::vector<symbol> symbols_{};
+
+      void rehash()
+      {
+        slots_.assign(2 * slots_.size(), 0);
+
+        const std::size_t mask = slots_.size() - 1;
+
+        for (std::uint32_t id = 0; id < symbols_.size(); ++id)
+        {
+          std::size_t i = symbols_[id].hash & mask;
+
+          while (slots_[i] != 0)
+            i = (i + 1) & mask;
+
+          slots_[i] = id + 1;
+        }
+      }
+    };
+
+    /**
+     * @brief Parser of the first pass, which keeps the statements and expressions for the second pass
+     */
+    class assembler final
+    {
+    public:
+      assembler(std::string_view source, const assembler_options& options)
+        : lexer_{source, options}
+        , options_{options}
+        , symbols_{source.size() / 32}
+      {
+        // Rough guesses from the size of the source to avoid reallocations with large sources
+        statements_.reserve(source.size() / 16);
+        expressions_.reserve(source.size() / 32);
+        terms_.reserve(source.size() / 32);
+      }
+
+      [[nodiscard]] std::vector<std::byte> assemble()
+      {
+        tok_ = lexer_.next();
+        next_ = lexer_.next();
+
+        while (tok_.kind != token_kind::end)
+        {
+          if (tok_.kind != token_kind::newline)
+            line();
+
+          if (tok_.kind == token_kind::newline)
+            advance();
+          else if (tok_.kind != token_kind::end)
+            fail(tok_, "unexpected " + describe(tok_));
+        }
+
+        std::vector<std::byte> image(address_);
+
+        for (const statement& stmt : statements_)
+          encode(stmt, image);
+
+        return image;
+      }
+
+    private:
+      /**
+       * @brief Number of bytes of the address space
+       */
+      static constexpr std::uint32_t address_space = std::uint32_t{std::numeric_limits<address_t>::max()} + 1;
+
+      lexer lexer_;
+      const assembler_options& options_;
+
+      token tok_{};
+      token next_{};
+
+      std::uint32_t address_{0};
+
+      symbol_table symbols_;
+
+      std::vector<statement> statements_{};
+      std::vector<expression> expressions_{};
+      std::vector<term> terms_{};
+
+      [[noreturn]] void fail(const token& tok, const std::string& msg) const
+      {
+        throw_error(options_, {tok.line, tok.column}, msg);
+      }
+
+      [[nodiscard]] static std::string describe(const token& tok)
+      {
+        switch (tok.kind)
+        {
+        case token_kind::end:
+          return "end of source";
+        case token_kind::newline:
+          return "end of line";
+        default:
+        {
+          std::string text{"'"};
+          text += tok.text;
+          text += '\'';
+
+          return text;
+        }
+        }
+      }
+
+      void advance()
+      {
+        tok_ = next_;
+
+        if (next_.kind != token_kind::end)
+          next_ = lexer_.next();
+      }
+
+      void expect(token_kind kind, std::string_view what)
+      {
+        if (tok_.kind != kind)
+          fail(tok_, "expected " + std::string{what} + " instead of " + describe(tok_));
+
+        advance();
+      }
+
+      /**
+       * @brief Parses the labels and the statement of a line
+       */
+      void line()
+      {
+        while ((tok_.kind == token_kind::identifier) && (next_.kind == token_kind::colon))
+        {
+          if (address_ >= address_space)
+            fail(tok_, "label exceeds the address space");
+
+          define(tok_, static_cast<word_t>(address_));
+          advance();
+          advance();
+        }
+
+        if (tok_.kind != token_kind::identifier)
+          return;
+
+        if (next_.kind == token_kind::equal)
+          constant();
+        else if (tok_.text.front() == '.')
+          directive();
+        else
+          instruction();
+      }
+
+      void constant()
+      {
+        const token name = tok_;
+        advance();
+        advance();
+
+        const std::uint32_t expr = parse_expression();
+        const std::optional<word_t> value = try_evaluate(expressions_[expr]);
+
+        if (!value)
+          fail(name, "constant '" + std::string{name.text} + "' refers to a symbol that is not defined before");
+
+        define(name, *value);
+      }
+
+      void directive()
+      {
+        const token name = tok_;
+        advance();
+
+        if (equals_upper(name.text, ".WORD"))
+        {
+          data_word();
+
+          while (tok_.kind == token_kind::comma)
+          {
+            advance();
+            data_word();
+          }
+        }
+        else if (equals_upper(name.text, ".ZERO"))
+        {
+          const token first = tok_;
+          const std::optional<word_t> size = try_evaluate(expressions_[parse_expression()]);
+
+          if (!size)
+            fail(first, "size refers to a symbol that is not defined before");
+          if (*size % sizeof(word_t) != 0)
+            fail(first, "size is not a multiple of the word size");
+
+          reserve(first, *size);
+        }
+        else
+        {
+          fail(name, "unknown directive '" + std::string{name.text} + "'");
+        }
+      }
+
+      void data_word()
+      {
+        statement stmt;
+        stmt.expr = parse_expression();
+
+        emit(stmt, 1);
+      }
+
+      void instruction()
+      {
+        const token name = tok_;
+        const auto [code, cond] = find_mnemonic(name);
+        const detail::instruction_descriptor& desc = detail::instruction_table[code];
+
+        if (desc.level > options_.level)
+          fail(name, "instruction '" + std::string{name.text} + "' is not supported at this feature level");
+
+        advance();
+
+        statement stmt;
+        stmt.code = static_cast<word_t>(code | cond);
+
+        switch (desc.type)
+        {
+        case optype::basic:
+          stmt.enc = encoding::basic;
+          emit(stmt, 1);
+          break;
+        case optype::op0:
+          stmt.enc = encoding::reg;
+          stmt.regs[0] = expect_register();
+          emit(stmt, 1);
+          break;
+        case optype::op0_op1:
+          two_operands(stmt);
+          break;
+        case optype::op0_op1_op2:
+          three_operands(stmt);
+          break;
+        case optype::jump:
+          stmt.enc = encoding::jump;
+          stmt.expr = parse_expression();
+          emit_immediate<assembly::short_jump_address>(stmt);
+          break;
+        case optype::cond_jump:
+          stmt.enc = encoding::cond_jump;
+          stmt.expr = parse_expression();
+          emit_immediate<assembly::short_cond_jump_address>(stmt);
+          break;
+        }
+      }
+
+      void two_operands(statement& stmt)
+      {
+        stmt.regs[0] = expect_register();
+        expect(token_kind::comma, "','");
+
+        if (const std::optional<regaddr> reg = accept_register())
+        {
+          stmt.enc = encoding::reg_reg;
+          stmt.regs[1] = *reg;
+          emit(stmt, 1);
+        }
+        else
+        {
+          stmt.enc = encoding::reg_imm;
+          stmt.expr = parse_expression();
+          emit_immediate<assembly::short_immediate>(stmt);
+        }
+      }
+
+      void three_operands(statement& stmt)
+      {
+        stmt.regs[0] = expect_register();
+        expect(token_kind::comma, "','");
+
+        const std::optional<regaddr> op1 = accept_register();
+        const std::uint32_t expr1 = op1 ? no_expression : parse_expression();
+
+        expect(token_kind::comma, "','");
+
+        const token second = tok_;
+        const std::optional<regaddr> op2 = accept_register();
+
+        if (op1 && op2)
+        {
+          stmt.enc = encoding::reg_reg_reg;
+          stmt.regs[1] = *op1;
+          stmt.regs[2] = *op2;
+          emit(stmt, 1);
+
+          return;
+        }
+
+        if (!op1 && !op2)
+          fail(second, "only one operand can be an immediate constant");
+
+        // The short form stores the constant in the instruction word and takes the first operand as the register
+        stmt.enc = op1 ? encoding::reg_reg_imm : encoding::reg_imm_reg;
+        stmt.regs[1] = op1 ? *op1 : *op2;
+        stmt.expr = op1 ? parse_expression() : expr1;
+
+        if (stmt.regs[1] == stmt.regs[0])
+          emit_immediate<assembly::short_immediate>(stmt);
+        else
+          emit_long(stmt);
+      }
+
+      /**
+       * @brief Emits an instruction with a short immediate if the value is already known and fits
+       */
+      template <typename Immediate>
+      void emit_immediate(statement& stmt)
+      {
+        const std::optional<word_t> value = try_evaluate(expressions_[stmt.expr]);
+
+        if (value && Immediate::fits(*value))
+          emit(stmt, 1);
+        else
+          emit_long(stmt);
+      }
+
+      void emit_long(statement& stmt)
+      {
+        stmt.long_form = true;
+        emit(stmt, 2);
+      }
+
+      void emit(statement stmt, std::uint32_t words)
+      {
+        stmt.address = static_cast<address_t>(address_);
+        reserve(tok_, words * sizeof(word_t));
+
+        statements_.push_back(stmt);
+      }
+
+      void reserve(const token& tok, std::uint32_t size)
+      {
+        if (address_ + size > address_space)
+          fail(tok, "code exceeds the address space");
+
+        address_ += size;
+      }
+
+      [[nodiscard]] std::pair<std::uint8_t, word_t> find_mnemonic(const token& name) const
+      {
+        for (const std::uint8_t code : mnemonic_opcodes)
+        {
+          const detail::instruction_descriptor& desc = detail::instruction_table[code];
+
+          if (desc.type == optype::cond_jump)
+          {
+            // The mnemonic is the prefix of the jump condition, e.g. "J" of "JNZ"
+            if ((name.text.size() > desc.mnemonic.size()) &&
+                equals_upper(name.text.substr(0, desc.mnemonic.size()), desc.mnemonic))
+            {
+              if (const std::optional<word_t> cond = parse_condition(name.text.substr(desc.mnemonic.size())))
+                return {code, *cond};
+            }
+          }
+          else if (equals_upper(name.text, desc.mnemonic))
+          {
+            return {code, 0};
+          }
+        }
+
+        fail(name, "unknown instruction '" + std::string{name.text} + "'");
+      }
+
+      [[nodiscard]] std::optional<regaddr> accept_register()
+      {
+        if (tok_.kind != token_kind::identifier)
+          return std::nullopt;
+
+        const std::optional<regaddr> reg = find_register(tok_.text);
+
+        if (reg)
+          advance();
+
+        return reg;
+      }
+
+      [[nodiscard]] regaddr expect_register()
+      {
+        const std::optional<regaddr> reg = accept_register();
+
+        if (!reg)
+          fail(tok_, "expected a register instead of " + describe(tok_));
+
+        return *reg;
+      }
+
+      void define(const token& name, word_t value)
+      {
+        if (find_register(name.text))
+          fail(name, "register '" + std::string{name.text} + "' cannot be a symbol");
+
+        symbol& sym = symbols_[symbols_.intern(name.text, name.hash)];
+
+        if (sym.defined)
+          fail(name, "symbol '" + std::string{name.text} + "' is already defined");
+
+        sym.value = value;
+        sym.defined = true;
+      }
+
+      /**
+       * @brief Parses a sum of numbers and symbols
+       *
+       * @return index of the expression
+       */
+      [[nodiscard]] std::uint32_t parse_expression()
+      {
+        expression expr{static_cast<std::uint32_t>(terms_.size()), 0, {tok_.line, tok_.column}};
+        bool negate = false;
+
+        if ((tok_.kind == token_kind::plus) || (tok_.kind == token_kind::minus))
+        {
+          negate = (tok_.kind == token_kind::minus);
+          advance();
+        }
+
+        for (;;)
+        {
+          if (tok_.kind == token_kind::number)
+          {
+            terms_.push_back({no_symbol, tok_.value, negate});
+          }
+          else if ((tok_.kind == token_kind::identifier) && !find_register(tok_.text))
+          {
+            terms_.push_back({symbols_.intern(tok_.text, tok_.hash), 0, negate});
+          }
+          else
+          {
+            fail(tok_, "expected a number or a symbol instead of " + describe(tok_));
+          }
+
+          ++expr.count;
+          advance();
+
+          if ((tok_.kind != token_kind::plus) && (tok_.kind != token_kind::minus))
+            break;
+
+          negate = (tok_.kind == token_kind::minus);
+          advance();
+        }
+
+        expressions_.push_back(expr);
+
+        return static_cast<std::uint32_t>(expressions_.size() - 1);
+      }
+
+      /**
+       * @brief Evaluates an expression if all of its symbols are defined
+       */
+      [[nodiscard]] std::optional<word_t> try_evaluate(const expression& expr) const noexcept
+      {
+        word_t sum = 0;
+
+        for (std::uint32_t i = expr.first; i < expr.first + expr.count; ++i)
+        {
+          const term& t = terms_[i];
+          word_t value = t.value;
+
+          if (t.symbol != no_symbol)
+          {
+            const symbol& sym = symbols_[t.symbol];
+
+            if (!sym.defined)
+              return std::nullopt;
+
+            value = sym.value;
+          }
+
+          sum = static_cast<word_t>(t.negate ? sum - value : sum + value);
+        }
+
+        return sum;
+      }
+
+      [[nodiscard]] word_t evaluate(const expression& expr) const
+      {
+        if (const std::optional<word_t> value = try_evaluate(expr))
+          return *value;
+
+        for (std::uint32_t i = expr.first; i < expr.first + expr.count; ++i)
+        {
+          const term& t = terms_[i];
+
+          if ((t.symbol != no_symbol) && !symbols_[t.symbol].defined)
+            throw_error(options_, expr.loc, "undefined symbol '" + std::string{symbols_[t.symbol].name} + "'");
+        }
+
+        assert(false);
+
+        return 0;
+      }
+
+      /**
+       * @brief Encodes a statement of the first pass into the image
+       */
+      void encode(const statement& stmt, std::vector<std::byte>& image) const
+      {
+        using assembly::accumulator;
+        using assembly::immediate;
+
+        const word_t value = (stmt.expr != no_expression) ? evaluate(expressions_[stmt.expr]) : word_t{0};
+
+        const auto [r0, r1, r2] = stmt.regs;
+        const auto short_imm = [value]() { return assembly::short_immediate::unchecked(value); };
+
+        word_t word = stmt.code;
+
+        switch (stmt.enc)
+        {
+        case encoding::data:
+          word = value;
+          break;
+        case encoding::basic:
+          break;
+        case encoding::reg:
+          word |= detail::make_operands(r0);
+          break;
+        case encoding::reg_reg:
+          word |= detail::make_operands(r0, r1);
+          break;
+        case encoding::reg_imm:
+          word |= stmt.long_form ? detail::make_operands(r0, immediate) : detail::make_operands(r0, short_imm());
+          break;
+        case encoding::reg_reg_reg:
+          word |= detail::make_operands(r0, r1, r2);
+          break;
+        case encoding::reg_imm_reg:
+          word |= stmt.long_form ? detail::make_operands(r0, immediate, r1)
+                                 : detail::make_operands(r0, short_imm(), accumulator);
+          break;
+        case encoding::reg_reg_imm:
+          word |= stmt.long_form ? detail::make_operands(r0, r1, immediate)
+                                 : detail::make_operands(r0, accumulator, short_imm());
+          break;
+        case encoding::jump:
+          word |= stmt.long_form
+                    ? detail::make_jump_operands(immediate)
+                    : detail::make_jump_operands(assembly::short_jump_address::unchecked(value));
+          break;
+        case encoding::cond_jump:
+        {
+          const auto cond = static_cast<assembly::jump_condition>(stmt.code & ~opcode_mask);
+          word = static_cast<word_t>(stmt.code & opcode_mask);
+          word |= stmt.long_form
+                    ? detail::make_jump_operands(cond, immediate)
+                    : detail::make_jump_operands(cond, assembly::short_cond_jump_address::unchecked(value));
+          break;
+        }
+        }
+
+        detail::store_word(image.data() + stmt.address, word);
+
+        if (stmt.long_form)
+          detail::store_word(image.data() + stmt.address + sizeof(word_t), value);
+      }
+    };
+
+  } // namespace
+
+  std::vector<std::byte> assemble_source(std::string_view source, const assembler_options& options)
+  {
+    return assembler{source, options}.assemble();
+  }
+
+} // namespace yarisc::arch
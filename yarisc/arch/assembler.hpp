@@ -0,0 +1,72 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_ASSEMBLER_HPP
+#define YARISC_ARCH_ASSEMBLER_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/feature_level.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Options of the assembler
+   */
+  struct assembler_options final
+  {
+    /**
+     * @brief Name of the source, which is the prefix of the error messages
+     */
+    std::string name{"<source>"};
+
+    /**
+     * @brief Feature level for which to emit the code
+     */
+    feature_level level{feature_level_latest};
+  };
+
+  /**
+   * @brief Assembles source text to a flat image
+   *
+   * Every line holds an optional label, followed by an optional statement and an optional comment:
+   *
+   * @verbatim
+   *
+   * loop:   ADD r0, r0, -1        ; instructions use the mnemonics and operands of the disassembly
+   *         JNZ loop
+   *         HLT
+   * count = 0x10                  ; constants can only refer to symbols defined before
+   * table:  .word count, loop + 2 ; data words
+   *         .zero 8               ; zero bytes
+   *
+   * @endverbatim
+   *
+   * Mnemonics and register names are case-insensitive, symbols are case-sensitive. Operands are registers or
+   * expressions of numbers (decimal, `0x` hexadecimal, or `0b` binary) and symbols combined with `+` and `-`. The
+   * arithmetic wraps around like the machine does.
+   *
+   * The image is assembled in two passes. The first pass lexes the source in a single scan, interns the symbols, and
+   * assigns the addresses. An immediate constant that is known at that point and fits into the instruction word is
+   * stored there, others, such as forward references to labels, take an additional word. The second pass resolves the
+   * symbols and encodes the instructions.
+   *
+   * The image starts at address `0x0000` and can be loaded with `machine::load`. Errors throw `std::invalid_argument`
+   * with the name, line, and column of the first error in the source.
+   *
+   * @param source source text
+   * @param options options of the assembler
+   * @return bytes of the image in the byte order of the machine
+   */
+  [[nodiscard]] YARISC_ARCH_EXPORT std::vector<std::byte>
+    assemble_source(std::string_view source, const assembler_options& options = {});
+
+} // namespace yarisc::arch
+
+#endif
@@ -137,7 +137,7 @@ namespace yarisc::arch
       explicit checked_immediate(word_t imm)
         : value_{imm}
       {
-        if (!check(value_))
+        if (!fits(value_))
           detail::throw_invalid_immediate(value_, Mask | SignMask);
       }
 
@@ -160,7 +160,7 @@ namespace yarisc::arch
        */
       [[nodiscard]] static checked_immediate unchecked(word_t imm) noexcept
       {
-        assert(check(imm));
+        assert(fits(imm));
 
         checked_immediate result;
         result.value_ = imm;
@@ -168,13 +168,19 @@ namespace yarisc::arch
         return result;
       }
 
-    private:
-      word_t value_{0x0};
-
-      [[nodiscard]] static bool check(word_t value) noexcept
+      /**
+       * @brief Returns whether a value can be stored in the immediate constant
+       *
+       * @param imm value of the immediate constant
+       * @return true if `imm` is a signed value with the sign at `SignMask` and only non-sign bits of `Mask` set
+       */
+      [[nodiscard]] static bool fits(word_t imm) noexcept
       {
-        return (detail::sign_extend(value & (Mask | SignMask), SignMask) == value);
+        return (detail::sign_extend(imm & (Mask | SignMask), SignMask) == imm);
       }
+
+    private:
+      word_t value_{0x0};
     };
 
     static_assert((sizeof(word_t) == 2), "Invalid address masks");
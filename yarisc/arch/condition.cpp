@@ -0,0 +1,488 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/condition.hpp>
+
+#include <array>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Recursive descent parser, which emits the bytecode while it parses
+   */
+  class breakpoint_condition::compiler final
+  {
+  public:
+    compiler(std::string_view source, breakpoint_condition& condition) noexcept
+      : source_{source}
+      , condition_{condition}
+    {
+    }
+
+    void compile()
+    {
+      skip_space();
+
+      if (pos_ == source_.size())
+        fail("expected an expression");
+
+      logical_or();
+
+      if (pos_ != source_.size())
+        fail("unexpected '" + std::string{source_.substr(pos_, 1)} + "'");
+
+      assert(depth_ == 1);
+    }
+
+  private:
+    std::string_view source_;
+    breakpoint_condition& condition_;
+
+    std::size_t pos_{0};
+    std::size_t depth_{0};
+
+    [[noreturn]] void fail(const std::string& msg) const
+    {
+      throw std::invalid_argument{"Invalid condition at column " + std::to_string(pos_ + 1) + ": " + msg};
+    }
+
+    void emit(op code, word_t arg = 0)
+    {
+      switch (code)
+      {
+      case op::constant:
+      case op::named:
+      case op::status:
+        if (++depth_ > max_stack)
+          fail("expression is nested too deeply");
+        break;
+      case op::load:
+      case op::changed:
+      case op::negate:
+      case op::complement:
+      case op::logical_not:
+        break;
+      default:
+        --depth_;
+        break;
+      }
+
+      condition_.code_.push_back({code, arg});
+    }
+
+    void skip_space() noexcept
+    {
+      while ((pos_ < source_.size()) && std::isspace(static_cast<unsigned char>(source_[pos_])))
+        ++pos_;
+    }
+
+    /**
+     * @brief Consumes the token if it is next
+     */
+    [[nodiscard]] bool accept(std::string_view token) noexcept
+    {
+      if (!source_.substr(pos_).starts_with(token))
+        return false;
+
+      pos_ += token.size();
+      skip_space();
+
+      return true;
+    }
+
+    /**
+     * @brief Consumes the single character operator if it is next and not the start of a longer one
+     */
+    [[nodiscard]] bool accept_single(char c, std::string_view unless) noexcept
+    {
+      const std::string_view rest = source_.substr(pos_);
+
+      if (rest.empty() || (rest[0] != c) || ((rest.size() > 1) && (unless.find(rest[1]) != std::string_view::npos)))
+        return false;
+
+      ++pos_;
+      skip_space();
+
+      return true;
+    }
+
+    void expect(std::string_view token)
+    {
+      if (!accept(token))
+        fail("expected '" + std::string{token} + "'");
+    }
+
+    void logical_or()
+    {
+      logical_and();
+
+      while (accept("||"))
+      {
+        logical_and();
+        emit(op::logical_or);
+      }
+    }
+
+    void logical_and()
+    {
+      bit_or();
+
+      while (accept("&&"))
+      {
+        bit_or();
+        emit(op::logical_and);
+      }
+    }
+
+    void bit_or()
+    {
+      bit_xor();
+
+      while (accept_single('|', "|"))
+      {
+        bit_xor();
+        emit(op::bit_or);
+      }
+    }
+
+    void bit_xor()
+    {
+      bit_and();
+
+      while (accept("^"))
+      {
+        bit_and();
+        emit(op::bit_xor);
+      }
+    }
+
+    void bit_and()
+    {
+      equality();
+
+      while (accept_single('&', "&"))
+      {
+        equality();
+        emit(op::bit_and);
+      }
+    }
+
+    void equality()
+    {
+      relation();
+
+      for (;;)
+      {
+        if (accept("=="))
+        {
+          relation();
+          emit(op::equal);
+        }
+        else if (accept("!="))
+        {
+          relation();
+          emit(op::not_equal);
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+
+    void relation()
+    {
+      sum();
+
+      for (;;)
+      {
+        if (accept("<="))
+        {
+          sum();
+          emit(op::less_equal);
+        }
+        else if (accept(">="))
+        {
+          sum();
+          emit(op::greater_equal);
+        }
+        else if (accept("<"))
+        {
+          sum();
+          emit(op::less);
+        }
+        else if (accept(">"))
+        {
+          sum();
+          emit(op::greater);
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+
+    void sum()
+    {
+      unary();
+
+      for (;;)
+      {
+        if (accept("+"))
+        {
+          unary();
+          emit(op::add);
+        }
+        else if (accept("-"))
+        {
+          unary();
+          emit(op::subtract);
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+
+    void unary()
+    {
+      if (accept_single('!', "="))
+      {
+        unary();
+        emit(op::logical_not);
+      }
+      else if (accept("~"))
+      {
+        unary();
+        emit(op::complement);
+      }
+      else if (accept("-"))
+      {
+        unary();
+        emit(op::negate);
+      }
+      else
+      {
+        primary();
+      }
+    }
+
+    void primary()
+    {
+      if (accept("("))
+      {
+        logical_or();
+        expect(")");
+      }
+      else if (accept("["))
+      {
+        logical_or();
+        expect("]");
+        emit(op::load);
+      }
+      else if ((pos_ < source_.size()) && std::isdigit(static_cast<unsigned char>(source_[pos_])))
+      {
+        number();
+      }
+      else
+      {
+        name();
+      }
+    }
+
+    void number()
+    {
+      const bool hex = source_.substr(pos_).starts_with("0x") || source_.substr(pos_).starts_with("0X");
+      const char* first = source_.data() + pos_ + (hex ? 2 : 0);
+      const char* last = source_.data() + source_.size();
+
+      word_t value = 0;
+      const auto [ptr, ec] = std::from_chars(first, last, value, hex ? 16 : 10);
+
+      if (ec == std::errc::result_out_of_range)
+        fail("number exceeds a word");
+      if ((ec != std::errc{}) || ((ptr != last) && std::isalnum(static_cast<unsigned char>(*ptr))))
+        fail("invalid number");
+
+      pos_ = static_cast<std::size_t>(ptr - source_.data());
+      skip_space();
+
+      emit(op::constant, value);
+    }
+
+    void name()
+    {
+      const std::size_t begin = pos_;
+
+      while ((pos_ < source_.size()) &&
+             (std::isalnum(static_cast<unsigned char>(source_[pos_])) || (source_[pos_] == '_') ||
+              (source_[pos_] == '.')))
+        ++pos_;
+
+      const std::string_view id = source_.substr(begin, pos_ - begin);
+
+      if (id.empty())
+        fail("expected an operand");
+
+      skip_space();
+
+      constexpr std::array<std::string_view, 8> registers{{"r0", "r1", "r2", "r3", "r4", "r5", "sp", "ip"}};
+
+      for (std::size_t i = 0; i < registers.size(); ++i)
+      {
+        if ((id == registers[i]) || ((id.size() == 2) && (id[0] == 'r') && (id[1] == static_cast<char>('0' + i))))
+        {
+          emit(op::named, static_cast<word_t>(i));
+
+          return;
+        }
+      }
+
+      if (id == "status")
+      {
+        emit(op::status);
+      }
+      else if ((id == "status.zero") || (id == "status.carry"))
+      {
+        emit(op::status);
+        emit(op::constant, (id == "status.zero") ? status_register::zero_flag : status_register::carry_flag);
+        emit(op::bit_and);
+        emit(op::logical_not);
+        emit(op::logical_not);
+      }
+      else if (id == "changed")
+      {
+        expect("(");
+        expect("[");
+        logical_or();
+        expect("]");
+        expect(")");
+
+        emit(op::changed, static_cast<word_t>(condition_.previous_.size()));
+        condition_.previous_.emplace_back();
+      }
+      else
+      {
+        pos_ = begin;
+        fail("unknown operand '" + std::string{id} + "'");
+      }
+    }
+  };
+
+  breakpoint_condition::breakpoint_condition(std::string_view source)
+    : source_{source}
+  {
+    compiler{source_, *this}.compile();
+  }
+
+  bool breakpoint_condition::operator()(const machine_registers& reg, const memory& mem) noexcept
+  {
+    std::array<word_t, max_stack> stack;
+    std::size_t top = 0;
+
+    const auto load = [&mem](word_t address) -> word_t {
+      const auto aligned = static_cast<address_t>(address & ~word_t{sizeof(word_t) - 1});
+
+      return (aligned < mem.size()) ? mem.load(aligned) : word_t{0};
+    };
+
+    const auto binary = [&stack, &top](auto fn) {
+      --top;
+      stack[top - 1] = static_cast<word_t>(fn(stack[top - 1], stack[top]));
+    };
+
+    for (const instruction& instr : code_)
+    {
+      switch (instr.code)
+      {
+      case op::constant:
+        stack[top++] = instr.arg;
+        break;
+      case op::named:
+        stack[top++] = reg.named.r[instr.arg];
+        break;
+      case op::status:
+        stack[top++] = reg.status.s;
+        break;
+      case op::load:
+        stack[top - 1] = load(stack[top - 1]);
+        break;
+      case op::changed:
+      {
+        const word_t value = load(stack[top - 1]);
+        std::optional<word_t>& previous = previous_[instr.arg];
+
+        stack[top - 1] = (previous && (*previous != value)) ? 1 : 0;
+        previous = value;
+        break;
+      }
+      case op::negate:
+        stack[top - 1] = static_cast<word_t>(-stack[top - 1]);
+        break;
+      case op::complement:
+        stack[top - 1] = static_cast<word_t>(~stack[top - 1]);
+        break;
+      case op::logical_not:
+        stack[top - 1] = (stack[top - 1] == 0) ? 1 : 0;
+        break;
+      case op::add:
+        binary([](word_t a, word_t b) { return a + b; });
+        break;
+      case op::subtract:
+        binary([](word_t a, word_t b) { return a - b; });
+        break;
+      case op::less:
+        binary([](word_t a, word_t b) { return a < b; });
+        break;
+      case op::less_equal:
+        binary([](word_t a, word_t b) { return a <= b; });
+        break;
+      case op::greater:
+        binary([](word_t a, word_t b) { return a > b; });
+        break;
+      case op::greater_equal:
+        binary([](word_t a, word_t b) { return a >= b; });
+        break;
+      case op::equal:
+        binary([](word_t a, word_t b) { return a == b; });
+        break;
+      case op::not_equal:
+        binary([](word_t a, word_t b) { return a != b; });
+        break;
+      case op::bit_and:
+        binary([](word_t a, word_t b) { return a & b; });
+        break;
+      case op::bit_xor:
+        binary([](word_t a, word_t b) { return a ^ b; });
+        break;
+      case op::bit_or:
+        binary([](word_t a, word_t b) { return a | b; });
+        break;
+      case op::logical_and:
+        binary([](word_t a, word_t b) { return (a != 0) && (b != 0); });
+        break;
+      case op::logical_or:
+        binary([](word_t a, word_t b) { return (a != 0) || (b != 0); });
+        break;
+      }
+    }
+
+    assert(top == 1);
+
+    return stack[0] != 0;
+  }
+
+} // namespace yarisc::arch
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_CONDITION_HPP
+#define YARISC_ARCH_CONDITION_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Condition of a breakpoint compiled to a small stack bytecode
+   *
+   * The condition is an expression over words with the operators and precedences of C:
+   *
+   * - `r0` to `r7`, `sp`, and `ip` are the named registers, `status` is the status register
+   * - `status.zero` and `status.carry` are the flags of the status register
+   * - `[a]` is the word in main memory containing the byte address `a`, or zero beyond the end of main memory
+   * - `changed([a])` is one if the word differs from the one seen by the previous evaluation, which is not the case
+   *   for the first evaluation
+   * - Numbers are decimal or hexadecimal with the prefix `0x`
+   * - Unary `!`, `~`, `-`, binary `+`, `-`, `<`, `<=`, `>`, `>=`, `==`, `!=`, `&`, `^`, `|`, `&&`, `||`, parentheses
+   *
+   * Arithmetic wraps around like the machine does, comparisons are unsigned. Both operands of `&&` and `||` are always
+   * evaluated, so every `changed` sees every evaluation. The condition holds if the expression is not zero.
+   */
+  class breakpoint_condition final
+  {
+  public:
+    /**
+     * @brief Compiles a condition
+     *
+     * Throws an invalid argument exception with the column of the error if the condition is malformed.
+     *
+     * @param source condition expression
+     */
+    YARISC_ARCH_EXPORT explicit breakpoint_condition(std::string_view source);
+
+    /**
+     * @brief Returns the condition expression
+     */
+    [[nodiscard]] const std::string& source() const noexcept
+    {
+      return source_;
+    }
+
+    /**
+     * @brief Evaluates the condition
+     *
+     * The status register must be up to date.
+     *
+     * @param reg registers of the machine
+     * @param mem main memory of the machine
+     * @return true if the condition holds
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT bool operator()(const machine_registers& reg, const memory& mem) noexcept;
+
+  private:
+    class compiler;
+
+    enum class op : std::uint8_t
+    {
+      constant,
+      named,
+      status,
+      load,
+      changed,
+      negate,
+      complement,
+      logical_not,
+      add,
+      subtract,
+      less,
+      less_equal,
+      greater,
+      greater_equal,
+      equal,
+      not_equal,
+      bit_and,
+      bit_xor,
+      bit_or,
+      logical_and,
+      logical_or,
+    };
+
+    struct instruction final
+    {
+      op code;
+
+      /**
+       * @brief Constant, register index, or slot of a `changed`
+       */
+      word_t arg{0};
+    };
+
+    static constexpr std::size_t max_stack = 32;
+
+    std::string source_;
+
+    std::vector<instruction> code_;
+
+    /**
+     * @brief Words seen by the previous evaluation of each `changed`
+     */
+    std::vector<std::optional<word_t>> previous_;
+  };
+
+} // namespace yarisc::arch
+
+#endif
@@ -6,14 +6,21 @@
 #include <yarisc/arch/debugger.hpp>
 
 #include <yarisc/arch/detail/format.hpp>
+#include <yarisc/arch/detail/hex_memory.hpp>
+#include <yarisc/arch/detail/hex_registers.hpp>
+#include <yarisc/arch/detail/hex_word.hpp>
 #include <yarisc/arch/registers.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 namespace yarisc::arch
@@ -23,7 +30,7 @@ namespace yarisc::arch
     template <typename>
     inline constexpr bool always_false_v = false;
 
-    std::ostream& output_message(std::ostream& os, std::string_view msg)
+    utils::text_buffer& output_message(utils::text_buffer& os, std::string_view msg)
     {
       constexpr std::size_t line_width = 80;
 
@@ -48,7 +55,7 @@ namespace yarisc::arch
       friend detail::bind_output_fn<debugger_output_t, debugger_view>;
 
       template <utils::color::context Ctx>
-      void put(const debugger_view& dbg, Ctx& ctx, std::ostream& os) const
+      void put(const debugger_view& dbg, Ctx& ctx, utils::text_buffer& os) const
       {
         using namespace std::string_view_literals;
 
@@ -58,10 +65,12 @@ namespace yarisc::arch
         previous_registers_except_ip.instruction = dbg.current_registers.instruction;
 
         // Output registers
-        os << as_diff(dbg.current_registers, previous_registers_except_ip) << '\n';
+        detail::hex_registers(as_diff(dbg.current_registers, previous_registers_except_ip), ctx, os);
+        os << '\n';
 
         // Output main memory
-        os << as_diff(dbg.current_memory, dbg.previous_memory) << '\n';
+        detail::hex_memory(as_diff(dbg.current_memory, dbg.previous_memory), ctx, os);
+        os << '\n';
 
         // Output info or error (always output a message to clear previous messages)
         if (!dbg.error.empty())
@@ -71,7 +80,7 @@ namespace yarisc::arch
       }
 
       template <utils::color::context Ctx>
-      void put(const diff<debugger_view>&, Ctx&, std::ostream&) const
+      void put(const diff<debugger_view>&, Ctx&, utils::text_buffer&) const
       {
         static_assert(always_false_v<Ctx>, "Debugger view already outputs a diff");
       }
@@ -81,6 +90,231 @@ namespace yarisc::arch
 
   } // namespace
 
+  bool debugger::breakpoint_in(address_t address, std::size_t size) const noexcept
+  {
+    if (size == 0)
+      return false;
+
+    // Only the long immediate constant of an instruction at the end of the address space can be past the end
+    const std::size_t first = address / sizeof(word_t);
+    const std::size_t last = std::min((address + size - 1) / sizeof(word_t), num_words - 1);
+
+    const auto mask_from = [](std::size_t bit) { return ~std::uint64_t{0} << (bit % 64); };
+    const auto mask_to = [](std::size_t bit) { return ~std::uint64_t{0} >> (63 - bit % 64); };
+
+    if (first / 64 == last / 64)
+      return (breakpoints_[first / 64] & mask_from(first) & mask_to(last)) != 0;
+
+    if ((breakpoints_[first / 64] & mask_from(first)) != 0)
+      return true;
+
+    for (std::size_t i = first / 64 + 1; i < last / 64; ++i)
+    {
+      if (breakpoints_[i] != 0)
+        return true;
+    }
+
+    return (breakpoints_[last / 64] & mask_to(last)) != 0;
+  }
+
+  bool debugger::stop_at(address_t address, const machine_registers& reg, const memory& mem) noexcept
+  {
+    if (conditions_.empty())
+      return true;
+
+    const auto it = conditions_.find(address / sizeof(word_t));
+
+    return (it == conditions_.end()) || it->second(reg, mem);
+  }
+
+  bool debugger::add_breakpoint(address_t address)
+  {
+    if (!detail::is_aligned(address))
+      throw std::invalid_argument{"Breakpoint address " + std::to_string(address) + " is not word-aligned"};
+
+    const std::size_t word = address / sizeof(word_t);
+    const std::uint64_t bit = std::uint64_t{1} << (word % 64);
+
+    conditions_.erase(word);
+
+    if (breakpoints_[word / 64] & bit)
+      return false;
+
+    breakpoints_[word / 64] |= bit;
+    ++num_breakpoints_;
+
+    return true;
+  }
+
+  bool debugger::add_breakpoint(address_t address, breakpoint_condition condition)
+  {
+    const bool added = add_breakpoint(address);
+
+    conditions_.insert_or_assign(address / sizeof(word_t), std::move(condition));
+
+    return added;
+  }
+
+  const breakpoint_condition* debugger::condition(address_t address) const noexcept
+  {
+    const auto it = conditions_.find(address / sizeof(word_t));
+
+    return (it != conditions_.end()) ? &it->second : nullptr;
+  }
+
+  void debugger::suspend_breakpoint(address_t address, bool suspend) noexcept
+  {
+    const std::size_t word = address / sizeof(word_t);
+    const std::uint64_t bit = std::uint64_t{1} << (word % 64);
+
+    if (suspend)
+      breakpoints_[word / 64] &= ~bit;
+    else
+      breakpoints_[word / 64] |= bit;
+  }
+
+  bool debugger::remove_breakpoint(address_t address)
+  {
+    if (!detail::is_aligned(address))
+      throw std::invalid_argument{"Breakpoint address " + std::to_string(address) + " is not word-aligned"};
+
+    const std::size_t word = address / sizeof(word_t);
+    const std::uint64_t bit = std::uint64_t{1} << (word % 64);
+
+    if (!(breakpoints_[word / 64] & bit))
+      return false;
+
+    breakpoints_[word / 64] &= ~bit;
+    --num_breakpoints_;
+
+    conditions_.erase(word);
+
+    return true;
+  }
+
+  void debugger::clear_breakpoints() noexcept
+  {
+    breakpoints_.fill(0);
+    num_breakpoints_ = 0;
+
+    conditions_.clear();
+  }
+
+  std::vector<address_t> debugger::breakpoints() const
+  {
+    std::vector<address_t> result;
+    result.reserve(num_breakpoints_);
+
+    for (std::size_t i = 0; i < breakpoints_.size(); ++i)
+    {
+      for (std::uint64_t bits = breakpoints_[i]; bits != 0; bits &= bits - 1)
+      {
+        const auto word = i * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+
+        result.push_back(static_cast<address_t>(word * sizeof(word_t)));
+      }
+    }
+
+    return result;
+  }
+
+  bool debugger::add_watchpoint(const watchpoint& watch)
+  {
+    if ((watch.size == 0) || (watch.address + std::size_t{watch.size} > num_words * sizeof(word_t)))
+      throw std::invalid_argument{"Watchpoint range at address " + std::to_string(watch.address) + " of size " +
+                                  std::to_string(watch.size) + " is empty or exceeds the address space"};
+
+    if ((static_cast<std::uint8_t>(watch.access) & static_cast<std::uint8_t>(watch_access::read_write)) == 0)
+      throw std::invalid_argument{"Watchpoint does not watch any access"};
+
+    if (std::ranges::find(watchpoints_, watch) != watchpoints_.end())
+      return false;
+
+    watchpoints_.push_back(watch);
+    update_pages();
+
+    return true;
+  }
+
+  bool debugger::remove_watchpoint(const watchpoint& watch)
+  {
+    const auto it = std::ranges::find(watchpoints_, watch);
+
+    if (it == watchpoints_.end())
+      return false;
+
+    watchpoints_.erase(it);
+    update_pages();
+
+    return true;
+  }
+
+  void debugger::clear_watchpoints() noexcept
+  {
+    watchpoints_.clear();
+    update_pages();
+  }
+
+  void debugger::suspend_watchpoints(bool suspend) noexcept
+  {
+    watchpoints_suspended_ = suspend;
+    update_pages();
+  }
+
+  bool debugger::watch(address_t address, word_t value, watch_access access)
+  {
+    using namespace std::string_view_literals;
+
+    // The access covers two bytes, except at the end of the address space
+    const std::size_t first = address;
+    const std::size_t last = std::min(first + 1, num_words * sizeof(word_t) - 1);
+
+    const auto fires = [&](const watchpoint& w) {
+      return (first < w.address + std::size_t{w.size}) && (w.address <= last) &&
+             ((static_cast<std::uint8_t>(w.access) & static_cast<std::uint8_t>(access)) != 0) &&
+             (!w.value || (*w.value == value));
+    };
+
+    const auto it = std::ranges::find_if(watchpoints_, fires);
+
+    if (it == watchpoints_.end())
+      return false;
+
+    hit_ = watchpoint_hit{*it, address, value, access};
+
+    std::ostringstream oss;
+    detail::output_hex(oss << "Watchpoint: "sv << ((access == watch_access::read) ? "read of 0x"sv : "write of 0x"sv),
+                       value);
+    detail::output_hex(oss << ((access == watch_access::read) ? " from 0x"sv : " to 0x"sv), address);
+
+    message_ = std::move(oss).str();
+
+    return true;
+  }
+
+  void debugger::update_pages() noexcept
+  {
+    read_pages_.fill(0);
+    write_pages_.fill(0);
+
+    if (watchpoints_suspended_)
+      return;
+
+    for (const watchpoint& w : watchpoints_)
+    {
+      const auto set = [&w](page_filter& pages) {
+        for (std::size_t page = w.address / page_size; page <= (w.address + w.size - 1) / page_size; ++page)
+          pages[page / 64] |= std::uint64_t{1} << (page % 64);
+      };
+
+      if ((static_cast<std::uint8_t>(w.access) & static_cast<std::uint8_t>(watch_access::read)) != 0)
+        set(read_pages_);
+
+      if ((static_cast<std::uint8_t>(w.access) & static_cast<std::uint8_t>(watch_access::write)) != 0)
+        set(write_pages_);
+    }
+  }
+
   bool store_debug_message(debugger* dbg, std::string msg)
   {
     if (!dbg)
@@ -105,9 +339,9 @@ namespace yarisc::arch
     throw std::runtime_error{msg};
   }
 
-  void tag_invoke(output_t, std::ostream& os, const debugger_view& dbg, output_format fmt)
+  void tag_invoke(output_to_t, std::string& str, const debugger_view& dbg, output_format fmt)
   {
-    detail::format_output(debugger_output, os, fmt, dbg);
+    detail::format_output(debugger_output, str, fmt, dbg);
   }
 
 } // namespace yarisc::arch
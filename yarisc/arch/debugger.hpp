@@ -6,17 +6,86 @@
 #ifndef YARISC_ARCH_DEBUGGER_HPP
 #define YARISC_ARCH_DEBUGGER_HPP
 
+#include <yarisc/arch/condition.hpp>
 #include <yarisc/arch/export.h>
 #include <yarisc/arch/machine.hpp>
 #include <yarisc/arch/memory.hpp>
 #include <yarisc/arch/output.hpp>
+#include <yarisc/arch/types.hpp>
 
-#include <iosfwd>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace yarisc::arch
 {
+  /**
+   * @brief Kinds of data accesses a watchpoint fires on
+   */
+  enum class watch_access : std::uint8_t
+  {
+    read = 0x1,
+    write = 0x2,
+    read_write = 0x3,
+  };
+
+  /**
+   * @brief Watchpoint on the data accesses to an address range
+   *
+   * Loads and stores fire a watchpoint if one of the two bytes of the accessed word is in the range. Instruction
+   * fetches are not data accesses.
+   */
+  struct watchpoint final
+  {
+    /**
+     * @brief Byte address of the first byte in the range
+     */
+    address_t address{0};
+
+    /**
+     * @brief Number of bytes in the range, which must not wrap around the end of the address space
+     */
+    std::uint32_t size{sizeof(word_t)};
+
+    watch_access access{watch_access::write};
+
+    /**
+     * @brief Value a load or store has to transfer to fire the watchpoint, any value if empty
+     */
+    std::optional<word_t> value{};
+
+    [[nodiscard]] bool operator==(const watchpoint& that) const noexcept = default;
+  };
+
+  /**
+   * @brief Data access that fired a watchpoint
+   */
+  struct watchpoint_hit final
+  {
+    watchpoint watch{};
+
+    /**
+     * @brief Byte address of the access
+     */
+    address_t address{0};
+
+    /**
+     * @brief Value loaded from memory or to be stored to memory
+     */
+    word_t value{0};
+
+    /**
+     * @brief Either `watch_access::read` or `watch_access::write`
+     */
+    watch_access access{watch_access::read};
+  };
+
   /**
    * @brief Debugger state used by the machine
    */
@@ -73,6 +142,193 @@ namespace yarisc::arch
       panic_ = false;
     }
 
+    /**
+     * @brief Returns whether there is a breakpoint at the instruction address
+     *
+     * Breakpoints are kept per word, so an instruction at an unaligned address hits the breakpoint of its word.
+     *
+     * @param address byte address of the instruction
+     */
+    [[nodiscard]] bool breakpoint(address_t address) const noexcept
+    {
+      const std::size_t word = address / sizeof(word_t);
+
+      return (breakpoints_[word / 64] >> (word % 64)) & 0x1;
+    }
+
+    /**
+     * @brief Returns whether there is any breakpoint
+     */
+    [[nodiscard]] bool has_breakpoints() const noexcept
+    {
+      return num_breakpoints_ != 0;
+    }
+
+    /**
+     * @brief Returns whether there is a breakpoint in an address range
+     *
+     * Straight-line code without a breakpoint can be executed without checking every instruction.
+     *
+     * @param address byte address of the first instruction in the range
+     * @param size number of bytes in the range, which must not wrap around the end of the address space
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT bool breakpoint_in(address_t address, std::size_t size) const noexcept;
+
+    /**
+     * @brief Returns whether execution stops at a breakpoint at the instruction address
+     *
+     * It is only called if `breakpoint()` is true for the address, so conditions are only evaluated there.
+     *
+     * @param address byte address of the instruction
+     * @param reg registers of the machine with an up to date status register
+     * @param mem main memory of the machine
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT bool stop_at(
+      address_t address, const machine_registers& reg, const memory& mem) noexcept;
+
+    /**
+     * @brief Adds a breakpoint
+     *
+     * Execution stops before the instruction at the address is executed. When execution is resumed, a breakpoint at
+     * the instruction pointer is stepped over. The condition of a breakpoint already at the address is removed.
+     *
+     * @param address word-aligned byte address of the instruction
+     * @return true if the breakpoint has been added, false if there already was one
+     */
+    YARISC_ARCH_EXPORT bool add_breakpoint(address_t address);
+
+    /**
+     * @brief Adds a conditional breakpoint
+     *
+     * Execution only stops if the condition holds. The condition replaces the one of a breakpoint already at the
+     * address.
+     *
+     * @param address word-aligned byte address of the instruction
+     * @param condition compiled condition
+     * @return true if the breakpoint has been added, false if there already was one
+     */
+    YARISC_ARCH_EXPORT bool add_breakpoint(address_t address, breakpoint_condition condition);
+
+    /**
+     * @brief Returns the condition of a breakpoint or nullptr if it is unconditional or there is none
+     *
+     * @param address byte address of the instruction
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT const breakpoint_condition* condition(address_t address) const noexcept;
+
+    /**
+     * @brief Disables or enables a breakpoint without removing it, which keeps its condition
+     *
+     * @param address word-aligned byte address of the breakpoint
+     * @param suspend true to disable, false to enable
+     */
+    YARISC_ARCH_EXPORT void suspend_breakpoint(address_t address, bool suspend) noexcept;
+
+    /**
+     * @brief Removes a breakpoint
+     *
+     * @param address word-aligned byte address of the instruction
+     * @return true if the breakpoint has been removed, false if there was none
+     */
+    YARISC_ARCH_EXPORT bool remove_breakpoint(address_t address);
+
+    /**
+     * @brief Removes all breakpoints
+     */
+    YARISC_ARCH_EXPORT void clear_breakpoints() noexcept;
+
+    /**
+     * @brief Returns the addresses of all breakpoints in ascending order
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT std::vector<address_t> breakpoints() const;
+
+    /**
+     * @brief Returns whether a load fires a watchpoint and records the hit
+     *
+     * Most accesses are rejected by the page filter, only accesses to a watched page search the watchpoints.
+     *
+     * @param address byte address of the load
+     * @param value value in memory
+     */
+    [[nodiscard]] bool watch_read(address_t address, word_t value)
+    {
+      return watched(read_pages_, address) && watch(address, value, watch_access::read);
+    }
+
+    /**
+     * @brief Returns whether a store fires a watchpoint and records the hit
+     *
+     * @param address byte address of the store
+     * @param value value to be stored
+     */
+    [[nodiscard]] bool watch_write(address_t address, word_t value)
+    {
+      return watched(write_pages_, address) && watch(address, value, watch_access::write);
+    }
+
+    /**
+     * @brief Returns whether there is any watchpoint
+     */
+    [[nodiscard]] bool has_watchpoints() const noexcept
+    {
+      return !watchpoints_.empty();
+    }
+
+    /**
+     * @brief Adds a watchpoint
+     *
+     * Execution stops before the load or store that fires the watchpoint is executed, and the instruction pointer is
+     * left at the instruction. When execution is resumed, the instruction is executed without checking the watchpoints.
+     *
+     * @param watch watchpoint with a non-empty range within the address space
+     * @return true if the watchpoint has been added, false if there already was an equal one
+     */
+    YARISC_ARCH_EXPORT bool add_watchpoint(const watchpoint& watch);
+
+    /**
+     * @brief Removes a watchpoint
+     *
+     * @param watch watchpoint equal to the one to remove
+     * @return true if the watchpoint has been removed, false if there was none
+     */
+    YARISC_ARCH_EXPORT bool remove_watchpoint(const watchpoint& watch);
+
+    /**
+     * @brief Removes all watchpoints
+     */
+    YARISC_ARCH_EXPORT void clear_watchpoints() noexcept;
+
+    /**
+     * @brief Returns all watchpoints in the order they have been added
+     */
+    [[nodiscard]] const std::vector<watchpoint>& watchpoints() const noexcept
+    {
+      return watchpoints_;
+    }
+
+    /**
+     * @brief Returns the access on which the last execution has stopped, if it has stopped at a watchpoint
+     */
+    [[nodiscard]] const std::optional<watchpoint_hit>& hit() const noexcept
+    {
+      return hit_;
+    }
+
+    /**
+     * @brief Forgets the last watchpoint hit
+     */
+    void reset_hit() noexcept
+    {
+      hit_.reset();
+    }
+
+    /**
+     * @brief Stops or resumes checking the watchpoints, which are kept either way
+     *
+     * @param suspend true to stop checking, false to resume
+     */
+    YARISC_ARCH_EXPORT void suspend_watchpoints(bool suspend) noexcept;
+
     /**
      * @brief Stores a debug message if the debugger is not nullptr
      *
@@ -91,9 +347,56 @@ namespace yarisc::arch
     YARISC_ARCH_EXPORT friend void store_panic_or_throw(debugger* dbg, std::string msg);
 
   private:
+    static constexpr std::size_t num_words = (static_cast<std::size_t>(std::numeric_limits<address_t>::max()) + 1) /
+                                             sizeof(word_t);
+
     bool panic_{false};
 
     std::string message_;
+
+    /**
+     * @brief Bitmap of the breakpoints with one bit per word address
+     */
+    std::array<std::uint64_t, num_words / 64> breakpoints_{};
+
+    std::size_t num_breakpoints_{0};
+
+    /**
+     * @brief Conditions of the conditional breakpoints by word address
+     */
+    std::unordered_map<std::size_t, breakpoint_condition> conditions_;
+
+    static constexpr std::size_t page_size = 256;
+    static constexpr std::size_t num_pages = num_words * sizeof(word_t) / page_size;
+
+    using page_filter = std::array<std::uint64_t, num_pages / 64>;
+
+    /**
+     * @brief Bitmaps of the pages with a read or write watchpoint with one bit per page
+     */
+    page_filter read_pages_{};
+    page_filter write_pages_{};
+
+    std::vector<watchpoint> watchpoints_;
+
+    std::optional<watchpoint_hit> hit_;
+
+    bool watchpoints_suspended_{false};
+
+    [[nodiscard]] static bool watched(const page_filter& pages, address_t address) noexcept
+    {
+      const auto test = [&pages](std::size_t page) { return ((pages[page / 64] >> (page % 64)) & 0x1) != 0; };
+
+      // An unaligned access at the end of a page also accesses the first byte of the next page
+      return test(address / page_size) || test(((address + std::size_t{1}) / page_size) % num_pages);
+    }
+
+    /**
+     * @brief Searches the watchpoints for an access to a watched page
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT bool watch(address_t address, word_t value, watch_access access);
+
+    void update_pages() noexcept;
   };
 
   /**
@@ -120,7 +423,7 @@ namespace yarisc::arch
     std::string_view error{};
   };
 
-  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const debugger_view& dbg, output_format fmt);
+  YARISC_ARCH_EXPORT void tag_invoke(output_to_t, std::string& str, const debugger_view& dbg, output_format fmt);
 
 } // namespace yarisc::arch
 
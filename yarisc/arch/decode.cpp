@@ -0,0 +1,18 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/detail/decode.hpp>
+
+#include <yarisc/arch/machine_profile.hpp>
+
+#include <type_traits>
+
+namespace yarisc::arch::detail
+{
+  const decode_table decode_table_min{std::type_identity<machine_profile<feature_level::min>>{}};
+
+  const decode_table decode_table_v1{std::type_identity<machine_profile<feature_level::v1>>{}};
+
+} // namespace yarisc::arch::detail
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_BLOCK_HPP
+#define YARISC_ARCH_DETAIL_BLOCK_HPP
+
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/detail/threaded.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/registers.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace yarisc::arch::detail
+{
+  /**
+   * @brief State of the threaded dispatch loop of the block engine
+   *
+   * Within a block the next instruction is taken from the block, so only the transitions between blocks look at the
+   * block cache. A block is left early after the cache has been marked dirty by a store, because its remaining
+   * instructions may be stale. The instructions executed from a block are limited by the remaining number of steps.
+   */
+  template <typename Policy>
+  struct block_dispatch final
+  {
+    using policy_type = Policy;
+    using profile_type = typename Policy::profile_type;
+
+    Policy& policy;
+    machine_registers& reg;
+    machine_memory& mem;
+    std::uint64_t steps;
+
+    block_cache& blocks;
+
+    execute_result result{};
+    std::uint64_t s{0};
+
+    decoded_instruction instr{};
+
+    /**
+     * @brief Index of the current block or `basic_block::npos` after an instruction executed outside of blocks
+     */
+    std::uint32_t current{basic_block::npos};
+
+    /**
+     * @brief Next and end of the instructions to execute from the current block
+     */
+    const decoded_instruction* next{nullptr};
+    const decoded_instruction* end{nullptr};
+
+    /**
+     * @brief Byte address of the next instruction of the current block
+     */
+    address_t address{0};
+
+    /**
+     * @brief Whether the current block has a breakpoint, otherwise its instructions are not checked one by one
+     */
+    bool breakpoints{false};
+
+    /**
+     * @brief Enters the block at the instruction pointer
+     *
+     * @return the index of the handler of its first instruction
+     */
+    [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t fetch() noexcept
+    {
+      const auto ip = static_cast<address_t>(reg.named.ip());
+
+      current = enter(blocks, *policy.cache.cache_, mem.main, current, ip);
+
+      if (current == basic_block::npos) [[unlikely]]
+      {
+        // No block starts at the instruction pointer, so the single instruction is passed on to the fallback
+        if constexpr (Policy::debug_policy::enabled)
+        {
+          if (policy.breakpoint(ip, reg, mem)) [[unlikely]]
+          {
+            result = breakpoint_result;
+
+            return exit_handler;
+          }
+        }
+
+        reg.named.set_ip(static_cast<word_t>(ip + sizeof(word_t)));
+        next = end;
+
+        return fallback_handler;
+      }
+
+      const basic_block& b = blocks.block(current);
+
+      next = blocks.instructions(b);
+      end = next + std::min<std::uint64_t>(b.size, steps - s);
+      address = b.entry;
+
+      if constexpr (Policy::debug_policy::enabled)
+        breakpoints = policy.debug.breakpoint_in(b.entry, static_cast<address_t>(b.end - b.entry));
+
+      return step();
+    }
+
+    /**
+     * @brief Takes the next instruction from the current block
+     *
+     * @return the index of the handler of the instruction
+     */
+    [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t step() noexcept
+    {
+      if constexpr (Policy::debug_policy::enabled)
+      {
+        if (breakpoints && policy.breakpoint(address, reg, mem)) [[unlikely]]
+        {
+          result = breakpoint_result;
+
+          return exit_handler;
+        }
+      }
+
+      instr = *next++;
+
+      reg.named.set_ip(static_cast<word_t>(address + sizeof(word_t)));
+
+      if constexpr (Policy::strict_policy::enabled)
+      {
+        // Let the reference interpreter raise the panic and leave the block
+        if (!instr.valid()) [[unlikely]]
+        {
+          next = end;
+
+          return fallback_handler;
+        }
+      }
+
+      address = static_cast<address_t>(address + instr.size());
+
+      return handler_index(instr);
+    }
+
+    /**
+     * @brief Counts the executed instruction and continues within the block or with the next block
+     *
+     * @return the index of the handler of the next instruction
+     */
+    [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t retire() noexcept
+    {
+      if (!result.keep_going || (++s == steps)) [[unlikely]]
+        return exit_handler;
+
+      if ((next != end) && !blocks.dirty()) [[likely]]
+        return step();
+
+      return fetch();
+    }
+
+  private:
+    /**
+     * @brief Looks up the block at the given address and links it to the block that has been left
+     *
+     * It is kept out of line and away from the dispatch state, so the state stays in registers within the blocks.
+     *
+     * @param blocks block cache, which is flushed first if it is dirty
+     * @param cache decode cache to build new blocks from
+     * @param mem main memory of the machine
+     * @param current index of the block that has been left or `basic_block::npos`
+     * @param ip byte address of the next instruction
+     * @return index of the block or `basic_block::npos` if no block can start at the address
+     */
+    [[nodiscard]] YARISC_ARCH_NOINLINE static std::uint32_t enter(
+      block_cache& blocks, decode_cache& cache, const memory& mem, std::uint32_t current, address_t ip)
+    {
+      if (blocks.refresh()) [[unlikely]]
+        current = basic_block::npos;
+
+      std::uint32_t index = (current != basic_block::npos) ? blocks.successor(current, ip) : basic_block::npos;
+
+      if (index == basic_block::npos)
+      {
+        index = blocks.find<profile_type>(cache, mem, ip);
+
+        if ((index != basic_block::npos) && (current != basic_block::npos))
+          blocks.link(current, ip, index);
+      }
+
+      return index;
+    }
+  };
+
+  /**
+   * @brief Executes basic blocks from the block cache
+   *
+   * Blocks are linked to their successors when they are left, so the block cache is only searched for the first
+   * transition to another block. Instructions that cannot start a block are executed one by one.
+   *
+   * The semantics are those of `execute_decoded_instruction` in a loop. The instruction that halts or hits a breakpoint
+   * is not counted as an executed step.
+   *
+   * @param policy execution policy with a decode cache and a block cache
+   * @param reg registers of the machine
+   * @param mem memory of the machine
+   * @param steps maximum number of steps to execute
+   * @return the result of the last instruction and the number of executed steps
+   */
+  template <typename Policy>
+  [[nodiscard]] std::pair<execute_result, std::uint64_t> execute_blocks(
+    Policy& policy, machine_registers& reg, machine_memory& mem, std::uint64_t steps)
+  {
+    static_assert(Policy::cache_policy::enabled, "Block execution requires a decode cache and a block cache");
+
+    if (steps == 0)
+      return {execute_result{}, 0};
+
+    block_dispatch<Policy> d{policy, reg, mem, steps, *policy.cache.blocks_};
+
+    return run_threaded(d);
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
@@ -0,0 +1,392 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_BLOCK_CACHE_HPP
+#define YARISC_ARCH_DETAIL_BLOCK_CACHE_HPP
+
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace yarisc::arch::detail
+{
+  /**
+   * @brief Straight-line sequence of decoded instructions with a single entry
+   *
+   * A block ends with the first instruction that may change the instruction pointer other than by advancing it, i.e.
+   * jumps, conditional jumps, halts, and instructions with the instruction pointer as destination.
+   */
+  struct basic_block final
+  {
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * @brief Successor slot of the block that is left by advancing past its last instruction
+     */
+    static constexpr std::size_t fall_through = 0;
+
+    /**
+     * @brief Successor slot of the block that is left by a jump
+     */
+    static constexpr std::size_t branch = 1;
+
+    /**
+     * @brief Byte address of the first instruction
+     */
+    address_t entry{0};
+
+    /**
+     * @brief Byte address following the last instruction
+     */
+    address_t end{0};
+
+    /**
+     * @brief Index of the first instruction in the instruction pool of the cache
+     */
+    std::uint32_t first{0};
+
+    /**
+     * @brief Number of instructions
+     */
+    std::uint32_t size{0};
+
+    /**
+     * @brief Entry addresses and indices of the linked successor blocks
+     */
+    std::array<address_t, 2> successor_address{};
+    std::array<std::uint32_t, 2> successor{{npos, npos}};
+  };
+
+  /**
+   * @brief Returns whether the decoded instruction ends a basic block
+   */
+  [[nodiscard]] inline bool ends_block(const decoded_instruction& instr) noexcept
+  {
+    constexpr std::uint8_t ip_index = 7;
+
+    switch (instr.get_opcode())
+    {
+    case opcode::jump:
+    case opcode::cond_jump:
+    case opcode::halt:
+      return true;
+    case opcode::move:
+    case opcode::load:
+    case opcode::add:
+    case opcode::add_with_carry:
+      return (instr.op0 == ip_index);
+    default:
+      return false;
+    }
+  }
+
+  /**
+   * @brief Cache of basic blocks keyed by their entry address
+   *
+   * Blocks are built from the decode cache on first use and linked to their successors while they are executed. A
+   * store to a word covered by any block marks the cache dirty. Since the blocks executing the store must not be
+   * destroyed, the whole cache is flushed by the next call to `refresh()`. Self-modifying code is rare enough for this
+   * to be cheaper than tracking the blocks per word.
+   *
+   * The storage is allocated on first use. Copies of the cache are empty, since it can always be rebuilt from memory.
+   */
+  class block_cache final
+  {
+  public:
+    static constexpr std::size_t num_words = decode_cache::num_entries;
+
+    /**
+     * @brief Maximum number of instructions in a block
+     */
+    static constexpr std::uint32_t max_block_size = 64;
+
+    block_cache() = default;
+
+    block_cache(const block_cache&)
+      : block_cache{}
+    {
+    }
+
+    block_cache(block_cache&& that) noexcept = default;
+
+    ~block_cache() = default;
+
+    block_cache& operator=(const block_cache&) noexcept
+    {
+      invalidate();
+
+      return *this;
+    }
+
+    block_cache& operator=(block_cache&& that) noexcept = default;
+
+    /**
+     * @brief Returns the index of the block at the given entry address and builds it if necessary
+     *
+     * @param cache decode cache to build the block from
+     * @param mem main memory of the machine
+     * @param address byte address of the first instruction
+     * @return index of the block or `basic_block::npos` if no block can start at the address
+     */
+    template <typename Profile>
+    [[nodiscard]] std::uint32_t find(decode_cache& cache, const memory& mem, address_t address)
+    {
+      if (!is_aligned(address)) [[unlikely]]
+        return basic_block::npos;
+
+      if (!index_) [[unlikely]]
+        allocate();
+
+      std::uint32_t& index = index_[address / sizeof(word_t)];
+
+      if (index == basic_block::npos) [[unlikely]]
+        index = build<Profile>(cache, mem, address);
+
+      return index;
+    }
+
+    /**
+     * @brief Returns the successor of a block if it has been linked for the given address
+     *
+     * @param index index of the block
+     * @param address byte address of the next instruction
+     * @return index of the successor block or `basic_block::npos`
+     */
+    [[nodiscard]] std::uint32_t successor(std::uint32_t index, address_t address) const noexcept
+    {
+      const basic_block& b = blocks_[index];
+      const std::size_t slot = (address == b.end) ? basic_block::fall_through : basic_block::branch;
+
+      return (b.successor_address[slot] == address) ? b.successor[slot] : basic_block::npos;
+    }
+
+    /**
+     * @brief Links a block to its successor
+     *
+     * @param index index of the block
+     * @param address entry address of the successor block
+     * @param next index of the successor block
+     */
+    void link(std::uint32_t index, address_t address, std::uint32_t next) noexcept
+    {
+      basic_block& b = blocks_[index];
+      const std::size_t slot = (address == b.end) ? basic_block::fall_through : basic_block::branch;
+
+      b.successor_address[slot] = address;
+      b.successor[slot] = next;
+    }
+
+    [[nodiscard]] const basic_block& block(std::uint32_t index) const noexcept
+    {
+      return blocks_[index];
+    }
+
+    /**
+     * @brief Returns the decoded instructions of a block
+     */
+    [[nodiscard]] const decoded_instruction* instructions(const basic_block& b) const noexcept
+    {
+      return instructions_.data() + b.first;
+    }
+
+    /**
+     * @brief Marks the cache dirty if the word at the given address is covered by a block
+     *
+     * @param address byte address of the word that has been written
+     */
+    void invalidate(address_t address) noexcept
+    {
+      if (code_.empty())
+        return;
+
+      const std::size_t word = address / sizeof(word_t);
+
+      if ((code_[word / 64] >> (word % 64)) & 0x1)
+        dirty_ = true;
+    }
+
+    /**
+     * @brief Invalidates the whole cache
+     */
+    void invalidate() noexcept
+    {
+      dirty_ = true;
+    }
+
+    /**
+     * @brief Returns whether the cache has been invalidated since the last call to `refresh()`
+     */
+    [[nodiscard]] bool dirty() const noexcept
+    {
+      return dirty_;
+    }
+
+    /**
+     * @brief Returns the number of times the blocks have been flushed
+     *
+     * Code translated from the blocks is valid as long as the generation does not change.
+     */
+    [[nodiscard]] std::uint64_t generation() const noexcept
+    {
+      return generation_;
+    }
+
+    /**
+     * @brief Returns the bitmap of the words covered by any block with one bit per word address
+     *
+     * Behavior is undefined unless a block has been built since the last flush.
+     */
+    [[nodiscard]] const std::uint64_t* code() const noexcept
+    {
+      return code_.data();
+    }
+
+    /**
+     * @brief Flushes all blocks if the cache has been invalidated
+     *
+     * @return true if the blocks have been flushed
+     */
+    bool refresh() noexcept
+    {
+      if (!dirty_)
+        return false;
+
+      if (index_)
+        std::memset(static_cast<void*>(index_.get()), 0xff, num_words * sizeof(std::uint32_t));
+
+      blocks_.clear();
+      instructions_.clear();
+      std::fill(code_.begin(), code_.end(), std::uint64_t{0});
+
+      dirty_ = false;
+      ++generation_;
+
+      return true;
+    }
+
+    /**
+     * @brief Swaps with another cache
+     *
+     * @param that cache to swap with
+     */
+    void swap(block_cache& that) noexcept
+    {
+      using std::swap;
+
+      swap(index_, that.index_);
+      swap(blocks_, that.blocks_);
+      swap(instructions_, that.instructions_);
+      swap(code_, that.code_);
+      swap(dirty_, that.dirty_);
+      swap(generation_, that.generation_);
+    }
+
+  private:
+    /**
+     * @brief Block index per word address, `basic_block::npos` if there is no block yet
+     */
+    std::unique_ptr<std::uint32_t[]> index_;
+
+    std::vector<basic_block> blocks_;
+    std::vector<decoded_instruction> instructions_;
+
+    /**
+     * @brief Bitmap of the words covered by any block including long immediate constants
+     */
+    std::vector<std::uint64_t> code_;
+
+    bool dirty_{false};
+
+    std::uint64_t generation_{0};
+
+    void allocate()
+    {
+      index_ = std::make_unique<std::uint32_t[]>(num_words);
+      std::memset(static_cast<void*>(index_.get()), 0xff, num_words * sizeof(std::uint32_t));
+
+      code_.assign(num_words / 64, 0);
+    }
+
+    void mark(address_t address) noexcept
+    {
+      const std::size_t word = address / sizeof(word_t);
+
+      code_[word / 64] |= std::uint64_t{1} << (word % 64);
+    }
+
+    template <typename Profile>
+    [[nodiscard]] std::uint32_t build(decode_cache& cache, const memory& mem, address_t entry)
+    {
+      basic_block b{};
+      b.entry = entry;
+      b.first = static_cast<std::uint32_t>(instructions_.size());
+
+      address_t address = entry;
+
+      while (b.size < max_block_size)
+      {
+        const decoded_instruction instr = cache.get<Profile>(mem, address);
+
+        // Instructions which cannot be executed in decoded form are executed outside of blocks
+        if (instr.form == operand_form::fallback)
+          break;
+
+        instructions_.push_back(instr);
+        ++b.size;
+
+        mark(address);
+
+        if (instr.long_immediate())
+          mark(static_cast<address_t>(address + sizeof(word_t)));
+
+        const auto next = static_cast<address_t>(address + instr.size());
+
+        // Wrapping around the end of the address space also ends the block
+        if (ends_block(instr) || (next < address))
+        {
+          address = next;
+          break;
+        }
+
+        address = next;
+      }
+
+      if (b.size == 0)
+        return basic_block::npos;
+
+      b.end = address;
+
+      blocks_.push_back(b);
+
+      return static_cast<std::uint32_t>(blocks_.size() - 1);
+    }
+  };
+
+  /**
+   * @brief Swaps two caches
+   *
+   * @param lhs first cache
+   * @param rhs second cache
+   */
+  inline void swap(block_cache& lhs, block_cache& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
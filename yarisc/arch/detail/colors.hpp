@@ -8,10 +8,10 @@
 
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
 #include <array>
 #include <cstddef>
-#include <iosfwd>
 #include <string_view>
 #include <utility>
 
@@ -21,9 +21,9 @@ namespace yarisc::arch::detail
   {
   };
 
-  inline std::ostream& operator<<(std::ostream& os, color_noop) noexcept
+  inline utils::text_buffer& operator<<(utils::text_buffer& buf, color_noop) noexcept
   {
-    return os;
+    return buf;
   }
 
   inline constexpr std::array<std::pair<std::string_view, bool>, num_registers> register_background_colors{{
@@ -0,0 +1,675 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_DECODE_HPP
+#define YARISC_ARCH_DETAIL_DECODE_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define YARISC_ARCH_ALWAYS_INLINE __forceinline
+#define YARISC_ARCH_NOINLINE __declspec(noinline)
+#else
+#define YARISC_ARCH_ALWAYS_INLINE inline __attribute__((always_inline))
+#define YARISC_ARCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace yarisc::arch::detail
+{
+  enum class invalid_instruction_reason : int
+  {
+    non_zero_no_operands = 0,
+    non_zero_one_operand = 1,
+    non_zero_reg_two_operands = 2,
+    non_zero_st_two_operands = 3,
+    non_zero_unassigned_three_operands = 4,
+    non_zero_unassigned_cond_operands = 5,
+    non_zero_jump_addr_operands = 6,
+    assignment_two_operands = 7,
+  };
+
+  /**
+   * @brief Checks the instruction word for invalid bits as done in strict execution mode
+   *
+   * @param type instruction type of the opcode of the instruction word
+   * @param instr instruction word
+   * @return reason why the instruction is invalid or an empty optional if the instruction word is valid
+   */
+  [[nodiscard]] inline constexpr std::optional<invalid_instruction_reason> check_instruction_bits(
+    optype type, word_t instr) noexcept
+  {
+    switch (type)
+    {
+    case optype::basic:
+    {
+      if (instr & operand_mask)
+        return invalid_instruction_reason::non_zero_no_operands;
+    }
+    break;
+
+    case optype::op0:
+    {
+      if (instr & (operand_op1_mask | operand_op2_mask))
+        return invalid_instruction_reason::non_zero_one_operand;
+    }
+    break;
+
+    case optype::op0_op1:
+    {
+      if (instr & operand_sel_mask)
+      {
+        if (instr & operand_as_mask)
+          return invalid_instruction_reason::assignment_two_operands;
+        else if ((instr & operand_loc_mask) && (instr & operand_st_mask))
+          return invalid_instruction_reason::non_zero_st_two_operands;
+      }
+      else
+      {
+        if (instr & operand_op2_mask)
+          return invalid_instruction_reason::non_zero_reg_two_operands;
+      }
+    }
+    break;
+
+    case optype::op0_op1_op2:
+    {
+      if ((instr & operand_imm_invalid_mask) == operand_imm_invalid_mask)
+        return invalid_instruction_reason::non_zero_unassigned_three_operands;
+    }
+    break;
+
+    case optype::jump:
+    {
+      if ((instr & operand_addr_loc_mask) && (instr & operand_addr_mask))
+        return invalid_instruction_reason::non_zero_jump_addr_operands;
+    }
+    break;
+
+    case optype::cond_jump:
+    {
+      if ((instr & operand_addr_loc_mask) && (instr & operand_cond_addr_mask))
+        return invalid_instruction_reason::non_zero_jump_addr_operands;
+      if ((instr & operand_cond_invalid_mask) == operand_cond_invalid_mask)
+        return invalid_instruction_reason::non_zero_unassigned_cond_operands;
+    }
+    break;
+    }
+
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Location of the operands of a decoded instruction
+   */
+  enum class operand_form : std::uint8_t
+  {
+    /**
+     * @brief The instruction has not been decoded yet
+     */
+    empty = 0,
+
+    /**
+     * @brief The instruction has to be executed by the reference interpreter
+     *
+     * This is used for unsupported opcodes, which need the reference interpreter to raise a panic.
+     */
+    fallback,
+
+    /**
+     * @brief All operands are registers, or there are no operands
+     */
+    registers,
+
+    /**
+     * @brief The operand `op1` is the immediate constant
+     */
+    immediate_op1,
+
+    /**
+     * @brief The operand `op2` is the immediate constant (three operand instructions only)
+     */
+    immediate_op2,
+
+    /**
+     * @brief The immediate constant is the jump address
+     */
+    address,
+  };
+
+  /**
+   * @brief Opcode of the instruction that follows a decoded instruction in a fused pair
+   */
+  enum class fusion : std::uint8_t
+  {
+    none = 0,
+    cond_jump = 1,
+    store = 2,
+    add_with_carry = 3,
+  };
+
+  /**
+   * @brief Instruction in a compact decoded form
+   *
+   * All masking, shifting, and sign-extension is done once during decoding. The register operands are stored as
+   * register indices, which have already been resolved according to the operand assignment flag `as`. For conditional
+   * jumps `op0` holds the status flags to test and `op1` the negate flag.
+   */
+  struct decoded_instruction final
+  {
+    static constexpr std::uint8_t long_attr = 0x1;
+    static constexpr std::uint8_t valid_attr = 0x2;
+    static constexpr std::uint8_t fusion_mask = 0xc;
+    static constexpr std::size_t fusion_offset = 2;
+
+    /**
+     * @brief Opcode of the instruction
+     */
+    std::uint8_t code{0};
+
+    /**
+     * @brief Location of the operands
+     */
+    operand_form form{operand_form::empty};
+
+    /**
+     * @brief Register indices of the operands
+     */
+    std::uint8_t op0{0};
+    std::uint8_t op1{0};
+    std::uint8_t op2{0};
+
+    /**
+     * @brief Attribute bits `long_attr` and `valid_attr` and the fusion in `fusion_mask`
+     */
+    std::uint8_t attr{0};
+
+    /**
+     * @brief Immediate constant or jump address
+     */
+    word_t imm{0};
+
+    [[nodiscard]] opcode get_opcode() const noexcept
+    {
+      return static_cast<opcode>(code);
+    }
+
+    /**
+     * @brief Returns whether the immediate constant is stored in the word following the instruction word
+     */
+    [[nodiscard]] bool long_immediate() const noexcept
+    {
+      return (attr & long_attr);
+    }
+
+    /**
+     * @brief Returns whether the instruction passes the checks of strict execution mode
+     */
+    [[nodiscard]] bool valid() const noexcept
+    {
+      return (attr & valid_attr);
+    }
+
+    /**
+     * @brief Returns the instruction the decode cache has found to follow this instruction in a fused pair
+     *
+     * The fusion is a hint for the dispatch, which still checks the following instruction when it is fetched.
+     */
+    [[nodiscard]] fusion fused() const noexcept
+    {
+      return static_cast<fusion>((attr & fusion_mask) >> fusion_offset);
+    }
+
+    /**
+     * @brief Returns the size of the instruction in bytes
+     */
+    [[nodiscard]] address_t size() const noexcept
+    {
+      return long_immediate() ? 2 * sizeof(word_t) : sizeof(word_t);
+    }
+
+    [[nodiscard]] bool operator==(const decoded_instruction& that) const noexcept = default;
+  };
+
+  static_assert(sizeof(decoded_instruction) == 8);
+
+  [[nodiscard]] inline constexpr std::uint8_t operand_index(word_t instr, word_t mask, std::size_t offset) noexcept
+  {
+    return static_cast<std::uint8_t>((instr & mask) >> offset);
+  }
+
+  /**
+   * @brief Decodes the instruction word
+   *
+   * If the instruction has a long immediate constant, the attribute `long_attr` is set and the caller has to fill in
+   * `imm` from the following word.
+   *
+   * @param instr instruction word
+   * @return the decoded instruction
+   */
+  template <typename Profile>
+  [[nodiscard]] constexpr decoded_instruction decode_instruction(word_t instr) noexcept
+  {
+    const auto code = static_cast<std::size_t>(instr & opcode_mask);
+    const instruction_descriptor& desc = instruction_table[code];
+
+    decoded_instruction result{};
+    result.code = static_cast<std::uint8_t>(code);
+
+    if (desc.mnemonic.empty() ||
+        (static_cast<feature_level_t>(desc.level) > static_cast<feature_level_t>(Profile::level)))
+    {
+      result.form = operand_form::fallback;
+
+      return result;
+    }
+
+    if (!check_instruction_bits(desc.type, instr))
+      result.attr |= decoded_instruction::valid_attr;
+
+    const auto op0 = operand_index(instr, operand_op0_mask, operand_op0_offset);
+    const auto op1 = operand_index(instr, operand_op1_mask, operand_op1_offset);
+    const auto op2 = operand_index(instr, operand_op2_mask, operand_op2_offset);
+
+    const auto short_immediate = [instr]()
+    { return unpack_signed(instr, operand_st_mask, operand_st_sign_mask, operand_st_offset); };
+
+    switch (desc.type)
+    {
+    case optype::basic:
+    {
+      result.form = operand_form::registers;
+    }
+    break;
+
+    case optype::op0:
+    {
+      result.form = operand_form::registers;
+      result.op0 = op0;
+    }
+    break;
+
+    case optype::op0_op1:
+    {
+      result.op0 = op0;
+
+      if (instr & operand_sel_mask)
+      {
+        result.form = operand_form::immediate_op1;
+
+        if (instr & operand_loc_mask)
+          result.attr |= decoded_instruction::long_attr;
+        else
+          result.imm = short_immediate();
+      }
+      else
+      {
+        result.form = operand_form::registers;
+        result.op1 = op1;
+      }
+    }
+    break;
+
+    case optype::op0_op1_op2:
+    {
+      result.op0 = op0;
+
+      if (instr & operand_sel_mask)
+      {
+        // The remaining register is `op0` for short and the register in `op1` for long immediate constants
+        std::uint8_t remaining = op0;
+
+        if (instr & operand_loc_mask)
+        {
+          result.attr |= decoded_instruction::long_attr;
+          remaining = op1;
+        }
+        else
+        {
+          result.imm = short_immediate();
+        }
+
+        if (instr & operand_as_mask)
+        {
+          result.form = operand_form::immediate_op2;
+          result.op1 = remaining;
+        }
+        else
+        {
+          result.form = operand_form::immediate_op1;
+          result.op2 = remaining;
+        }
+      }
+      else
+      {
+        result.form = operand_form::registers;
+        result.op1 = op1;
+        result.op2 = op2;
+      }
+    }
+    break;
+
+    case optype::jump:
+    {
+      result.form = operand_form::address;
+
+      if (instr & operand_addr_loc_mask)
+        result.attr |= decoded_instruction::long_attr;
+      else
+        result.imm = unpack_signed(instr, operand_addr_mask, operand_addr_sign_mask, operand_addr_offset);
+    }
+    break;
+
+    case optype::cond_jump:
+    {
+      result.form = operand_form::address;
+      result.op0 = operand_index(instr, operand_cond_flag_mask, operand_cond_flag_offset);
+      result.op1 = (instr & operand_cond_neg_mask) ? 1 : 0;
+
+      if (instr & operand_addr_loc_mask)
+        result.attr |= decoded_instruction::long_attr;
+      else
+        result.imm = unpack_signed(instr, operand_cond_addr_mask, operand_cond_addr_sign_mask, operand_cond_addr_offset);
+    }
+    break;
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Table of all instruction words decoded for a feature level
+   *
+   * Instruction words are only 16 bits wide, so decoding is a single load from the table. The tables of the supported
+   * feature levels are built once at startup.
+   */
+  class decode_table final
+  {
+  public:
+    static constexpr std::size_t num_entries = static_cast<std::size_t>(std::numeric_limits<word_t>::max()) + 1;
+
+    template <typename Profile>
+    explicit decode_table(std::type_identity<Profile>) noexcept
+    {
+      for (std::size_t i = 0; i < num_entries; ++i)
+        entries_[i] = decode_instruction<Profile>(static_cast<word_t>(i));
+    }
+
+    decode_table(const decode_table&) = delete;
+
+    decode_table& operator=(const decode_table&) = delete;
+
+    /**
+     * @brief Returns the decoded instruction word
+     *
+     * The immediate constant of an instruction with `long_attr` has to be filled in from the following word.
+     */
+    [[nodiscard]] const decoded_instruction& operator[](word_t instr) const noexcept
+    {
+      return entries_[instr];
+    }
+
+  private:
+    std::array<decoded_instruction, num_entries> entries_;
+  };
+
+  extern YARISC_ARCH_EXPORT const decode_table decode_table_min;
+  extern YARISC_ARCH_EXPORT const decode_table decode_table_v1;
+
+  /**
+   * @brief Returns the decode table of a profile
+   */
+  template <typename Profile>
+  [[nodiscard]] inline const decode_table& decode_table_of() noexcept
+  {
+    if constexpr (Profile::level == feature_level::min)
+    {
+      return decode_table_min;
+    }
+    else
+    {
+      static_assert(Profile::level == feature_level::v1, "No decode table for the feature level");
+
+      return decode_table_v1;
+    }
+  }
+
+  /**
+   * @brief Returns the fusion of two consecutive decoded instructions
+   *
+   * The hot pairs are an addition followed by a conditional jump as in count down loops, a load followed by a store as
+   * in copy loops, and additions followed by an addition with carry as in multiword arithmetic. Longer chains of
+   * additions with carry consist of overlapping pairs. The first instruction must not write the instruction pointer,
+   * so the second one is always executed next unless the execution stops in between.
+   *
+   * @param first decoded instruction
+   * @param second decoded instruction following the first one
+   * @return the fusion of the pair or `fusion::none`
+   */
+  [[nodiscard]] inline constexpr fusion fusion_of(
+    const decoded_instruction& first, const decoded_instruction& second) noexcept
+  {
+    constexpr std::uint8_t ip_index = 7;
+
+    if ((first.form == operand_form::fallback) || (second.form == operand_form::fallback) || (first.op0 == ip_index))
+      return fusion::none;
+
+    switch (first.get_opcode())
+    {
+    case opcode::add:
+    case opcode::add_with_carry:
+      if (second.get_opcode() == opcode::cond_jump)
+        return fusion::cond_jump;
+      if (second.get_opcode() == opcode::add_with_carry)
+        return fusion::add_with_carry;
+      break;
+    case opcode::load:
+      if (second.get_opcode() == opcode::store)
+        return fusion::store;
+      break;
+    default:
+      break;
+    }
+
+    return fusion::none;
+  }
+
+  /**
+   * @brief Cache of decoded instructions keyed by word address
+   *
+   * The cache covers the whole address space of the machine and requires the main memory to have the maximum size.
+   * Entries are decoded on first use and invalidated by stores to the instruction word or to the word following it,
+   * because it may hold a long immediate constant. Decoding also records the fusion with the following instruction,
+   * which may become stale after a long instruction, since it is only a hint.
+   *
+   * Copies of the cache are empty, since the cache can always be rebuilt from memory.
+   */
+  class decode_cache final
+  {
+  public:
+    static constexpr std::size_t num_entries =
+      (static_cast<std::size_t>(std::numeric_limits<address_t>::max()) + 1) / sizeof(word_t);
+
+    decode_cache()
+      : entries_{std::make_unique<decoded_instruction[]>(num_entries)}
+    {
+    }
+
+    decode_cache(const decode_cache&)
+      : decode_cache{}
+    {
+    }
+
+    decode_cache(decode_cache&& that) noexcept = default;
+
+    ~decode_cache() = default;
+
+    decode_cache& operator=(const decode_cache&)
+    {
+      if (!entries_)
+        entries_ = std::make_unique<decoded_instruction[]>(num_entries);
+      else
+        invalidate();
+
+      return *this;
+    }
+
+    decode_cache& operator=(decode_cache&& that) noexcept = default;
+
+    /**
+     * @brief Returns the decoded instruction at the given address
+     *
+     * Behavior is undefined unless the address is word-aligned.
+     *
+     * @param mem main memory of the machine
+     * @param address byte address of the instruction word
+     * @return the decoded instruction
+     */
+    template <typename Profile>
+    [[nodiscard]] const decoded_instruction& get(const memory& mem, address_t address) noexcept
+    {
+      assert(is_aligned(address));
+      assert(mem.size() == num_entries * sizeof(word_t));
+
+      decoded_instruction& entry = entries_[address / sizeof(word_t)];
+
+      if (entry.form == operand_form::empty) [[unlikely]]
+        decode<Profile>(entry, mem, address);
+
+      return entry;
+    }
+
+    /**
+     * @brief Returns the entries indexed by word address
+     *
+     * Translated code invalidates the entries in place, see `invalidate(address_t)`.
+     */
+    [[nodiscard]] decoded_instruction* data() noexcept
+    {
+      return entries_.get();
+    }
+
+    /**
+     * @brief Invalidates all entries that depend on the word at the given address
+     *
+     * @param address byte address of the word that has been written
+     */
+    void invalidate(address_t address) noexcept
+    {
+      constexpr std::size_t index_mask = num_entries - 1;
+
+      const std::size_t index = address / sizeof(word_t);
+
+      entries_[index].form = operand_form::empty;
+      entries_[(index - 1) & index_mask].form = operand_form::empty;
+    }
+
+    /**
+     * @brief Invalidates the whole cache
+     *
+     * The entries are cleared lazily by the next call to `refresh()`.
+     */
+    void invalidate() noexcept
+    {
+      stale_ = true;
+    }
+
+    /**
+     * @brief Clears all entries if the whole cache has been invalidated
+     */
+    void refresh() noexcept
+    {
+      if (stale_)
+      {
+        if (entries_)
+          std::memset(static_cast<void*>(entries_.get()), 0, num_entries * sizeof(decoded_instruction));
+
+        stale_ = false;
+      }
+    }
+
+    /**
+     * @brief Swaps with another cache
+     *
+     * @param that cache to swap with
+     */
+    void swap(decode_cache& that) noexcept
+    {
+      using std::swap;
+
+      swap(entries_, that.entries_);
+      swap(stale_, that.stale_);
+    }
+
+  private:
+    /**
+     * @brief Decodes an entry on a cache miss
+     *
+     * The miss path is kept out of line so that the lookup is inlined into the dispatch loops.
+     */
+    template <typename Profile>
+    YARISC_ARCH_NOINLINE static void decode(
+      decoded_instruction& entry, const memory& mem, address_t address) noexcept
+    {
+      const decode_table& table = decode_table_of<Profile>();
+
+      entry = table[mem.load(address)];
+
+      if (entry.long_immediate())
+        entry.imm = mem.load(static_cast<address_t>(address + sizeof(word_t)));
+
+      switch (entry.get_opcode())
+      {
+      case opcode::load:
+      case opcode::add:
+      case opcode::add_with_carry:
+      {
+        const decoded_instruction& next = table[mem.load(static_cast<address_t>(address + entry.size()))];
+
+        entry.attr |= static_cast<std::uint8_t>(static_cast<std::uint8_t>(fusion_of(entry, next))
+                                                << decoded_instruction::fusion_offset);
+      }
+      break;
+      default:
+        break;
+      }
+    }
+
+    std::unique_ptr<decoded_instruction[]> entries_;
+
+    bool stale_{false};
+  };
+
+  static_assert(is_aligned(decode_cache::num_entries));
+
+  /**
+   * @brief Swaps two caches
+   *
+   * @param lhs first cache
+   * @param rhs second cache
+   */
+  inline void swap(decode_cache& lhs, decode_cache& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
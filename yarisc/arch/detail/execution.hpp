@@ -7,15 +7,20 @@
 #define YARISC_ARCH_DETAIL_EXECUTION_HPP
 
 #include <yarisc/arch/debugger.hpp>
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
 #include <yarisc/arch/detail/hex_word.hpp>
+#include <yarisc/arch/detail/jit_cache.hpp>
 #include <yarisc/arch/instructions.hpp>
 #include <yarisc/arch/machine_model.hpp>
 #include <yarisc/arch/machine_profile.hpp>
 #include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/monitor.hpp>
 #include <yarisc/arch/registers.hpp>
 #include <yarisc/arch/types.hpp>
 
 #include <array>
+#include <cassert>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -61,26 +66,15 @@ namespace yarisc::arch::detail
   {
     template <typename Policy>
     [[nodiscard]] static execute_result execute(
-      Policy&, machine_registers& reg, machine_memory&, word_t& op0, word_t op1, word_t op2) noexcept
+      Policy& policy, machine_registers& reg, machine_memory&, word_t& op0, word_t op1, word_t op2) noexcept
     {
       static_assert(status_register::carry_flag == 0x1);
 
-      const auto result = Op{}(op1, op2, reg.status.s & status_register::carry_flag);
-      const auto result_word = static_cast<word_t>(result);
+      const auto result = Op{}(op1, op2, policy.status(reg) & status_register::carry_flag);
 
-      reg.status.s = (result_word == 0x0) ? status_register::zero_flag : 0x0;
+      policy.update_alu_flags(reg, result);
 
-      using result_type = std::decay_t<decltype(result)>;
-
-      if constexpr (sizeof(result_type) > sizeof(word_t))
-      {
-        constexpr auto carry_bit_offset = 8 * sizeof(word_t);
-        constexpr auto carry_bit_mask = static_cast<result_type>(1 << carry_bit_offset);
-
-        reg.status.s |= static_cast<word_t>((result & carry_bit_mask) >> carry_bit_offset);
-      }
-
-      op0 = result_word;
+      op0 = static_cast<word_t>(result);
 
       return {};
     }
@@ -104,9 +98,9 @@ namespace yarisc::arch::detail
   {
     template <typename Policy>
     [[nodiscard]] static execute_result execute(
-      Policy&, machine_registers& reg, machine_memory&, word_t& op0, word_t op1) noexcept
+      Policy& policy, machine_registers& reg, machine_memory&, word_t& op0, word_t op1) noexcept
     {
-      return update_zero_flag(reg, op0 = op1);
+      return policy.update_zero_flag(reg, op0 = op1);
     }
   };
 
@@ -117,7 +111,16 @@ namespace yarisc::arch::detail
     [[nodiscard]] static execute_result execute(
       Policy& policy, machine_registers& reg, machine_memory& mem, word_t& op0, word_t op1)
     {
-      return update_zero_flag(reg, op0, policy.load(mem, static_cast<address_t>(op1), op0));
+      const execute_result result = policy.load(mem, static_cast<address_t>(op1), op0);
+
+      // A watchpoint stops before the load, which must not change the flags either
+      if constexpr (Policy::debug_policy::enabled)
+      {
+        if (result.breakpoint) [[unlikely]]
+          return result;
+      }
+
+      return policy.update_zero_flag(reg, op0, result);
     }
   };
 
@@ -150,9 +153,9 @@ namespace yarisc::arch::detail
   {
     template <typename Policy>
     [[nodiscard]] static execute_result execute(
-      Policy&, machine_registers& reg, machine_memory&, address_t address, word_t flags, bool negate) noexcept
+      Policy& policy, machine_registers& reg, machine_memory&, address_t address, word_t flags, bool negate) noexcept
     {
-      const auto cond = static_cast<bool>(reg.status.s & flags);
+      const auto cond = static_cast<bool>(policy.status(reg) & flags);
 
       if (!cond != !negate)
         reg.named.set_ip(static_cast<word_t>(address));
@@ -181,18 +184,6 @@ namespace yarisc::arch::detail
     }
   };
 
-  enum class invalid_instruction_reason : int
-  {
-    non_zero_no_operands = 0,
-    non_zero_one_operand = 1,
-    non_zero_reg_two_operands = 2,
-    non_zero_st_two_operands = 3,
-    non_zero_unassigned_three_operands = 4,
-    non_zero_unassigned_cond_operands = 5,
-    non_zero_jump_addr_operands = 6,
-    assignment_two_operands = 7,
-  };
-
   [[nodiscard]] inline std::string instruction_error(const machine_registers& reg, word_t instr)
   {
     using namespace std::string_view_literals;
@@ -242,14 +233,54 @@ namespace yarisc::arch::detail
       store_panic_or_throw(debugger_, std::move(msg));
     }
 
-    [[nodiscard]] inline bool breakpoint(address_t /* address */) const noexcept
+    [[nodiscard]] inline bool breakpoint(address_t address) const noexcept
     {
-      return false;
+      return debugger_ && debugger_->breakpoint(address);
     }
 
-    [[nodiscard]] inline bool data_breakpoint(address_t /* address */, word_t /* value */) const noexcept
+    /**
+     * @brief Evaluates the condition of a breakpoint, which has been hit by `breakpoint()`
+     */
+    [[nodiscard]] inline bool stop_at(
+      address_t address, const machine_registers& reg, const memory& mem) const noexcept
     {
-      return false;
+      return debugger_->stop_at(address, reg, mem);
+    }
+
+    /**
+     * @brief Returns whether any instruction in the address range has a breakpoint
+     */
+    [[nodiscard]] inline bool breakpoint_in(address_t address, std::size_t size) const noexcept
+    {
+      return debugger_ && debugger_->breakpoint_in(address, size);
+    }
+
+    [[nodiscard]] inline bool has_breakpoints() const noexcept
+    {
+      return debugger_ && debugger_->has_breakpoints();
+    }
+
+    [[nodiscard]] inline bool has_watchpoints() const noexcept
+    {
+      return debugger_ && debugger_->has_watchpoints();
+    }
+
+    [[nodiscard]] inline bool watch_read(address_t address, word_t value) const
+    {
+      return debugger_ && debugger_->watch_read(address, value);
+    }
+
+    [[nodiscard]] inline bool watch_write(address_t address, word_t value) const
+    {
+      return debugger_ && debugger_->watch_write(address, value);
+    }
+
+    /**
+     * @brief Returns whether the breakpoint result of a load or store comes from a watchpoint rather than a panic
+     */
+    [[nodiscard]] inline bool watchpoint_hit() const noexcept
+    {
+      return debugger_ && debugger_->hit();
     }
   };
 
@@ -283,18 +314,155 @@ namespace yarisc::arch::detail
     static constexpr bool enabled = false;
   };
 
-  template <typename Profile, typename Debug, typename Strict>
+  struct cache_execution_policy final
+  {
+    static constexpr bool enabled = true;
+
+    decode_cache* cache_;
+    block_cache* blocks_;
+    jit_cache* jit_;
+
+    template <typename Profile>
+    [[nodiscard]] inline const decoded_instruction& get(const machine_memory& mem, address_t address) noexcept
+    {
+      return cache_->get<Profile>(mem.main, address);
+    }
+
+    inline void invalidate(address_t address) noexcept
+    {
+      cache_->invalidate(address);
+      blocks_->invalidate(address);
+    }
+  };
+
+  struct noop_cache_execution_policy final
+  {
+    static constexpr bool enabled = false;
+  };
+
+  /**
+   * @brief Defers the evaluation of the status flags until the status register is read
+   *
+   * Only conditional jumps and additions with carry read the status register, while every move, load, and addition
+   * writes it. Therefore the policy keeps the status register split into the value which decides the zero flag and the
+   * remaining bits. A move or load just records its value, and an addition records its result and its carry.
+   *
+   * The status register of the machine is stale while the policy is used, see `flags_scope`.
+   */
+  struct lazy_flags_execution_policy final
+  {
+    static constexpr bool enabled = true;
+
+    /**
+     * @brief Value of the last move, load, or addition, the zero flag is set if it is zero
+     */
+    word_t value_{0};
+
+    /**
+     * @brief Status register without the zero flag
+     */
+    word_t rest_{0};
+
+    inline void load(const status_register& status) noexcept
+    {
+      value_ = (status.s & status_register::zero_flag) ? 0x0 : 0x1;
+      rest_ = status.s & ~status_register::zero_flag;
+    }
+
+    inline void store(status_register& status) const noexcept
+    {
+      status.s = get();
+    }
+
+    [[nodiscard]] inline word_t get() const noexcept
+    {
+      return rest_ | ((value_ == 0x0) ? status_register::zero_flag : 0x0);
+    }
+  };
+
+  struct eager_flags_execution_policy final
+  {
+    static constexpr bool enabled = false;
+  };
+
+  /**
+   * @brief Passes the fetches, loads, stores, and retired instructions of the reference interpreter on to a monitor
+   */
+  struct monitor_execution_policy final
+  {
+    static constexpr bool enabled = true;
+
+    execution_monitor* monitor_;
+
+    inline void fetch(address_t address, word_t word) noexcept
+    {
+      monitor_->fetch(address, word);
+    }
+
+    inline void load(address_t address, word_t value) noexcept
+    {
+      monitor_->load(address, value);
+    }
+
+    inline void store(address_t address, word_t value) noexcept
+    {
+      monitor_->store(address, value);
+    }
+
+    inline void retire(const machine_registers& reg, bool retired) noexcept
+    {
+      monitor_->retire(reg, retired);
+    }
+  };
+
+  struct noop_monitor_execution_policy final
+  {
+    static constexpr bool enabled = false;
+  };
+
+  template <
+    typename Profile,
+    typename Debug,
+    typename Strict,
+    typename Cache = noop_cache_execution_policy,
+    typename Flags = eager_flags_execution_policy,
+    typename Monitor = noop_monitor_execution_policy>
   struct execution_policy final
   {
     using profile_type = Profile;
 
     using debug_policy = Debug;
     using strict_policy = Strict;
+    using cache_policy = Cache;
+    using flags_policy = Flags;
+    using monitor_policy = Monitor;
 
     [[no_unique_address]] debug_policy debug{};
     [[no_unique_address]] strict_policy strict{};
+    [[no_unique_address]] cache_policy cache{};
+    [[no_unique_address]] flags_policy flags{};
+    [[no_unique_address]] monitor_policy monitor{};
+
+    /**
+     * @brief Returns whether execution stops at a breakpoint before the instruction at the address
+     *
+     * Only addresses with a breakpoint evaluate its condition, which may read the status register.
+     */
+    [[nodiscard]] inline bool breakpoint(
+      address_t address, machine_registers& reg, const machine_memory& mem) noexcept
+    {
+      if (!debug.breakpoint(address)) [[likely]]
+        return false;
 
-    [[nodiscard]] inline execute_result load(const machine_memory& mem, address_t address, word_t& dst)
+      store_flags(reg);
+
+      return debug.stop_at(address, reg, mem.main);
+    }
+
+    /**
+     * @brief Loads an instruction word, which is not checked against the watchpoints
+     */
+    [[nodiscard]] inline execute_result fetch(const machine_memory& mem, address_t address, word_t& dst)
     {
       if constexpr (strict_policy::enabled)
       {
@@ -304,6 +472,33 @@ namespace yarisc::arch::detail
 
       dst = mem.main.load(address);
 
+      if constexpr (monitor_policy::enabled)
+        monitor.fetch(address, dst);
+
+      return {};
+    }
+
+    [[nodiscard]] inline execute_result load(const machine_memory& mem, address_t address, word_t& dst)
+    {
+      if constexpr (strict_policy::enabled)
+      {
+        if (!strict.check_address(mem, address)) [[unlikely]]
+          return panic(address_error(address, "read"));
+      }
+
+      const word_t value = mem.main.load(address);
+
+      if constexpr (debug_policy::enabled)
+      {
+        if (debug.watch_read(address, value)) [[unlikely]]
+          return breakpoint_result;
+      }
+
+      dst = value;
+
+      if constexpr (monitor_policy::enabled)
+        monitor.load(address, value);
+
       return {};
     }
 
@@ -317,77 +512,97 @@ namespace yarisc::arch::detail
 
       if constexpr (debug_policy::enabled)
       {
-        if (debug.data_breakpoint(address, value)) [[unlikely]]
+        if (debug.watch_write(address, value)) [[unlikely]]
           return breakpoint_result;
       }
 
       mem.main.store(address, value);
 
+      if constexpr (cache_policy::enabled)
+        cache.invalidate(address);
+
+      if constexpr (monitor_policy::enabled)
+        monitor.store(address, value);
+
       return {};
     }
 
+    /**
+     * @brief Updates the zero flag for the value written by a move or load
+     */
+    inline execute_result update_zero_flag(machine_registers& reg, word_t value, execute_result result = {}) noexcept
+    {
+      if constexpr (flags_policy::enabled)
+      {
+        flags.value_ = value;
+
+        return result;
+      }
+      else
+      {
+        return detail::update_zero_flag(reg, value, result);
+      }
+    }
+
+    /**
+     * @brief Sets the zero and carry flags for the result of an addition, all other flags are cleared
+     */
+    inline void update_alu_flags(machine_registers& reg, double_word_t result) noexcept
+    {
+      constexpr auto carry_bit_offset = 8 * sizeof(word_t);
+
+      static_assert(status_register::carry_flag == 0x1);
+
+      if constexpr (flags_policy::enabled)
+      {
+        flags.value_ = static_cast<word_t>(result);
+        flags.rest_ = static_cast<word_t>(result >> carry_bit_offset);
+      }
+      else
+      {
+        reg.status.s = (static_cast<word_t>(result) == 0x0) ? status_register::zero_flag : 0x0;
+        reg.status.s |= static_cast<word_t>(result >> carry_bit_offset);
+      }
+    }
+
+    /**
+     * @brief Returns the status register
+     */
+    [[nodiscard]] inline word_t status(const machine_registers& reg) const noexcept
+    {
+      if constexpr (flags_policy::enabled)
+        return flags.get();
+      else
+        return reg.status.s;
+    }
+
+    /**
+     * @brief Writes the lazily evaluated flags to the status register of the machine
+     */
+    inline void store_flags(machine_registers& reg) const noexcept
+    {
+      if constexpr (flags_policy::enabled)
+        flags.store(reg.status);
+    }
+
+    /**
+     * @brief Reads the lazily evaluated flags from the status register of the machine
+     */
+    inline void load_flags(const machine_registers& reg) noexcept
+    {
+      if constexpr (flags_policy::enabled)
+        flags.load(reg.status);
+    }
+
     [[nodiscard]] inline execute_result check(std::pair<execute_result, optype> result, [[maybe_unused]] word_t instr)
     {
       if constexpr (strict_policy::enabled)
       {
-        if (!debug.has_panic()) [[likely]]
+        // The reason is only looked up for the rare invalid instruction words
+        if (!decode_table_of<Profile>()[instr].valid() && !debug.has_panic()) [[unlikely]]
         {
-          switch (result.second)
-          {
-          case optype::basic:
-          {
-            if (instr & operand_mask) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_no_operands));
-          }
-          break;
-
-          case optype::op0:
-          {
-            if (instr & (operand_op1_mask | operand_op2_mask)) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_one_operand));
-          }
-          break;
-
-          case optype::op0_op1:
-          {
-            if (instr & operand_sel_mask)
-            {
-              if (instr & operand_as_mask) [[unlikely]]
-                return panic(nonzero_error(instr, invalid_instruction_reason::assignment_two_operands));
-              else if ((instr & operand_loc_mask) && (instr & operand_st_mask)) [[unlikely]]
-                return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_st_two_operands));
-            }
-            else
-            {
-              if (instr & operand_op2_mask) [[unlikely]]
-                return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_reg_two_operands));
-            }
-          }
-          break;
-
-          case optype::op0_op1_op2:
-          {
-            if ((instr & operand_imm_invalid_mask) == operand_imm_invalid_mask) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_unassigned_three_operands));
-          }
-          break;
-
-          case optype::jump:
-          {
-            if ((instr & operand_addr_loc_mask) && (instr & operand_addr_mask)) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_jump_addr_operands));
-          }
-          break;
-
-          case optype::cond_jump:
-          {
-            if ((instr & operand_addr_loc_mask) && (instr & operand_cond_addr_mask)) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_jump_addr_operands));
-            if ((instr & operand_cond_invalid_mask) == operand_cond_invalid_mask) [[unlikely]]
-              return panic(nonzero_error(instr, invalid_instruction_reason::non_zero_unassigned_cond_operands));
-          }
-          break;
-          }
+          if (const auto reason = check_instruction_bits(result.second, instr))
+            return panic(nonzero_error(instr, *reason));
         }
       }
 
@@ -408,6 +623,64 @@ namespace yarisc::arch::detail
     return {std::move(debug), std::move(strict)};
   }
 
+  template <typename Profile, typename Debug, typename Strict, typename Cache>
+  [[nodiscard]] execution_policy<Profile, Debug, Strict, Cache> make_execution_policy(
+    Debug debug, Strict strict, Cache cache)
+  {
+    return {std::move(debug), std::move(strict), std::move(cache)};
+  }
+
+  /**
+   * @brief Returns the policy with a monitor, which must be executed by the reference interpreter
+   */
+  template <typename Profile, typename Debug, typename Strict, typename Cache>
+  [[nodiscard]] execution_policy<Profile, Debug, Strict, Cache, eager_flags_execution_policy, monitor_execution_policy>
+    make_execution_policy(Debug debug, Strict strict, Cache cache, monitor_execution_policy monitor)
+  {
+    return {std::move(debug), std::move(strict), std::move(cache), {}, std::move(monitor)};
+  }
+
+  /**
+   * @brief Returns the policy with lazily evaluated status flags
+   */
+  template <typename Profile, typename Debug, typename Strict, typename Cache>
+  [[nodiscard]] execution_policy<Profile, Debug, Strict, Cache, lazy_flags_execution_policy> make_lazy_flags_policy(
+    execution_policy<Profile, Debug, Strict, Cache> policy)
+  {
+    return {std::move(policy.debug), std::move(policy.strict), std::move(policy.cache)};
+  }
+
+  /**
+   * @brief Keeps the lazily evaluated flags of a policy in sync with the status register of the machine
+   *
+   * The flags are read from the status register on construction and written back on destruction, also if a panic is
+   * thrown. Therefore the machine state, the debugger views, and the test harness always see the status register.
+   */
+  template <typename Policy>
+  class flags_scope final
+  {
+  public:
+    flags_scope(Policy& policy, machine_registers& reg) noexcept
+      : policy_{policy}
+      , reg_{reg}
+    {
+      policy_.load_flags(reg_);
+    }
+
+    flags_scope(const flags_scope&) = delete;
+
+    ~flags_scope()
+    {
+      policy_.store_flags(reg_);
+    }
+
+    flags_scope& operator=(const flags_scope&) = delete;
+
+  private:
+    Policy& policy_;
+    machine_registers& reg_;
+  };
+
   template <typename Policy>
   [[nodiscard]] inline word_t load_instruction(
     Policy& policy, machine_registers& reg, const machine_memory& mem, execute_result& result)
@@ -416,7 +689,7 @@ namespace yarisc::arch::detail
     reg.named.set_ip(ip + sizeof(word_t));
 
     word_t instr = 0x0;
-    result = policy.load(mem, ip, instr);
+    result = policy.fetch(mem, ip, instr);
 
     return instr;
   }
@@ -624,22 +897,17 @@ namespace yarisc::arch::detail
     constexpr optype opt = profile_type::template instruction_type<Code>;
 
     if constexpr (profile_type::template instruction_supported<Code>)
-      return {traits_type::execute<Code>(policy, instr, reg, mem), opt};
+      return {traits_type::template execute<Code>(policy, instr, reg, mem), opt};
     else
       return {policy.panic(instruction_error(reg, instr)), opt};
   }
 
   template <typename Policy>
-  [[nodiscard]] execute_result execute_instruction(Policy& policy, machine_registers& reg, machine_memory& mem)
+  [[nodiscard]] execute_result interpret_instruction(Policy& policy, machine_registers& reg, machine_memory& mem)
   {
-    if constexpr (Policy::debug_policy::enabled)
-    {
-      if (policy.debug.breakpoint(static_cast<address_t>(reg.named.ip()))) [[unlikely]]
-        return breakpoint_result;
-    }
-
     std::pair result{execute_result{}, optype::basic};
 
+    [[maybe_unused]] const word_t ip = reg.named.ip();
     const word_t instr = load_instruction(policy, reg, mem, result.first);
 
     if constexpr (Policy::debug_policy::enabled)
@@ -682,12 +950,246 @@ namespace yarisc::arch::detail
       break;
     }
 
+    if constexpr (Policy::debug_policy::enabled)
+    {
+      // A watchpoint stops before the instruction, which is executed when the execution is resumed
+      if (result.first.breakpoint && policy.debug.watchpoint_hit()) [[unlikely]]
+      {
+        reg.named.set_ip(ip);
+
+        return result.first;
+      }
+    }
+
     if constexpr (Policy::strict_policy::enabled)
       return policy.check(result, instr);
     else
       return result.first;
   }
 
+  template <typename Policy>
+  [[nodiscard]] execute_result execute_instruction(Policy& policy, machine_registers& reg, machine_memory& mem)
+  {
+    if constexpr (Policy::debug_policy::enabled)
+    {
+      if (policy.breakpoint(static_cast<address_t>(reg.named.ip()), reg, mem)) [[unlikely]]
+        return breakpoint_result;
+    }
+
+    if constexpr (Policy::monitor_policy::enabled)
+    {
+      const execute_result result = interpret_instruction(policy, reg, mem);
+
+      policy.monitor.retire(reg, result.keep_going);
+
+      return result;
+    }
+    else
+    {
+      return interpret_instruction(policy, reg, mem);
+    }
+  }
+
+  [[nodiscard]] inline word_t decoded_op1(const decoded_instruction& instr, const machine_registers& reg) noexcept
+  {
+    return (instr.form == operand_form::immediate_op1) ? instr.imm : reg.named.r[instr.op1];
+  }
+
+  [[nodiscard]] inline word_t decoded_op2(const decoded_instruction& instr, const machine_registers& reg) noexcept
+  {
+    return (instr.form == operand_form::immediate_op2) ? instr.imm : reg.named.r[instr.op2];
+  }
+
+  template <optype Type>
+  struct decoded_execution_traits;
+
+  template <>
+  struct decoded_execution_traits<optype::basic>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction&, machine_registers& reg, machine_memory& mem)
+    {
+      return exec_op<Code>::execute(policy, reg, mem);
+    }
+  };
+
+  template <>
+  struct decoded_execution_traits<optype::op0>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+    {
+      return exec_op<Code>::execute(policy, reg, mem, reg.named.r[instr.op0]);
+    }
+  };
+
+  template <>
+  struct decoded_execution_traits<optype::op0_op1>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+    {
+      return exec_op<Code>::execute(policy, reg, mem, reg.named.r[instr.op0], decoded_op1(instr, reg));
+    }
+  };
+
+  template <>
+  struct decoded_execution_traits<optype::op0_op1_op2>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+    {
+      const word_t op1 = decoded_op1(instr, reg);
+      const word_t op2 = decoded_op2(instr, reg);
+
+      return exec_op<Code>::execute(policy, reg, mem, reg.named.r[instr.op0], op1, op2);
+    }
+  };
+
+  template <>
+  struct decoded_execution_traits<optype::jump>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+    {
+      return exec_op<Code>::execute(policy, reg, mem, static_cast<address_t>(instr.imm));
+    }
+  };
+
+  template <>
+  struct decoded_execution_traits<optype::cond_jump>
+  {
+    template <opcode Code, typename Policy>
+    [[nodiscard]] static execute_result execute(
+      Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+    {
+      const auto flags = static_cast<word_t>(instr.op0);
+      const auto negate = static_cast<bool>(instr.op1);
+
+      return exec_op<Code>::execute(policy, reg, mem, static_cast<address_t>(instr.imm), flags, negate);
+    }
+  };
+
+  template <opcode Code, typename Policy>
+  [[nodiscard]] execute_result execute_decoded_opcode(
+    Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+  {
+    using profile_type = typename Policy::profile_type;
+    using traits_type = decoded_execution_traits<profile_type::template instruction_type<Code>>;
+
+    if constexpr (profile_type::template instruction_supported<Code>)
+    {
+      if constexpr (Policy::debug_policy::enabled && ((Code == opcode::load) || (Code == opcode::store)))
+      {
+        const execute_result result = traits_type::template execute<Code>(policy, instr, reg, mem);
+
+        // A watchpoint stops before the instruction, which is executed when the execution is resumed
+        if (result.breakpoint && policy.debug.watchpoint_hit()) [[unlikely]]
+          reg.named.set_ip(static_cast<word_t>(reg.named.ip() - instr.size()));
+
+        return result;
+      }
+      else
+      {
+        return traits_type::template execute<Code>(policy, instr, reg, mem);
+      }
+    }
+    else
+    {
+      // Unsupported opcodes are decoded as fallback and never end up here
+      assert(false);
+
+      return breakpoint_result;
+    }
+  }
+
+  /**
+   * @brief Executes a decoded instruction of an opcode supported by the profile
+   *
+   * The instruction pointer must already point past the instruction.
+   */
+  template <typename Policy>
+  [[nodiscard]] execute_result dispatch_decoded_instruction(
+    Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+  {
+    switch (instr.get_opcode())
+    {
+    case opcode::move:
+      return execute_decoded_opcode<opcode::move>(policy, instr, reg, mem);
+    case opcode::load:
+      return execute_decoded_opcode<opcode::load>(policy, instr, reg, mem);
+    case opcode::store:
+      return execute_decoded_opcode<opcode::store>(policy, instr, reg, mem);
+    case opcode::add:
+      return execute_decoded_opcode<opcode::add>(policy, instr, reg, mem);
+    case opcode::add_with_carry:
+      return execute_decoded_opcode<opcode::add_with_carry>(policy, instr, reg, mem);
+    case opcode::jump:
+      return execute_decoded_opcode<opcode::jump>(policy, instr, reg, mem);
+    case opcode::cond_jump:
+      return execute_decoded_opcode<opcode::cond_jump>(policy, instr, reg, mem);
+    case opcode::noop:
+      return execute_decoded_opcode<opcode::noop>(policy, instr, reg, mem);
+    case opcode::halt:
+      return execute_decoded_opcode<opcode::halt>(policy, instr, reg, mem);
+    default:
+      // Unsupported opcodes are decoded as fallback and never end up here
+      assert(false);
+
+      return breakpoint_result;
+    }
+  }
+
+  /**
+   * @brief Executes the instruction at the instruction pointer using the decode cache of the policy
+   *
+   * Instructions that cannot be executed in decoded form are passed on to the reference interpreter. This is the case
+   * for unaligned instruction pointers, unsupported opcodes, and instruction words that fail the strict mode checks, so
+   * that the reference interpreter raises the same panics.
+   */
+  template <typename Policy>
+  [[nodiscard]] execute_result execute_decoded_instruction(Policy& policy, machine_registers& reg, machine_memory& mem)
+  {
+    static_assert(Policy::cache_policy::enabled, "Decoded execution requires a decode cache");
+
+    using profile_type = typename Policy::profile_type;
+
+    const auto ip = static_cast<address_t>(reg.named.ip());
+
+    if constexpr (Policy::debug_policy::enabled)
+    {
+      if (policy.breakpoint(ip, reg, mem)) [[unlikely]]
+        return breakpoint_result;
+    }
+
+    if (!is_aligned(ip)) [[unlikely]]
+      return interpret_instruction(policy, reg, mem);
+
+    // Copy the entry, because a store may invalidate it while the instruction is executed
+    const decoded_instruction instr = policy.cache.template get<profile_type>(mem, ip);
+
+    bool fallback = (instr.form == operand_form::fallback);
+
+    if constexpr (Policy::strict_policy::enabled)
+      fallback = fallback || !instr.valid();
+
+    if (fallback) [[unlikely]]
+      return interpret_instruction(policy, reg, mem);
+
+    // Branch on long immediates, so the next fetch does not have to wait for the size of this instruction
+    reg.named.set_ip(static_cast<word_t>(ip + sizeof(word_t)));
+
+    if (instr.long_immediate())
+      reg.named.set_ip(static_cast<word_t>(ip + 2 * sizeof(word_t)));
+
+    return dispatch_decoded_instruction(policy, instr, reg, mem);
+  }
+
 } // namespace yarisc::arch::detail
 
 #endif
@@ -10,13 +10,11 @@
 #include <yarisc/arch/registers.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
-#include <yarisc/utils/ios.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
 #include <algorithm>
 #include <concepts>
 #include <functional>
-#include <ostream>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -29,28 +27,28 @@ namespace yarisc::arch::detail
 
   template <typename Func, typename... Args>
     requires(
-      std::invocable<const Func&, Args..., utils::color::plain_context&, std::ostream&> &&
-      std::invocable<const Func&, Args..., utils::color::colored_context&, std::ostream&>)
-  std::ostream& format_output(const Func& out, std::ostream& os, output_format fmt, Args&&... args)
+      std::invocable<const Func&, Args..., utils::color::plain_context&, utils::text_buffer&> &&
+      std::invocable<const Func&, Args..., utils::color::colored_context&, utils::text_buffer&>)
+  std::string& format_output(const Func& out, std::string& str, output_format fmt, Args&&... args)
   {
-    const utils::ostream_guard guard{os};
+    utils::text_buffer buf{str};
 
     if ((fmt == output_format::colored) || ((fmt == output_format::console) && utils::color::supported()))
     {
       utils::color::colored_context ctx{};
 
-      std::invoke(out, std::forward<Args>(args)..., ctx, os);
+      std::invoke(out, std::forward<Args>(args)..., ctx, buf);
 
-      os << utils::color::reset(ctx);
+      buf << utils::color::reset(ctx);
     }
     else
     {
       utils::color::plain_context ctx{};
 
-      std::invoke(out, std::forward<Args>(args)..., ctx, os);
+      std::invoke(out, std::forward<Args>(args)..., ctx, buf);
     }
 
-    return os;
+    return str;
   }
 
   template <typename T, typename U>
@@ -86,34 +84,39 @@ namespace yarisc::arch::detail
     return proj(func, d.current);
   }
 
-  template <typename Func, typename T>
-  [[nodiscard]] std::string output_as_string(const Func& out, const T& value)
+  /**
+   * @brief Returns the strings of this thread to which the current and the previous value of a diff are formatted
+   */
+  [[nodiscard]] inline std::pair<std::string&, std::string&> diff_scratch() noexcept
   {
-    utils::color::plain_context ctx{};
+    thread_local std::string current;
+    thread_local std::string previous;
 
-    std::stringstream os;
-    std::invoke(out, value, ctx, os);
-
-    return std::move(os).str();
+    return {current, previous};
   }
 
-  template <typename T, std::convertible_to<T> U>
-  [[nodiscard]] std::string output_as_string(const basic_format_t<T>&, const U& value)
+  template <typename Func, typename T>
+  [[nodiscard]] std::string_view output_as_string(const Func& out, const T& value, std::string& str)
   {
-    std::stringstream os;
-    os << value;
+    utils::color::plain_context ctx{};
+    utils::text_buffer buf{str};
+
+    str.clear();
+    std::invoke(out, value, ctx, buf);
 
-    return std::move(os).str();
+    return str;
   }
 
   template <std::convertible_to<std::string_view> T>
-  [[nodiscard]] inline std::string_view output_as_string(const basic_format_t<std::string>&, const T& value)
+  [[nodiscard]] inline std::string_view output_as_string(
+    const basic_format_t<std::string>&, const T& value, std::string&)
   {
     return value;
   }
 
   template <std::convertible_to<std::string_view> T>
-  [[nodiscard]] inline std::string_view output_as_string(const basic_format_t<std::string_view>&, const T& value)
+  [[nodiscard]] inline std::string_view output_as_string(
+    const basic_format_t<std::string_view>&, const T& value, std::string&)
   {
     return value;
   }
@@ -126,14 +129,14 @@ namespace yarisc::arch::detail
     }
   };
 
-  inline std::ostream& output_char(std::ostream& os, char ch) noexcept
+  inline utils::text_buffer& output_char(utils::text_buffer& os, char ch)
   {
     const output_char_pred pred{};
 
     return os << (pred(ch) ? ch : '.');
   }
 
-  inline std::ostream& output_string(std::ostream& os, std::string_view str) noexcept
+  inline utils::text_buffer& output_string(utils::text_buffer& os, std::string_view str)
   {
     const output_char_pred pred{};
 
@@ -164,8 +167,32 @@ namespace yarisc::arch::detail
   template <typename Func, typename T>
   inline constexpr bool highlight_diff_only_v = highlight_diff_only<Func, T>::value;
 
+  /**
+   * @brief Whether the output leaves its last color set, e.g. because only whitespace follows it
+   *
+   * The caller resets the color before any other text, which saves a reset between neighboring outputs.
+   */
+  template <typename Func>
+  struct keep_color : std::false_type
+  {
+  };
+
+  template <typename Func>
+    requires requires { typename std::remove_cvref_t<Func>::keep_color; }
+  struct keep_color<Func> : std::remove_cvref_t<Func>::keep_color
+  {
+  };
+
+  template <typename Func>
+  inline constexpr bool keep_color_v = keep_color<Func>::value;
+
   template <utils::color::context Ctx>
-  void format_diff_impl(std::string_view current, std::string_view previous, Ctx& ctx, std::ostream& os, bool diff_only)
+  void format_diff_impl(std::string_view current,
+                        std::string_view previous,
+                        Ctx& ctx,
+                        utils::text_buffer& os,
+                        bool diff_only,
+                        bool keep_color)
   {
     const std::string::size_type size = current.size();
 
@@ -193,20 +220,23 @@ namespace yarisc::arch::detail
           previous_diff = current_diff;
         }
 
-        os << utils::color::reset(ctx);
-
         if (i < size)
-          output_string(os, current.substr(i));
+          output_string(os << utils::color::reset(ctx), current.substr(i));
+        else if (!keep_color)
+          os << utils::color::reset(ctx);
       }
       else
       {
-        os << utils::color::bright_red(ctx) << current << utils::color::reset(ctx);
+        os << utils::color::bright_red(ctx) << current;
+
+        if (!keep_color)
+          os << utils::color::reset(ctx);
       }
     }
   }
 
   template <typename Func, typename T, utils::color::context Ctx>
-  void format_diff(const Func& out, const T& current, const T& previous, Ctx& ctx, std::ostream& os)
+  void format_diff(const Func& out, const T& current, const T& previous, Ctx& ctx, utils::text_buffer& os)
   {
     if (current == previous)
     {
@@ -215,12 +245,19 @@ namespace yarisc::arch::detail
       return;
     }
 
-    format_diff_impl(
-      output_as_string(out, current), output_as_string(out, previous), ctx, os, highlight_diff_only_v<Func, T>);
+    // The values of a diff are not diffs themselves, so their output does not use the scratch strings again
+    const auto [current_str, previous_str] = diff_scratch();
+
+    format_diff_impl(output_as_string(out, current, current_str),
+                     output_as_string(out, previous, previous_str),
+                     ctx,
+                     os,
+                     highlight_diff_only_v<Func, T>,
+                     keep_color_v<Func>);
   }
 
   template <typename Func, typename T, utils::color::context Ctx>
-  void format_proj(const Func& out, const diff<T>& d, Ctx& ctx, std::ostream& os)
+  void format_proj(const Func& out, const diff<T>& d, Ctx& ctx, utils::text_buffer& os)
   {
     if constexpr (utils::color::always_enabled<Ctx>)
       format_diff(out, d.current, d.previous, ctx, os);
@@ -248,7 +285,7 @@ namespace yarisc::arch::detail
     T value_;
     Ctx* context_;
 
-    friend std::ostream& operator<<(std::ostream& os, const bound_output& b)
+    friend utils::text_buffer& operator<<(utils::text_buffer& os, const bound_output& b)
     {
       std::invoke(b.output_, b.value_, *b.context_, os);
 
@@ -273,24 +310,25 @@ namespace yarisc::arch::detail
     }
 
     template <projectable<T> U, utils::color::context Ctx>
-    void operator()(const U& value, Ctx& ctx, std::ostream& os) const
+    void operator()(const U& value, Ctx& ctx, utils::text_buffer& os) const
     {
       put_impl(value, ctx, os);
     }
 
   private:
-    template <projectable<T> U, utils::color::context Ctx>
-    auto put_impl(const U& value, Ctx& ctx, std::ostream& os) const
-      -> decltype(std::declval<const Derived&>().put(value, ctx, os))
+    // The defaulted parameter `D` delays the lookup into the (still incomplete) derived class until overload resolution
+    template <projectable<T> U, utils::color::context Ctx, typename D = Derived>
+    auto put_impl(const U& value, Ctx& ctx, utils::text_buffer& os) const
+      -> decltype(std::declval<const D&>().put(value, ctx, os))
     {
-      return static_cast<const Derived&>(*this).put(value, ctx, os);
+      return static_cast<const D&>(*this).put(value, ctx, os);
     }
 
-    template <typename U, typename Ctx>
-    auto put_impl(const U& value, Ctx& ctx, std::ostream& os) const
-      -> decltype(format_proj(std::declval<const Derived&>(), value, ctx, os))
+    template <typename U, typename Ctx, typename D = Derived>
+    auto put_impl(const U& value, Ctx& ctx, utils::text_buffer& os) const
+      -> decltype(format_proj(std::declval<const D&>(), value, ctx, os))
     {
-      return format_proj(static_cast<const Derived&>(*this), value, ctx, os);
+      return format_proj(static_cast<const D&>(*this), value, ctx, os);
     }
   };
 
@@ -304,12 +342,12 @@ namespace yarisc::arch::detail
     friend bind_output_fn<basic_format_t, T>;
 
     template <utils::color::context Ctx>
-    void put(const T& value, Ctx&, std::ostream& os) const
+    void put(const T& value, Ctx&, utils::text_buffer& os) const
     {
       if constexpr (std::is_convertible_v<T, std::string_view>)
         output_string(os, value);
       else
-        os << value;
+        utils::append_decimal(os, value);
     }
   };
 
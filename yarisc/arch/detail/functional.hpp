@@ -33,7 +33,7 @@ namespace yarisc::arch::detail
     // clang-format on
 
     template <typename Tag, typename... Args>
-    using tag_invoke_result_t = decltype(tag_invoke(declval<Tag>(), declval<Args>()...));
+    using tag_invoke_result_t = decltype(tag_invoke(std::declval<Tag>(), std::declval<Args>()...));
 
     template <typename Tag, typename... Args>
     struct tag_invoke_result
@@ -13,19 +13,20 @@
 #include <yarisc/arch/memory.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
-#include <ostream>
 #include <string_view>
 
 namespace yarisc::arch::detail
 {
   template <std::size_t N, utils::color::context Ctx>
     requires(N < num_registers)
-  [[nodiscard]] bool address_register_bgclr(std::ostream& os, Ctx& ctx, address_t address, const machine_state& state)
+  [[nodiscard]] bool address_register_bgclr(
+    utils::text_buffer& os, Ctx& ctx, address_t address, const machine_state& state)
   {
     if constexpr (register_background_colors[N].second)
     {
@@ -40,42 +41,36 @@ namespace yarisc::arch::detail
     return false;
   }
 
+  /**
+   * @return whether the background color has been set
+   */
   template <utils::color::context Ctx>
-  std::ostream& output_address_bgclr(std::ostream& os, Ctx& ctx, address_t address, const machine_state& state)
+  bool output_address_bgclr(utils::text_buffer& os, Ctx& ctx, address_t address, const machine_state& state)
   {
     static_assert(num_registers == 8);
 
     // Instruction pointer takes precedence
-    if (address_register_bgclr<7>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<0>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<1>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<2>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<3>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<4>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<5>(os, ctx, address, state))
-      return os;
-    if (address_register_bgclr<6>(os, ctx, address, state))
-      return os;
-
-    return os;
+    return address_register_bgclr<7>(os, ctx, address, state) || address_register_bgclr<0>(os, ctx, address, state) ||
+           address_register_bgclr<1>(os, ctx, address, state) || address_register_bgclr<2>(os, ctx, address, state) ||
+           address_register_bgclr<3>(os, ctx, address, state) || address_register_bgclr<4>(os, ctx, address, state) ||
+           address_register_bgclr<5>(os, ctx, address, state) || address_register_bgclr<6>(os, ctx, address, state);
   }
 
   template <typename T, utils::color::context Ctx>
-  std::ostream& output_word_as_bytes(
-    std::ostream& os, const T& word, Ctx& ctx, address_t address, const machine_state* state)
+  utils::text_buffer& output_word_as_bytes(
+    utils::text_buffer& os, const T& word, Ctx& ctx, address_t address, const machine_state* state)
   {
     using namespace std::string_view_literals;
 
-    if (state)
-      output_address_bgclr(os, ctx, address, *state);
+    const bool background = state && output_address_bgclr(os, ctx, address, *state);
 
-    return os << hex_word_as_bytes(word, ctx) << "  "sv;
+    os << hex_word_as_bytes(word, ctx);
+
+    // The foreground color of the word may stay set for the separator, but a background color would be visible
+    if (background)
+      os << utils::color::reset(ctx);
+
+    return os << "  "sv;
   }
 
   template <memory_view::size_type Width>
@@ -98,14 +93,14 @@ namespace yarisc::arch::detail
     using char_line_buffer_type = std::array<char, width_bytes>;
 
     template <utils::color::context Ctx>
-    void put(memory_view view, Ctx& ctx, std::ostream& os) const
+    void put(memory_view view, Ctx& ctx, utils::text_buffer& os) const
     {
       while (!view.empty())
         view = view.sub(put_line(view.sub(0, width_bytes), ctx, os));
     }
 
     template <utils::color::context Ctx>
-    void put(const diff<memory_view>& d, Ctx& ctx, std::ostream& os) const
+    void put(const diff<memory_view>& d, Ctx& ctx, utils::text_buffer& os) const
     {
       if constexpr (utils::color::always_enabled<Ctx>)
         put(d.current, d.previous, ctx, os);
@@ -118,7 +113,7 @@ namespace yarisc::arch::detail
     }
 
     template <utils::color::context Ctx>
-    void put(memory_view current, memory_view previous, Ctx& ctx, std::ostream& os) const
+    void put(memory_view current, memory_view previous, Ctx& ctx, utils::text_buffer& os) const
     {
       previous = adjust_previous(current, previous);
 
@@ -139,7 +134,7 @@ namespace yarisc::arch::detail
     }
 
     template <utils::color::context Ctx>
-    size_type put_line(memory_view line, Ctx& ctx, std::ostream& os) const
+    size_type put_line(memory_view line, Ctx& ctx, utils::text_buffer& os) const
     {
       const address_t base = line.base();
       const machine_state* const state = line.state();
@@ -165,13 +160,13 @@ namespace yarisc::arch::detail
 
       const std::string_view chars{buf.data(), line.size()};
 
-      os << string_format(chars, ctx) << '\n';
+      os << utils::color::reset(ctx) << string_format(chars, ctx) << '\n';
 
       return line.size();
     }
 
     template <utils::color::context Ctx>
-    size_type put_line(memory_view current, memory_view previous, Ctx& ctx, std::ostream& os) const
+    size_type put_line(memory_view current, memory_view previous, Ctx& ctx, utils::text_buffer& os) const
     {
       previous = adjust_previous(current, previous);
 
@@ -240,12 +235,12 @@ namespace yarisc::arch::detail
       const std::string_view current_chars{current_buf.data(), current.size()};
       const std::string_view previous_chars{previous_buf.data(), current.size()};
 
-      os << string_format(diff(current_chars, previous_chars), ctx) << '\n';
+      os << utils::color::reset(ctx) << string_format(diff(current_chars, previous_chars), ctx) << '\n';
 
       return current.size();
     }
 
-    void put_address(address_t address, std::ostream& os) const
+    void put_address(address_t address, utils::text_buffer& os) const
     {
       using namespace std::string_view_literals;
 
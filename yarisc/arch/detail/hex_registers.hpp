@@ -15,9 +15,10 @@
 #include <yarisc/arch/registers.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
 #include <string_view>
 
 namespace yarisc::arch::detail
@@ -31,7 +32,7 @@ namespace yarisc::arch::detail
     friend bind_output_fn<hex_registers_t, registers_view>;
 
     template <projectable<registers_view> T, utils::color::context Ctx>
-    void put(const T& reg, Ctx& ctx, std::ostream& os) const
+    void put(const T& reg, Ctx& ctx, utils::text_buffer& os) const
     {
       using namespace std::string_view_literals;
 
@@ -9,9 +9,12 @@
 #include <yarisc/arch/detail/format.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
+#include <array>
 #include <concepts>
-#include <iomanip>
+#include <cstddef>
+#include <ios>
 #include <ostream>
 #include <string_view>
 #include <type_traits>
@@ -21,7 +24,21 @@ namespace yarisc::arch::detail
   template <std::integral T>
   std::ostream& output_hex(std::ostream& os, T value, std::streamsize width = 2 * sizeof(T))
   {
-    return os << std::setfill('0') << std::setw(width) << std::hex << value;
+    using unsigned_type = std::make_unsigned_t<T>;
+
+    std::array<char, 2 * sizeof(T)> storage;
+    const std::string_view digits = utils::detail::to_hex_chars(storage, static_cast<unsigned_type>(value));
+
+    for (auto n = static_cast<std::streamsize>(digits.size()); n < width; ++n)
+      os.put('0');
+
+    return os.write(digits.data(), static_cast<std::streamsize>(digits.size()));
+  }
+
+  template <std::integral T>
+  utils::text_buffer& output_hex(utils::text_buffer& buf, T value, std::size_t width = 2 * sizeof(T))
+  {
+    return utils::append_hex(buf, static_cast<std::make_unsigned_t<T>>(value), width);
   }
 
   template <std::integral T>
@@ -35,7 +52,7 @@ namespace yarisc::arch::detail
     friend bind_output_fn<hex_integral_t, T>;
 
     template <utils::color::context Ctx>
-    void put(T value, Ctx& ctx, std::ostream& os) const
+    void put(T value, Ctx& ctx, utils::text_buffer& os) const
     {
       using namespace std::string_view_literals;
 
@@ -43,19 +60,26 @@ namespace yarisc::arch::detail
     }
   };
 
+  /**
+   * @brief Outputs a sequence as hexadecimal values in alternating colors
+   *
+   * The color of the last value stays set because sequences are only separated by whitespace.
+   */
   template <typename T>
   class hex_sequence_t : public bind_output_fn<hex_sequence_t<T>, T>
   {
   public:
+    using keep_color = std::true_type;
+
     explicit hex_sequence_t() = default;
 
   private:
     friend bind_output_fn<hex_sequence_t, T>;
 
-    static constexpr std::streamsize width = 2 * sizeof(typename T::value_type);
+    static constexpr std::size_t width = 2 * sizeof(typename T::value_type);
 
     template <utils::color::context Ctx>
-    void put(const T& value, Ctx& ctx, std::ostream& os) const
+    void put(const T& value, Ctx& ctx, utils::text_buffer& os) const
     {
       if (!value.empty())
       {
@@ -71,8 +95,6 @@ namespace yarisc::arch::detail
 
         for (; first != last; ++first)
           output_hex(os << ' ' << ((++n & 1) ? color_b : color_a), static_cast<word_t>(*first), width);
-
-        os << utils::color::reset(ctx);
       }
     }
   };
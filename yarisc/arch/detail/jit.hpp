@@ -0,0 +1,123 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_JIT_HPP
+#define YARISC_ARCH_DETAIL_JIT_HPP
+
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/detail/jit_cache.hpp>
+#include <yarisc/arch/detail/threaded.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/registers.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace yarisc::arch::detail
+{
+  /**
+   * @brief Executes hot basic blocks as translated native code
+   *
+   * Only normal mode without breakpoints and watchpoints is translated. Breakpoints, watchpoints, panics, and the checks
+   * of strict mode are left to the threaded engine, which also executes cold blocks, instructions outside of blocks,
+   * and the last steps which do not cover a whole block.
+   *
+   * The semantics are those of `execute_decoded_instruction` in a loop. The instruction that halts or hits a breakpoint
+   * is not counted as an executed step.
+   *
+   * @param policy execution policy with a decode cache, a block cache, and a translation cache
+   * @param reg registers of the machine
+   * @param mem memory of the machine
+   * @param steps maximum number of steps to execute
+   * @return the result of the last instruction and the number of executed steps
+   */
+  template <typename Policy>
+  [[nodiscard]] std::pair<execute_result, std::uint64_t> execute_jit(
+    Policy& policy, machine_registers& reg, machine_memory& mem, std::uint64_t steps)
+  {
+    static_assert(Policy::cache_policy::enabled, "Translated execution requires a decode cache and a block cache");
+
+    if constexpr (!jit_cache::available || Policy::strict_policy::enabled)
+    {
+      return execute_threaded(policy, reg, mem, steps);
+    }
+    else
+    {
+      using profile_type = typename Policy::profile_type;
+
+      // The breakpoints and watchpoints cannot change during the execution
+      if constexpr (Policy::debug_policy::enabled)
+      {
+        if (policy.debug.has_breakpoints() || policy.debug.has_watchpoints())
+          return execute_threaded(policy, reg, mem, steps);
+      }
+
+      decode_cache& cache = *policy.cache.cache_;
+      block_cache& blocks = *policy.cache.blocks_;
+      jit_cache& jit = *policy.cache.jit_;
+
+      std::uint64_t s = 0;
+
+      while (s < steps)
+      {
+        blocks.refresh();
+        jit.synchronize(blocks.generation());
+
+        const auto ip = static_cast<address_t>(reg.named.ip());
+        const std::uint64_t remaining = steps - s;
+        const std::uint32_t index = blocks.find<profile_type>(cache, mem.main, ip);
+
+        std::uint64_t limit = 1;
+
+        if (index != basic_block::npos)
+        {
+          const basic_block& b = blocks.block(index);
+
+          if ((remaining >= b.size) &&
+              (jit.translated(ip) || (jit.hot(ip) && jit.translate(b, blocks.instructions(b)))))
+          {
+            policy.store_flags(reg);
+
+            jit_context ctx{reg.named.r, reg.status.s, remaining, mem.main.data(), cache.data(), blocks.code()};
+
+            const jit_exit exit = jit.run(ctx);
+
+            reg.named.r = ctx.r;
+            reg.status.s = ctx.status;
+
+            policy.load_flags(reg);
+            s += remaining - ctx.budget;
+
+            if (exit == jit_exit::halt)
+              return {halt_result, s};
+
+            if (exit == jit_exit::code_modified)
+              blocks.invalidate();
+
+            continue;
+          }
+
+          limit = b.size;
+        }
+
+        const auto [result, executed] = execute_threaded(policy, reg, mem, std::min(remaining, limit));
+
+        s += executed;
+
+        if (!result.keep_going)
+          return {result, s};
+      }
+
+      return {execute_result{}, s};
+    }
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
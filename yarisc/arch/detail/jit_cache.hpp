@@ -0,0 +1,287 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_JIT_CACHE_HPP
+#define YARISC_ARCH_DETAIL_JIT_CACHE_HPP
+
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#ifndef YARISC_ARCH_JIT
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__linux__) || defined(_WIN32))
+#define YARISC_ARCH_JIT 1
+#else
+#define YARISC_ARCH_JIT 0
+#endif
+#endif
+
+namespace yarisc::arch::detail
+{
+  /**
+   * @brief State shared between the dispatch loop and the translated code
+   *
+   * The translated code keeps the registers in host registers and writes them back when it returns.
+   */
+  struct jit_context final
+  {
+    std::array<word_t, num_registers> r{};
+    word_t status{0};
+
+    /**
+     * @brief Remaining number of steps, which the translated code reduces by the size of every block it enters
+     */
+    std::uint64_t budget{0};
+
+    std::byte* memory{nullptr};
+
+    /**
+     * @brief Entries of the decode cache, which are invalidated by the translated stores
+     */
+    decoded_instruction* entries{nullptr};
+
+    /**
+     * @brief Bitmap of the words covered by any block, see `block_cache::code()`
+     */
+    const std::uint64_t* code{nullptr};
+
+    /**
+     * @brief Native entry point per byte address, which is set by `jit_cache::run()`
+     */
+    const std::byte* const* table{nullptr};
+  };
+
+  /**
+   * @brief Reason why the translated code returned
+   */
+  enum class jit_exit : std::uint32_t
+  {
+    /**
+     * @brief The next block has not been translated or the remaining steps do not cover it
+     */
+    untranslated = 0,
+
+    /**
+     * @brief A halt instruction has been executed, which has not been counted as a step
+     */
+    halt = 1,
+
+    /**
+     * @brief A store has written a word covered by a block, so all blocks and all translated code are stale
+     */
+    code_modified = 2,
+  };
+
+  /**
+   * @brief Cache of basic blocks translated to native x86-64 code
+   *
+   * Blocks of the block cache are translated once they have been entered `hot_threshold` times. Translated blocks jump
+   * directly to each other through a table of entry points indexed by the instruction pointer, so the dispatch loop is
+   * only involved when the translated code returns.
+   *
+   * The translated code is only valid for a generation of the block cache. Since every store to a word covered by a
+   * block leaves the translated code, a new generation is detected before translated code is executed again.
+   *
+   * The code buffer and the tables are allocated on first use. Copies of the cache are empty, since it can always be
+   * rebuilt from memory. On platforms other than x86-64 Linux and Windows nothing is ever translated.
+   */
+  class jit_cache final
+  {
+  public:
+    static constexpr bool available = (YARISC_ARCH_JIT != 0);
+
+    /**
+     * @brief Number of entries into a block before it is translated
+     */
+    static constexpr std::uint8_t hot_threshold = 16;
+
+    /**
+     * @brief Size of the code buffer in bytes
+     */
+    static constexpr std::size_t code_size = 4 * 1024 * 1024;
+
+    static constexpr std::size_t num_addresses = static_cast<std::size_t>(std::numeric_limits<address_t>::max()) + 1;
+
+    jit_cache() = default;
+
+    jit_cache(const jit_cache&)
+      : jit_cache{}
+    {
+    }
+
+    jit_cache(jit_cache&& that) noexcept = default;
+
+    ~jit_cache() = default;
+
+    jit_cache& operator=(const jit_cache&) noexcept
+    {
+      reset();
+
+      return *this;
+    }
+
+    jit_cache& operator=(jit_cache&& that) noexcept = default;
+
+    /**
+     * @brief Discards all translated code if the blocks have been flushed since it has been translated
+     *
+     * @param generation current generation of the block cache
+     */
+    void synchronize(std::uint64_t generation) noexcept
+    {
+      if (generation != generation_)
+      {
+        reset();
+        generation_ = generation;
+      }
+    }
+
+    /**
+     * @brief Returns whether translated code exists for the given entry address
+     */
+    [[nodiscard]] bool translated(address_t address) const noexcept
+    {
+      return buffer_ && (table_[address] != exit_);
+    }
+
+    /**
+     * @brief Counts an entry into a block which has not been translated
+     *
+     * @param address entry address of the block
+     * @return true if the block has become hot
+     */
+    [[nodiscard]] bool hot(address_t address) noexcept
+    {
+      if (!counters_)
+        counters_ = std::make_unique<std::uint8_t[]>(block_cache::num_words);
+
+      std::uint8_t& counter = counters_[address / sizeof(word_t)];
+
+      if (counter < hot_threshold)
+        ++counter;
+
+      return (counter == hot_threshold);
+    }
+
+    /**
+     * @brief Translates a block
+     *
+     * All translated code is discarded first if the code buffer is full.
+     *
+     * @param b block to translate
+     * @param instructions decoded instructions of the block
+     * @return false if no code buffer is available
+     */
+    [[nodiscard]] bool translate(const basic_block& b, const decoded_instruction* instructions);
+
+    /**
+     * @brief Executes the translated code starting at the instruction pointer in the context
+     *
+     * Behavior is undefined unless code has been translated for the instruction pointer.
+     *
+     * @param ctx registers, remaining steps, and pointers to the memory and the caches
+     * @return the reason why the translated code returned
+     */
+    [[nodiscard]] jit_exit run(jit_context& ctx) const noexcept;
+
+    /**
+     * @brief Swaps with another cache
+     *
+     * @param that cache to swap with
+     */
+    void swap(jit_cache& that) noexcept
+    {
+      using std::swap;
+
+      swap(buffer_, that.buffer_);
+      swap(table_, that.table_);
+      swap(counters_, that.counters_);
+      swap(entry_, that.entry_);
+      swap(epilogue_, that.epilogue_);
+      swap(exit_, that.exit_);
+      swap(size_, that.size_);
+      swap(stubs_size_, that.stubs_size_);
+      swap(generation_, that.generation_);
+      swap(failed_, that.failed_);
+    }
+
+  private:
+    struct buffer_deleter final
+    {
+      YARISC_ARCH_EXPORT void operator()(std::byte* buffer) const noexcept;
+    };
+
+    /**
+     * @brief Code buffer starting with the entry and exit stubs followed by the translated blocks
+     *
+     * The buffer is only writable while code is emitted and executable otherwise.
+     */
+    std::unique_ptr<std::byte, buffer_deleter> buffer_;
+
+    std::unique_ptr<const std::byte*[]> table_;
+
+    /**
+     * @brief Entry counters of the blocks which have not been translated yet per word address
+     */
+    std::unique_ptr<std::uint8_t[]> counters_;
+
+    /**
+     * @brief Stub that loads the context and enters the translated code at the instruction pointer
+     */
+    std::uint32_t (*entry_)(jit_context*){nullptr};
+
+    /**
+     * @brief Stub that stores the context and returns the reason in `eax` to the dispatch loop
+     */
+    const std::byte* epilogue_{nullptr};
+
+    /**
+     * @brief Stub that returns `jit_exit::untranslated` to the dispatch loop
+     */
+    const std::byte* exit_{nullptr};
+
+    std::size_t size_{0};
+    std::size_t stubs_size_{0};
+
+    std::uint64_t generation_{0};
+
+    /**
+     * @brief Set if the code buffer could not be allocated, so that it is not tried again for every block
+     */
+    bool failed_{false};
+
+    /**
+     * @brief Allocates the code buffer and emits the stubs
+     */
+    [[nodiscard]] bool allocate();
+
+    /**
+     * @brief Discards all translated code and all entry counters
+     */
+    YARISC_ARCH_EXPORT void reset() noexcept;
+  };
+
+  /**
+   * @brief Swaps two caches
+   *
+   * @param lhs first cache
+   * @param rhs second cache
+   */
+  inline void swap(jit_cache& lhs, jit_cache& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
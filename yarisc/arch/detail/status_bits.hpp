@@ -10,10 +10,10 @@
 #include <yarisc/arch/registers.hpp>
 #include <yarisc/arch/types.hpp>
 #include <yarisc/utils/color.hpp>
+#include <yarisc/utils/text_buffer.hpp>
 
-#include <bitset>
+#include <array>
 #include <cstddef>
-#include <ostream>
 #include <string_view>
 #include <type_traits>
 
@@ -47,22 +47,23 @@ namespace yarisc::arch::detail
     static constexpr std::size_t bits = 8 * sizeof(word_t);
 
     template <utils::color::context Ctx>
-    void put(word_t status, Ctx& ctx, std::ostream& os) const
+    void put(word_t status, Ctx& ctx, utils::text_buffer& os) const
     {
       using namespace std::string_view_literals;
 
       if (status & ~status_register::mask)
       {
-        std::string status_bits = std::bitset<bits>{status}.to_string();
+        std::array<char, bits> status_bits;
 
-        if (status_bits.size() == bits)
-        {
-          status_bits[bits - status_register::carry_pos - 1] = carry_bit(status);
-          status_bits[bits - status_register::zero_pos - 1] = zero_bit(status);
-        }
+        for (std::size_t i = 0; i < bits; ++i)
+          status_bits[bits - i - 1] = ((status >> i) & 1) ? '1' : '0';
+
+        status_bits[bits - status_register::carry_pos - 1] = carry_bit(status);
+        status_bits[bits - status_register::zero_pos - 1] = zero_bit(status);
 
         os << "status: "sv;
-        os << utils::color::bright_white(ctx) << "0b"sv << status_bits << utils::color::reset(ctx);
+        os << utils::color::bright_white(ctx) << "0b"sv << std::string_view{status_bits.data(), bits}
+           << utils::color::reset(ctx);
       }
       else
       {
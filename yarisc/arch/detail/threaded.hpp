@@ -0,0 +1,446 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_DETAIL_THREADED_HPP
+#define YARISC_ARCH_DETAIL_THREADED_HPP
+
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/registers.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifndef YARISC_ARCH_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define YARISC_ARCH_COMPUTED_GOTO 1
+#else
+#define YARISC_ARCH_COMPUTED_GOTO 0
+#endif
+#endif
+
+namespace yarisc::arch::detail
+{
+  /**
+   * @brief Opcodes with a handler in the threaded engine in the order of the handler arguments
+   */
+  inline constexpr std::array<opcode, 9> threaded_opcodes{{
+    opcode::move,
+    opcode::load,
+    opcode::store,
+    opcode::add,
+    opcode::add_with_carry,
+    opcode::jump,
+    opcode::cond_jump,
+    opcode::noop,
+    opcode::halt,
+  }};
+
+  /**
+   * @brief Fused pairs with a handler in the threaded engine in the order of the fused handler arguments
+   */
+  inline constexpr std::array<std::pair<opcode, fusion>, 5> threaded_fusions{{
+    {opcode::add, fusion::cond_jump},
+    {opcode::add_with_carry, fusion::cond_jump},
+    {opcode::load, fusion::store},
+    {opcode::add, fusion::add_with_carry},
+    {opcode::add_with_carry, fusion::add_with_carry},
+  }};
+
+  inline constexpr std::size_t num_fusions =
+    (decoded_instruction::fusion_mask >> decoded_instruction::fusion_offset) + 1;
+
+  /**
+   * @brief Returns the handler index of an opcode, which is offset by the fusion with the following instruction
+   */
+  [[nodiscard]] inline constexpr std::size_t handler_index(opcode code, fusion fused = fusion::none) noexcept
+  {
+    return static_cast<std::size_t>(fused) * num_opcodes + static_cast<std::size_t>(code);
+  }
+
+  /**
+   * @brief Handler index that leaves the dispatch loop
+   */
+  inline constexpr std::size_t exit_handler = num_fusions * num_opcodes;
+
+  /**
+   * @brief Handler index that passes the instruction on to the reference interpreter
+   */
+  inline constexpr std::size_t fallback_handler = exit_handler + 1;
+
+  inline constexpr std::size_t num_handlers = exit_handler + 2;
+
+  /**
+   * @brief Returns the handler index of a decoded instruction
+   */
+  [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t handler_index(const decoded_instruction& instr) noexcept
+  {
+    constexpr std::size_t shift = std::countr_zero(num_opcodes) - decoded_instruction::fusion_offset;
+
+    static_assert(
+      std::has_single_bit(num_opcodes) && (std::countr_zero(num_opcodes) >= decoded_instruction::fusion_offset));
+
+    return instr.code + (static_cast<std::size_t>(instr.attr & decoded_instruction::fusion_mask) << shift);
+  }
+
+  /**
+   * @brief Builds the handler table of a profile from the instruction table
+   *
+   * All opcodes that are not supported by the profile are mapped to the fallback handler, which raises the panic. The
+   * instructions of a pair the decode cache has fused are mapped to the handler of the fused pair.
+   *
+   * @param handlers handlers in the order of `threaded_opcodes`
+   * @param fused handlers in the order of `threaded_fusions`
+   * @param fallback handler for unsupported opcodes and instructions which cannot be executed in decoded form
+   * @param exit handler that leaves the dispatch loop
+   * @return table of handlers indexed by `handler_index` followed by the exit and fallback handlers
+   */
+  template <typename Profile, typename Handler>
+  [[nodiscard]] constexpr std::array<Handler, num_handlers> make_handler_table(
+    const std::array<Handler, threaded_opcodes.size()>& handlers,
+    const std::array<Handler, threaded_fusions.size()>& fused,
+    Handler fallback,
+    Handler exit)
+  {
+    const auto supported = [](opcode code)
+    {
+      const instruction_descriptor& desc = instruction_table[static_cast<std::size_t>(code)];
+
+      return !desc.mnemonic.empty() &&
+             (static_cast<feature_level_t>(desc.level) <= static_cast<feature_level_t>(Profile::level));
+    };
+
+    std::array<Handler, num_handlers> table{};
+    table.fill(fallback);
+
+    for (std::size_t i = 0; i < threaded_opcodes.size(); ++i)
+    {
+      if (supported(threaded_opcodes[i]))
+        table[handler_index(threaded_opcodes[i])] = handlers[i];
+    }
+
+    // Unsupported opcodes are decoded without a fusion
+    for (std::size_t i = 0; i < threaded_fusions.size(); ++i)
+    {
+      const auto [code, with] = threaded_fusions[i];
+
+      if (supported(code))
+        table[handler_index(code, with)] = fused[i];
+    }
+
+    table[exit_handler] = exit;
+
+    return table;
+  }
+
+  /**
+   * @brief Executes a decoded instruction after the instruction pointer has been advanced past the instruction word
+   */
+  template <opcode Code, typename Policy>
+  [[nodiscard]] execute_result threaded_handler(
+    Policy& policy, const decoded_instruction& instr, machine_registers& reg, machine_memory& mem)
+  {
+    if (instr.long_immediate())
+      reg.named.set_ip(static_cast<word_t>(reg.named.ip() + sizeof(word_t)));
+
+    return execute_decoded_opcode<Code>(policy, instr, reg, mem);
+  }
+
+  /**
+   * @brief Rewinds the instruction pointer and passes the instruction on to the reference interpreter
+   */
+  template <typename Policy>
+  [[nodiscard]] execute_result threaded_fallback(
+    Policy& policy, const decoded_instruction&, machine_registers& reg, machine_memory& mem)
+  {
+    reg.named.set_ip(static_cast<word_t>(reg.named.ip() - sizeof(word_t)));
+
+    return interpret_instruction(policy, reg, mem);
+  }
+
+  template <typename Policy>
+  using threaded_handler_type =
+    execute_result (*)(Policy&, const decoded_instruction&, machine_registers&, machine_memory&);
+
+  template <typename Policy, std::size_t... I, std::size_t... F>
+  [[nodiscard]] constexpr std::array<threaded_handler_type<Policy>, num_handlers> make_threaded_handler_table(
+    std::index_sequence<I...>, std::index_sequence<F...>)
+  {
+    // Calling through the table gains nothing from a fusion, so fused pairs are executed one by one
+    return make_handler_table<typename Policy::profile_type, threaded_handler_type<Policy>>(
+      {{&threaded_handler<threaded_opcodes[I], Policy>...}},
+      {{&threaded_handler<threaded_fusions[F].first, Policy>...}},
+      &threaded_fallback<Policy>,
+      nullptr);
+  }
+
+  /**
+   * @brief Handler table of the threaded engine for the given policy
+   */
+  template <typename Policy>
+  inline constexpr std::array<threaded_handler_type<Policy>, num_handlers> threaded_handler_table =
+    make_threaded_handler_table<Policy>(
+      std::make_index_sequence<threaded_opcodes.size()>{}, std::make_index_sequence<threaded_fusions.size()>{});
+
+  /**
+   * @brief State of the dispatch loop of the threaded engine
+   *
+   * Fetching the next instruction is replicated into every handler, therefore it is forced inline.
+   */
+  template <typename Policy>
+  struct threaded_dispatch final
+  {
+    using policy_type = Policy;
+    using profile_type = typename Policy::profile_type;
+
+    Policy& policy;
+    machine_registers& reg;
+    machine_memory& mem;
+    std::uint64_t steps;
+
+    execute_result result{};
+    std::uint64_t s{0};
+
+    /**
+     * @brief Copy of the current entry, because a store may invalidate it while the instruction is executed
+     */
+    decoded_instruction instr{};
+
+    /**
+     * @brief Fetches the instruction at the instruction pointer
+     *
+     * @return the index of the handler of the instruction
+     */
+    [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t fetch() noexcept
+    {
+      const auto ip = static_cast<address_t>(reg.named.ip());
+
+      if constexpr (Policy::debug_policy::enabled)
+      {
+        if (policy.breakpoint(ip, reg, mem)) [[unlikely]]
+        {
+          result = breakpoint_result;
+
+          return exit_handler;
+        }
+      }
+
+      // Advancing the instruction pointer before the lookup keeps the lookup off the dependency chain of the
+      // instruction pointer, long immediate constants are skipped by the handler
+      reg.named.set_ip(static_cast<word_t>(ip + sizeof(word_t)));
+
+      if (!is_aligned(ip)) [[unlikely]]
+        return fallback_handler;
+
+      instr = policy.cache.template get<profile_type>(mem, ip);
+
+      if constexpr (Policy::strict_policy::enabled)
+      {
+        if (!instr.valid()) [[unlikely]]
+          return fallback_handler;
+      }
+
+      return handler_index(instr);
+    }
+
+    /**
+     * @brief Counts the executed instruction and fetches the next one
+     *
+     * @return the index of the handler of the next instruction
+     */
+    [[nodiscard]] YARISC_ARCH_ALWAYS_INLINE std::size_t retire() noexcept
+    {
+      if (!result.keep_going || (++s == steps)) [[unlikely]]
+        return exit_handler;
+
+      return fetch();
+    }
+  };
+
+  /**
+   * @brief Runs the threaded dispatch loop
+   *
+   * Instead of returning to a central switch after each instruction, every handler fetches the next decoded instruction
+   * and jumps directly to its handler. With computed goto each handler has its own indirect jump, which gives the branch
+   * predictor one history per handler instead of a single shared one. Without computed goto the handlers are called
+   * through the same table of function pointers.
+   *
+   * Pairs the decode cache has fused, see `fusion_of`, have a handler of their own, which continues with the handler
+   * of the second instruction by a direct jump. This saves the indirect jump of the first instruction, while the steps,
+   * breakpoints, and modified code are handled by `retire()` as for any other instruction.
+   *
+   * The dispatch state provides the next handler index by `fetch()` for the first instruction and by `retire()` after
+   * each instruction. It has to advance the instruction pointer past the instruction word before it returns a handler
+   * index other than `exit_handler`.
+   *
+   * @param d dispatch state
+   * @return the result of the last instruction and the number of executed steps
+   */
+  template <typename Dispatch>
+  [[nodiscard]] std::pair<execute_result, std::uint64_t> run_threaded(Dispatch& d)
+  {
+    using Policy = typename Dispatch::policy_type;
+
+#if YARISC_ARCH_COMPUTED_GOTO
+    static const std::array<void*, num_handlers> labels = make_handler_table<typename Policy::profile_type, void*>(
+      {{
+        &&handle_move,
+        &&handle_load,
+        &&handle_store,
+        &&handle_add,
+        &&handle_add_with_carry,
+        &&handle_jump,
+        &&handle_cond_jump,
+        &&handle_noop,
+        &&handle_halt,
+      }},
+      {{
+        &&handle_add_then_cond_jump,
+        &&handle_add_with_carry_then_cond_jump,
+        &&handle_load_then_store,
+        &&handle_add_then_add_with_carry,
+        &&handle_add_with_carry_then_add_with_carry,
+      }},
+      &&handle_fallback,
+      &&handle_exit);
+
+    std::size_t index = d.fetch();
+
+    goto* labels[index];
+
+  handle_move:
+    d.result = threaded_handler<opcode::move>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_load:
+    d.result = threaded_handler<opcode::load>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_store:
+    d.result = threaded_handler<opcode::store>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_add:
+    d.result = threaded_handler<opcode::add>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_add_with_carry:
+    d.result = threaded_handler<opcode::add_with_carry>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_jump:
+    d.result = threaded_handler<opcode::jump>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_cond_jump:
+    d.result = threaded_handler<opcode::cond_jump>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_noop:
+    d.result = threaded_handler<opcode::noop>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_halt:
+    d.result = threaded_handler<opcode::halt>(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+    // The fused handlers continue with the handler of the second instruction by a direct jump. The retire still
+    // counts the steps and fetches the second instruction, which takes the indirect jump if it is not the expected one.
+  handle_add_then_cond_jump:
+    d.result = threaded_handler<opcode::add>(d.policy, d.instr, d.reg, d.mem);
+    goto then_cond_jump;
+
+  handle_add_with_carry_then_cond_jump:
+    d.result = threaded_handler<opcode::add_with_carry>(d.policy, d.instr, d.reg, d.mem);
+
+  then_cond_jump:
+    index = d.retire();
+
+    if (index == handler_index(opcode::cond_jump)) [[likely]]
+      goto handle_cond_jump;
+
+    goto* labels[index];
+
+  handle_load_then_store:
+    d.result = threaded_handler<opcode::load>(d.policy, d.instr, d.reg, d.mem);
+    index = d.retire();
+
+    if (index == handler_index(opcode::store)) [[likely]]
+      goto handle_store;
+
+    goto* labels[index];
+
+  handle_add_then_add_with_carry:
+    d.result = threaded_handler<opcode::add>(d.policy, d.instr, d.reg, d.mem);
+    goto then_add_with_carry;
+
+  handle_add_with_carry_then_add_with_carry:
+    d.result = threaded_handler<opcode::add_with_carry>(d.policy, d.instr, d.reg, d.mem);
+
+  then_add_with_carry:
+    index = d.retire();
+
+    // Chains of additions with carry stay in the fused handlers
+    if (index == handler_index(opcode::add_with_carry, fusion::add_with_carry))
+      goto handle_add_with_carry_then_add_with_carry;
+    if (index == handler_index(opcode::add_with_carry, fusion::cond_jump))
+      goto handle_add_with_carry_then_cond_jump;
+    if (index == handler_index(opcode::add_with_carry))
+      goto handle_add_with_carry;
+
+    goto* labels[index];
+
+  handle_fallback:
+    d.result = threaded_fallback(d.policy, d.instr, d.reg, d.mem);
+    goto* labels[d.retire()];
+
+  handle_exit:
+    return {d.result, d.s};
+#else
+    constexpr const auto& table = threaded_handler_table<Policy>;
+
+    for (std::size_t index = d.fetch(); index != exit_handler; index = d.retire())
+      d.result = table[index](d.policy, d.instr, d.reg, d.mem);
+
+    return {d.result, d.s};
+#endif
+  }
+
+  /**
+   * @brief Executes decoded instructions with a threaded dispatch
+   *
+   * The semantics are those of `execute_decoded_instruction` in a loop. The instruction that halts or hits a breakpoint
+   * is not counted as an executed step.
+   *
+   * @param policy execution policy with a decode cache
+   * @param reg registers of the machine
+   * @param mem memory of the machine
+   * @param steps maximum number of steps to execute
+   * @return the result of the last instruction and the number of executed steps
+   */
+  template <typename Policy>
+  [[nodiscard]] std::pair<execute_result, std::uint64_t> execute_threaded(
+    Policy& policy, machine_registers& reg, machine_memory& mem, std::uint64_t steps)
+  {
+    static_assert(Policy::cache_policy::enabled, "Threaded execution requires a decode cache");
+
+    if (steps == 0)
+      return {execute_result{}, 0};
+
+    threaded_dispatch<Policy> d{policy, reg, mem, steps};
+
+    return run_threaded(d);
+  }
+
+} // namespace yarisc::arch::detail
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/history.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace yarisc::arch
+{
+  execution_history::execution_history(std::uint64_t interval)
+    : base_interval_{interval}
+    , interval_{interval}
+  {
+    if (interval == 0)
+      throw std::invalid_argument{"The interval between snapshots must not be zero"};
+  }
+
+  void execution_history::reset(const machine& m)
+  {
+    snapshots_.clear();
+    interval_ = base_interval_;
+    step_ = 0;
+
+    take_snapshot(m);
+  }
+
+  bool execution_history::execute(machine& m, execution_mode mode)
+  {
+    return execute(m, std::numeric_limits<std::uint64_t>::max(), mode).first;
+  }
+
+  std::pair<bool, std::uint64_t> execution_history::execute(machine& m, std::uint64_t steps, execution_mode mode)
+  {
+    return execute(m, steps, mode, true);
+  }
+
+  std::pair<bool, std::uint64_t> execution_history::continue_execution(
+    machine& m, std::uint64_t steps, execution_mode mode)
+  {
+    return execute(m, steps, mode, false);
+  }
+
+  std::pair<bool, std::uint64_t> execution_history::execute(
+    machine& m, std::uint64_t steps, execution_mode mode, bool resume)
+  {
+    std::uint64_t executed = 0;
+
+    while (executed < steps)
+    {
+      std::uint64_t chunk = steps - executed;
+
+      if (!snapshots_.empty())
+      {
+        if (step_ >= next_snapshot())
+          take_snapshot(std::as_const(m));
+
+        chunk = std::min(chunk, next_snapshot() - step_);
+      }
+
+      // Only the first chunk resumes from a stop, the others continue where the previous one has ended
+      const auto [halted, s] =
+        (resume && (executed == 0)) ? m.execute(chunk, mode) : m.continue_execution(chunk, mode);
+
+      executed += s;
+      step_ += s;
+
+      if (halted || (s < chunk))
+        return {halted, executed};
+    }
+
+    if (!snapshots_.empty() && (step_ >= next_snapshot()))
+      take_snapshot(std::as_const(m));
+
+    return {false, executed};
+  }
+
+  std::uint64_t execution_history::step_back(machine& m, std::uint64_t steps, execution_mode mode)
+  {
+    if (snapshots_.empty())
+      return 0;
+
+    const std::uint64_t current = step_;
+
+    seek(m, current - std::min(steps, current), mode);
+
+    return current - step_;
+  }
+
+  std::optional<std::uint64_t> execution_history::reverse_continue(machine& m, execution_mode mode)
+  {
+    if (snapshots_.empty() || (step_ == 0))
+      return {};
+
+    const std::uint64_t current = step_;
+
+    // Scans the intervals between snapshots backwards, each one up to the start of the interval scanned before
+    std::uint64_t end = current;
+
+    for (auto it = nearest(current - 1);; --it)
+    {
+      restore(m, *it);
+
+      std::optional<std::uint64_t> stop;
+      bool first = true;
+
+      while (step_ < end)
+      {
+        const std::uint64_t chunk = end - step_;
+        const auto [halted, s] = first ? m.continue_execution(chunk, mode) : m.execute(chunk, mode);
+
+        step_ += s;
+
+        if (halted || (!first && (s == 0)))
+          break;
+
+        if (s < chunk)
+          stop = step_;
+
+        first = false;
+      }
+
+      if (stop)
+      {
+        seek(m, *stop, mode);
+
+        // Stops once more, which leaves the debugger as if the execution had stopped there
+        step_ += m.continue_execution(1, mode).second;
+
+        return stop;
+      }
+
+      end = it->step;
+
+      if (it == snapshots_.begin())
+        break;
+    }
+
+    seek(m, current, mode);
+
+    return {};
+  }
+
+  std::vector<execution_history::snapshot>::const_iterator execution_history::nearest(
+    std::uint64_t step) const noexcept
+  {
+    const auto it = std::upper_bound(
+      snapshots_.begin(), snapshots_.end(), step, [](std::uint64_t s, const snapshot& snap) { return s < snap.step; });
+
+    // The first snapshot is taken at step zero
+    return std::prev(it);
+  }
+
+  std::uint64_t execution_history::next_snapshot() const noexcept
+  {
+    return nearest(step_)->step + interval_;
+  }
+
+  void execution_history::take_snapshot(const machine& m)
+  {
+    if (snapshots_.size() >= max_snapshots)
+    {
+      // Keeps the first snapshot and every other one after it
+      std::size_t kept = 1;
+
+      for (std::size_t i = 2; i < snapshots_.size(); i += 2)
+        snapshots_[kept++] = std::move(snapshots_[i]);
+
+      snapshots_.erase(snapshots_.begin() + static_cast<std::ptrdiff_t>(kept), snapshots_.end());
+      interval_ *= 2;
+    }
+
+    const memory& mem = m.main_memory();
+    const auto previous = snapshots_.empty() ? snapshots_.end() : nearest(step_);
+
+    if ((previous != snapshots_.end()) && (previous->step == step_))
+      return;
+
+    snapshot snap{step_, m.state().reg, {}};
+    snap.pages.reserve((mem.size() + page_size - 1) / page_size);
+
+    for (memory::size_type off = 0; off < mem.size(); off += page_size)
+    {
+      const memory::size_type len = std::min(page_size, mem.size() - off);
+      const std::size_t index = off / page_size;
+
+      if ((previous != snapshots_.end()) && (std::memcmp(previous->pages[index]->data(), mem.data() + off, len) == 0))
+      {
+        snap.pages.push_back(previous->pages[index]);
+      }
+      else
+      {
+        auto p = std::make_shared<page>();
+        std::memcpy(p->data(), mem.data() + off, len);
+
+        snap.pages.push_back(std::move(p));
+      }
+    }
+
+    snapshots_.insert((previous != snapshots_.end()) ? std::next(previous) : snapshots_.end(), std::move(snap));
+  }
+
+  void execution_history::restore(machine& m, const snapshot& snap)
+  {
+    memory& mem = m.main_memory();
+
+    for (memory::size_type off = 0; off < mem.size(); off += page_size)
+      std::memcpy(mem.data() + off, snap.pages[off / page_size]->data(), std::min(page_size, mem.size() - off));
+
+    m.set_registers(snap.reg);
+    step_ = snap.step;
+  }
+
+  void execution_history::seek(machine& m, std::uint64_t step, execution_mode mode)
+  {
+    restore(m, *nearest(step));
+
+    // Stops on the way are irrelevant, the machine is deterministic and gets to the step anyway
+    while (step_ < step)
+    {
+      const auto [halted, s] = m.execute(step - step_, mode);
+
+      step_ += s;
+
+      if (halted || (s == 0))
+        break;
+    }
+  }
+
+} // namespace yarisc::arch
@@ -0,0 +1,178 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_HISTORY_HPP
+#define YARISC_ARCH_HISTORY_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Execution history of a machine, which allows to go back to earlier steps
+   *
+   * The machine is executed through the history, which counts the steps and takes a snapshot of the registers and main
+   * memory at regular intervals. A snapshot shares the memory pages that have not changed since the previous one, so
+   * only dirty pages are copied. Going back restores the nearest snapshot and replays the execution up to the target
+   * step, which relies on the machine being deterministic.
+   *
+   * The number of snapshots is bounded. Once the bound is reached every other snapshot is dropped and the interval
+   * doubles, so replaying costs at most an interval of steps relative to the length of the execution.
+   */
+  class execution_history final
+  {
+  public:
+    static constexpr std::uint64_t default_interval = 0x10000;
+    static constexpr std::size_t max_snapshots = 256;
+    static constexpr memory::size_type page_size = 0x400;
+
+    /**
+     * @brief Constructor
+     *
+     * The history is empty until it is reset.
+     *
+     * @param interval number of steps between two snapshots
+     */
+    YARISC_ARCH_EXPORT explicit execution_history(std::uint64_t interval = default_interval);
+
+    /**
+     * @brief Forgets all steps and starts with the current state of the machine as step zero
+     *
+     * @param m machine executed through the history from now on
+     */
+    YARISC_ARCH_EXPORT void reset(const machine& m);
+
+    /**
+     * @brief Returns the number of steps executed since the reset
+     */
+    [[nodiscard]] std::uint64_t step() const noexcept
+    {
+      return step_;
+    }
+
+    /**
+     * @brief Returns the current number of steps between two snapshots
+     */
+    [[nodiscard]] std::uint64_t interval() const noexcept
+    {
+      return interval_;
+    }
+
+    /**
+     * @brief Returns the number of snapshots
+     */
+    [[nodiscard]] std::size_t snapshots() const noexcept
+    {
+      return snapshots_.size();
+    }
+
+    /**
+     * @brief Executes until a halt instruction is executed or a debugger breakpoint or watchpoint is hit
+     *
+     * @see machine::execute()
+     */
+    YARISC_ARCH_EXPORT bool execute(machine& m, execution_mode mode = execution_mode::normal);
+
+    /**
+     * @brief Executes a given number of steps
+     *
+     * @see machine::execute()
+     */
+    YARISC_ARCH_EXPORT std::pair<bool, std::uint64_t> execute(
+      machine& m, std::uint64_t steps, execution_mode mode = execution_mode::normal);
+
+    /**
+     * @brief Executes a given number of steps without stepping over a breakpoint at the instruction pointer
+     *
+     * An execution split into several calls stops at the same breakpoints as one call to execute().
+     *
+     * @see machine::continue_execution()
+     */
+    YARISC_ARCH_EXPORT std::pair<bool, std::uint64_t> continue_execution(
+      machine& m, std::uint64_t steps, execution_mode mode = execution_mode::normal);
+
+    /**
+     * @brief Goes back a given number of steps, at most to step zero
+     *
+     * @param m machine
+     * @param steps number of steps
+     * @param mode execution mode for the replay
+     * @return number of steps gone back
+     */
+    YARISC_ARCH_EXPORT std::uint64_t step_back(
+      machine& m, std::uint64_t steps, execution_mode mode = execution_mode::normal);
+
+    /**
+     * @brief Goes back to the latest earlier step at which the debugger has stopped the execution
+     *
+     * Breakpoints and watchpoints stop the replay like they stop the execution, so the machine is left stopped at that
+     * step. Breakpoints added after the step has been executed are found, too. Conditions that depend on earlier
+     * evaluations, like `changed`, see the replay as further evaluations.
+     *
+     * @param m machine
+     * @param mode execution mode for the replay
+     * @return the step or nothing if there is no such step, in which case the machine remains at the current step
+     */
+    YARISC_ARCH_EXPORT std::optional<std::uint64_t> reverse_continue(
+      machine& m, execution_mode mode = execution_mode::normal);
+
+  private:
+    using page = std::array<memory::value_type, page_size>;
+
+    struct snapshot final
+    {
+      std::uint64_t step;
+      machine_registers reg;
+      std::vector<std::shared_ptr<const page>> pages;
+    };
+
+    std::uint64_t base_interval_;
+    std::uint64_t interval_;
+    std::uint64_t step_{0};
+
+    /**
+     * @brief Snapshots in ascending order of their steps
+     */
+    std::vector<snapshot> snapshots_;
+
+    /**
+     * @brief Returns the nearest snapshot at or before the step
+     */
+    [[nodiscard]] std::vector<snapshot>::const_iterator nearest(std::uint64_t step) const noexcept;
+
+    [[nodiscard]] std::uint64_t next_snapshot() const noexcept;
+
+    /**
+     * @brief Executes in chunks up to the next snapshot
+     *
+     * @param resume whether the first chunk steps over a breakpoint at the instruction pointer
+     */
+    [[nodiscard]] std::pair<bool, std::uint64_t> execute(
+      machine& m, std::uint64_t steps, execution_mode mode, bool resume);
+
+    void take_snapshot(const machine& m);
+
+    void restore(machine& m, const snapshot& snap);
+
+    /**
+     * @brief Restores the nearest snapshot and replays the execution up to the step
+     */
+    void seek(machine& m, std::uint64_t step, execution_mode mode);
+  };
+
+} // namespace yarisc::arch
+
+#endif
@@ -0,0 +1,919 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/detail/jit_cache.hpp>
+
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/registers.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if YARISC_ARCH_JIT
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+namespace yarisc::arch::detail
+{
+#if YARISC_ARCH_JIT
+  namespace
+  {
+    /**
+     * @brief Host registers in the order of their encoding
+     */
+    enum class host : std::uint8_t
+    {
+      rax,
+      rcx,
+      rdx,
+      rbx,
+      rsp,
+      rbp,
+      rsi,
+      rdi,
+      r8,
+      r9,
+      r10,
+      r11,
+      r12,
+      r13,
+      r14,
+      r15,
+    };
+
+    /**
+     * @brief Condition codes of conditional jumps and `setcc`
+     */
+    enum class condition : std::uint8_t
+    {
+      carry = 0x2,
+      not_carry = 0x3,
+      zero = 0x4,
+      not_zero = 0x5,
+    };
+
+    // The registers `r0` to `r7` are kept in `r8` to `r15`, the status register in `rbx`, the remaining steps in `rbp`,
+    // the memory in `rsi`, and the context in `rdi`. The registers `rax`, `rcx`, and `rdx` are scratch registers.
+    constexpr host status_host = host::rbx;
+    constexpr host budget_host = host::rbp;
+    constexpr host memory_host = host::rsi;
+    constexpr host context_host = host::rdi;
+    constexpr host ip_host = host::r15;
+
+    [[nodiscard]] constexpr host guest_host(std::uint8_t index) noexcept
+    {
+      return static_cast<host>(static_cast<std::uint8_t>(host::r8) + index);
+    }
+
+    static_assert(guest_host(7) == ip_host);
+
+    [[nodiscard]] constexpr std::uint8_t code(host r) noexcept
+    {
+      return static_cast<std::uint8_t>(r);
+    }
+
+    /**
+     * @brief Memory operand `[base + index * scale + disp]`
+     */
+    struct memory_operand final
+    {
+      host base;
+      host index{host::rsp};
+      std::uint8_t scale{1};
+      std::int32_t disp{0};
+    };
+
+    [[nodiscard]] memory_operand at(host base, std::int32_t disp = 0) noexcept
+    {
+      return {base, host::rsp, 1, disp};
+    }
+
+    [[nodiscard]] memory_operand at(host base, host index, std::uint8_t scale, std::int32_t disp = 0) noexcept
+    {
+      assert(index != host::rsp);
+
+      return {base, index, scale, disp};
+    }
+
+    /**
+     * @brief Emits the few x86-64 instructions used by the translated code
+     *
+     * Operand sizes are given by the prefix of the mnemonic, e.g. `mov16` operates on 16-bit registers. All 32-bit
+     * operations clear the upper half of the 64-bit register.
+     */
+    class x64_assembler final
+    {
+    public:
+      explicit x64_assembler(std::byte* pos) noexcept
+        : pos_{pos}
+      {
+      }
+
+      [[nodiscard]] std::byte* position() const noexcept
+      {
+        return pos_;
+      }
+
+      void mov32(host dst, host src)
+      {
+        op_rr(0, {0x89}, src, dst);
+      }
+
+      void mov32(host dst, std::uint32_t imm)
+      {
+        rex(0, 0, 0, code(dst));
+        byte(0xb8 + (code(dst) & 0x7));
+        dword(imm);
+      }
+
+      void mov64(host dst, host src)
+      {
+        op_rr(8, {0x89}, src, dst);
+      }
+
+      void mov64(host dst, const memory_operand& src)
+      {
+        op_rm(8, {0x8b}, code(dst), src);
+      }
+
+      void mov64(const memory_operand& dst, host src)
+      {
+        op_rm(8, {0x89}, code(src), dst);
+      }
+
+      void mov16(const memory_operand& dst, host src)
+      {
+        op_rm(2, {0x89}, code(src), dst);
+      }
+
+      void mov8(const memory_operand& dst, std::uint8_t imm)
+      {
+        op_rm(0, {0xc6}, 0, dst);
+        byte(imm);
+      }
+
+      void movzx16(host dst, const memory_operand& src)
+      {
+        op_rm(0, {0x0f, 0xb7}, code(dst), src);
+      }
+
+      void lea32(host dst, const memory_operand& src)
+      {
+        op_rm(0, {0x8d}, code(dst), src);
+      }
+
+      void add16(host dst, host src)
+      {
+        op_rr(2, {0x01}, src, dst);
+      }
+
+      void add16(host dst, word_t imm)
+      {
+        op_rr(2, {0x81}, 0, dst);
+        word(imm);
+      }
+
+      void adc16(host dst, host src)
+      {
+        op_rr(2, {0x11}, src, dst);
+      }
+
+      void adc16(host dst, word_t imm)
+      {
+        op_rr(2, {0x81}, 2, dst);
+        word(imm);
+      }
+
+      void add64(host dst, std::int32_t imm)
+      {
+        op_rr(8, {0x81}, 0, dst);
+        dword(static_cast<std::uint32_t>(imm));
+      }
+
+      void sub64(host dst, std::int32_t imm)
+      {
+        op_rr(8, {0x81}, 5, dst);
+        dword(static_cast<std::uint32_t>(imm));
+      }
+
+      void cmp64(host dst, std::int32_t imm)
+      {
+        op_rr(8, {0x81}, 7, dst);
+        dword(static_cast<std::uint32_t>(imm));
+      }
+
+      void and32(host dst, std::uint32_t imm)
+      {
+        op_rr(0, {0x81}, 4, dst);
+        dword(imm);
+      }
+
+      void shr32(host dst, std::uint8_t imm)
+      {
+        op_rr(0, {0xc1}, 5, dst);
+        byte(imm);
+      }
+
+      void xor32(host dst, host src)
+      {
+        op_rr(0, {0x31}, src, dst);
+      }
+
+      void test32(host dst, host src)
+      {
+        op_rr(0, {0x85}, src, dst);
+      }
+
+      void test32(host dst, std::uint32_t imm)
+      {
+        op_rr(0, {0xf7}, 0, dst);
+        dword(imm);
+      }
+
+      /**
+       * @brief Copies the bit `imm` of `dst` into the carry flag
+       */
+      void bt32(host dst, std::uint8_t imm)
+      {
+        op_rr(0, {0x0f, 0xba}, 4, dst);
+        byte(imm);
+      }
+
+      /**
+       * @brief Copies the bit `bit % 64` of `dst` into the carry flag
+       */
+      void bt64(host dst, host bit)
+      {
+        op_rr(8, {0x0f, 0xa3}, bit, dst);
+      }
+
+      /**
+       * @brief Sets the low byte of `rax`, `rcx`, `rdx`, or `rbx` to the condition
+       */
+      void setcc(condition cc, host dst)
+      {
+        assert(code(dst) < 4);
+
+        byte(0x0f);
+        byte(0x90 + static_cast<std::uint8_t>(cc));
+        byte(0xc0 + code(dst));
+      }
+
+      void push(host r)
+      {
+        rex(0, 0, 0, code(r));
+        byte(0x50 + (code(r) & 0x7));
+      }
+
+      void pop(host r)
+      {
+        rex(0, 0, 0, code(r));
+        byte(0x58 + (code(r) & 0x7));
+      }
+
+      void ret()
+      {
+        byte(0xc3);
+      }
+
+      void jmp(const memory_operand& target)
+      {
+        op_rm(0, {0xff}, 4, target);
+      }
+
+      void jmp(const std::byte* target)
+      {
+        byte(0xe9);
+        patch(reserve_rel32(), target);
+      }
+
+      /**
+       * @brief Emits a conditional jump whose target is set later by `patch()`
+       *
+       * @return the position of the relative target address
+       */
+      [[nodiscard]] std::byte* jcc(condition cc)
+      {
+        byte(0x0f);
+        byte(0x80 + static_cast<std::uint8_t>(cc));
+
+        return reserve_rel32();
+      }
+
+      void jcc(condition cc, const std::byte* target)
+      {
+        patch(jcc(cc), target);
+      }
+
+      /**
+       * @brief Sets the target of a jump emitted before
+       *
+       * @param rel32 position of the relative target address
+       * @param target absolute target address
+       */
+      static void patch(std::byte* rel32, const std::byte* target) noexcept
+      {
+        const auto rel = static_cast<std::int32_t>(target - (rel32 + sizeof(std::int32_t)));
+
+        std::memcpy(rel32, &rel, sizeof(rel));
+      }
+
+    private:
+      std::byte* pos_;
+
+      void byte(unsigned int b) noexcept
+      {
+        *pos_++ = static_cast<std::byte>(b);
+      }
+
+      void word(word_t w) noexcept
+      {
+        byte(w & 0xff);
+        byte(w >> 8);
+      }
+
+      void dword(std::uint32_t d) noexcept
+      {
+        word(static_cast<word_t>(d & 0xffff));
+        word(static_cast<word_t>(d >> 16));
+      }
+
+      [[nodiscard]] std::byte* reserve_rel32() noexcept
+      {
+        std::byte* rel32 = pos_;
+        dword(0);
+
+        return rel32;
+      }
+
+      void rex(unsigned int w, unsigned int reg, unsigned int index, unsigned int base) noexcept
+      {
+        const unsigned int prefix = 0x40 | (w << 3) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+
+        if (prefix != 0x40)
+          byte(prefix);
+      }
+
+      void prefix(unsigned int size, unsigned int reg, unsigned int index, unsigned int base) noexcept
+      {
+        if (size == 2)
+          byte(0x66);
+
+        rex((size == 8) ? 1 : 0, reg, index, base);
+      }
+
+      void opcode(std::initializer_list<std::uint8_t> op) noexcept
+      {
+        for (const std::uint8_t b : op)
+          byte(b);
+      }
+
+      /**
+       * @brief Emits an instruction with a register or an opcode extension and a register operand
+       */
+      void op_rr(unsigned int size, std::initializer_list<std::uint8_t> op, host reg, host rm) noexcept
+      {
+        op_rr(size, op, code(reg), rm);
+      }
+
+      void op_rr(unsigned int size, std::initializer_list<std::uint8_t> op, std::uint8_t reg, host rm) noexcept
+      {
+        prefix(size, reg, 0, code(rm));
+        opcode(op);
+        byte(0xc0 | ((reg & 0x7) << 3) | (code(rm) & 0x7));
+      }
+
+      /**
+       * @brief Emits an instruction with a register or an opcode extension and a memory operand
+       *
+       * The address always uses a 32-bit displacement, which keeps the special cases of `rbp` and `r13` away.
+       */
+      void op_rm(unsigned int size, std::initializer_list<std::uint8_t> op, std::uint8_t reg, const memory_operand& m)
+      {
+        const bool sib = (m.index != host::rsp) || ((code(m.base) & 0x7) == code(host::rsp));
+
+        prefix(size, reg, code(m.index), code(m.base));
+        opcode(op);
+
+        if (sib)
+        {
+          const unsigned int scale = (m.scale == 8) ? 3 : (m.scale == 4) ? 2 : (m.scale == 2) ? 1 : 0;
+
+          byte(0x84 | ((reg & 0x7) << 3));
+          byte((scale << 6) | ((code(m.index) & 0x7) << 3) | (code(m.base) & 0x7));
+        }
+        else
+        {
+          byte(0x80 | ((reg & 0x7) << 3) | (code(m.base) & 0x7));
+        }
+
+        dword(static_cast<std::uint32_t>(m.disp));
+      }
+    };
+
+    template <typename T>
+    [[nodiscard]] std::int32_t offset(T jit_context::*member) noexcept
+    {
+      const jit_context ctx{};
+
+      return static_cast<std::int32_t>(
+        reinterpret_cast<const std::byte*>(&(ctx.*member)) - reinterpret_cast<const std::byte*>(&ctx));
+    }
+
+    [[nodiscard]] memory_operand register_operand(std::uint8_t index) noexcept
+    {
+      return at(context_host, offset(&jit_context::r) + static_cast<std::int32_t>(index * sizeof(word_t)));
+    }
+
+    /**
+     * @brief Jumps to the translated code of the instruction pointer or to the exit stub
+     */
+    void emit_chain(x64_assembler& a)
+    {
+      a.mov64(host::rcx, at(context_host, offset(&jit_context::table)));
+      a.jmp(at(host::rcx, ip_host, sizeof(void*)));
+    }
+
+    /**
+     * @brief Updates the zero flag like `update_zero_flag`
+     */
+    void emit_zero_flag(x64_assembler& a, host value)
+    {
+      a.xor32(host::rdx, host::rdx);
+      a.and32(status_host, static_cast<word_t>(~status_register::zero_flag));
+      a.test32(value, value);
+      a.setcc(condition::zero, host::rdx);
+      a.lea32(status_host, at(status_host, host::rdx, status_register::zero_flag));
+    }
+
+    /**
+     * @brief Returns whether the instruction reads the instruction pointer from `r7`
+     */
+    [[nodiscard]] bool reads_ip(const decoded_instruction& instr) noexcept
+    {
+      constexpr std::uint8_t ip_index = 7;
+
+      switch (instr.get_opcode())
+      {
+      case opcode::move:
+      case opcode::load:
+        return (instr.form == operand_form::registers) && (instr.op1 == ip_index);
+      case opcode::store:
+        return (instr.op0 == ip_index) || ((instr.form == operand_form::registers) && (instr.op1 == ip_index));
+      case opcode::add:
+      case opcode::add_with_carry:
+        return ((instr.form != operand_form::immediate_op1) && (instr.op1 == ip_index)) ||
+               ((instr.form != operand_form::immediate_op2) && (instr.op2 == ip_index));
+      default:
+        return false;
+      }
+    }
+
+    /**
+     * @brief Exit of a block which is emitted after the code of all instructions
+     */
+    struct pending_exit final
+    {
+      std::byte* rel32;
+      address_t ip;
+
+      /**
+       * @brief Steps charged on entry to the block which have not been executed
+       */
+      std::int32_t refund;
+
+      jit_exit reason;
+    };
+
+    /**
+     * @brief Upper bound of the code size of a single instruction including its exits
+     */
+    constexpr std::size_t max_instruction_code_size = 160;
+
+    constexpr std::size_t max_block_code_size = 32 + block_cache::max_block_size * max_instruction_code_size;
+
+    /**
+     * @brief Makes the code buffer either writable or executable, but never both at the same time
+     *
+     * @return false if the protection could not be changed
+     */
+    [[nodiscard]] bool protect(std::byte* buffer, bool writable) noexcept
+    {
+#if defined(_WIN32)
+      DWORD previous = 0;
+
+      return VirtualProtect(buffer, jit_cache::code_size, writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &previous) !=
+             0;
+#else
+      return mprotect(buffer, jit_cache::code_size, writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC)) == 0;
+#endif
+    }
+
+  } // namespace
+#endif
+
+  bool jit_cache::translate(const basic_block& b, const decoded_instruction* instructions)
+  {
+#if YARISC_ARCH_JIT
+    if (!buffer_ && !allocate())
+      return false;
+
+    if (size_ + max_block_code_size > code_size)
+      reset();
+
+    // The translation runs only while no translated code is executed, so the buffer is writable just for this time
+    if (!protect(buffer_.get(), true))
+      return false;
+
+    std::byte* const begin = buffer_.get() + size_;
+    x64_assembler a{begin};
+
+    // Charge the steps of the whole block on entry, the exits refund the steps which have not been executed
+    const auto block_size = static_cast<std::int32_t>(b.size);
+
+    a.cmp64(budget_host, block_size);
+    a.jcc(condition::carry, exit_);
+    a.sub64(budget_host, block_size);
+
+    std::vector<pending_exit> exits;
+
+    address_t address = b.entry;
+    bool chained = false;
+
+    for (std::uint32_t i = 0; i < b.size; ++i)
+    {
+      const decoded_instruction& instr = instructions[i];
+      const auto next = static_cast<address_t>(address + instr.size());
+      const auto refund = static_cast<std::int32_t>(b.size - i - 1);
+
+      if (reads_ip(instr))
+        a.mov32(ip_host, next);
+
+      const host op0 = guest_host(instr.op0);
+      const host op1 = guest_host(instr.op1);
+      const host op2 = guest_host(instr.op2);
+
+      bool writes_ip = false;
+
+      switch (instr.get_opcode())
+      {
+      case opcode::move:
+      {
+        if (instr.form == operand_form::immediate_op1)
+          a.mov32(op0, instr.imm);
+        else
+          a.mov32(op0, op1);
+
+        emit_zero_flag(a, op0);
+        writes_ip = (op0 == ip_host);
+      }
+      break;
+
+      case opcode::load:
+      {
+        if (instr.form == operand_form::immediate_op1)
+          a.movzx16(op0, at(memory_host, instr.imm));
+        else
+          a.movzx16(op0, at(memory_host, op1, 1));
+
+        emit_zero_flag(a, op0);
+        writes_ip = (op0 == ip_host);
+      }
+      break;
+
+      case opcode::store:
+      {
+        if (instr.form == operand_form::immediate_op1)
+        {
+          a.mov16(at(memory_host, instr.imm), op0);
+          a.mov32(host::rax, instr.imm);
+        }
+        else
+        {
+          a.mov16(at(memory_host, op1, 1), op0);
+          a.mov32(host::rax, op1);
+        }
+
+        // Invalidate the decode cache like `decode_cache::invalidate()`
+        constexpr auto index_mask = static_cast<std::uint32_t>(decode_cache::num_entries - 1);
+        constexpr auto form_offset = static_cast<std::int32_t>(offsetof(decoded_instruction, form));
+
+        static_assert(sizeof(decoded_instruction) == 8);
+        static_assert(static_cast<std::uint8_t>(operand_form::empty) == 0);
+
+        a.shr32(host::rax, 1);
+        a.mov64(host::rcx, at(context_host, offset(&jit_context::entries)));
+        a.mov8(at(host::rcx, host::rax, sizeof(decoded_instruction), form_offset), 0);
+        a.lea32(host::rdx, at(host::rax, -1));
+        a.and32(host::rdx, index_mask);
+        a.mov8(at(host::rcx, host::rdx, sizeof(decoded_instruction), form_offset), 0);
+
+        // Leave the translated code if the word is covered by a block
+        a.mov32(host::rdx, host::rax);
+        a.shr32(host::rdx, 6);
+        a.mov64(host::rcx, at(context_host, offset(&jit_context::code)));
+        a.mov64(host::rcx, at(host::rcx, host::rdx, sizeof(std::uint64_t)));
+        a.bt64(host::rcx, host::rax);
+
+        exits.push_back({a.jcc(condition::carry), next, refund, jit_exit::code_modified});
+      }
+      break;
+
+      case opcode::add:
+      case opcode::add_with_carry:
+      {
+        const bool carry = (instr.get_opcode() == opcode::add_with_carry);
+
+        // The scratch registers are cleared before the flags are computed, so that `setcc` sets the whole register
+        a.xor32(host::rcx, host::rcx);
+        a.xor32(host::rdx, host::rdx);
+
+        if (instr.form == operand_form::immediate_op1)
+          a.mov32(host::rax, instr.imm);
+        else
+          a.mov32(host::rax, op1);
+
+        if (carry)
+          a.bt32(status_host, status_register::carry_pos);
+
+        if (instr.form == operand_form::immediate_op2)
+        {
+          if (carry)
+            a.adc16(host::rax, instr.imm);
+          else
+            a.add16(host::rax, instr.imm);
+        }
+        else
+        {
+          if (carry)
+            a.adc16(host::rax, op2);
+          else
+            a.add16(host::rax, op2);
+        }
+
+        static_assert(status_register::carry_flag == 0x1);
+        static_assert(status_register::zero_flag == 0x2);
+
+        a.setcc(condition::carry, host::rcx);
+        a.setcc(condition::zero, host::rdx);
+        a.lea32(status_host, at(host::rcx, host::rdx, 2));
+        a.mov32(op0, host::rax);
+
+        writes_ip = (op0 == ip_host);
+      }
+      break;
+
+      case opcode::jump:
+      {
+        a.mov32(ip_host, instr.imm);
+        writes_ip = true;
+      }
+      break;
+
+      case opcode::cond_jump:
+      {
+        a.test32(status_host, instr.op0);
+
+        exits.push_back(
+          {a.jcc(instr.op1 ? condition::zero : condition::not_zero), instr.imm, refund, jit_exit::untranslated});
+
+        a.mov32(ip_host, next);
+        writes_ip = true;
+      }
+      break;
+
+      case opcode::noop:
+        break;
+
+      case opcode::halt:
+      {
+        // The halt instruction is not counted as a step
+        a.mov32(ip_host, next);
+        a.add64(budget_host, refund + 1);
+        a.mov32(host::rax, static_cast<std::uint32_t>(jit_exit::halt));
+        a.jmp(epilogue_);
+
+        chained = true;
+      }
+      break;
+
+      default:
+        // Instructions of other opcodes are decoded as fallback and never end up in blocks
+        assert(false);
+        break;
+      }
+
+      if (writes_ip)
+      {
+        assert(refund == 0);
+
+        emit_chain(a);
+        chained = true;
+      }
+
+      address = next;
+    }
+
+    if (!chained)
+    {
+      // The block has reached its maximum size
+      a.mov32(ip_host, b.end);
+      emit_chain(a);
+    }
+
+    for (const pending_exit& e : exits)
+    {
+      x64_assembler::patch(e.rel32, a.position());
+
+      a.mov32(ip_host, e.ip);
+
+      if (e.refund != 0)
+        a.add64(budget_host, e.refund);
+
+      if (e.reason == jit_exit::untranslated)
+      {
+        emit_chain(a);
+      }
+      else
+      {
+        a.mov32(host::rax, static_cast<std::uint32_t>(e.reason));
+        a.jmp(epilogue_);
+      }
+    }
+
+    const auto size = static_cast<std::size_t>(a.position() - begin);
+
+    assert(size <= max_block_code_size);
+
+    if (!protect(buffer_.get(), false))
+    {
+      // Without executable code nothing is translated anymore
+      buffer_.reset();
+      failed_ = true;
+
+      return false;
+    }
+
+    size_ += size;
+    table_[b.entry] = begin;
+
+    return true;
+#else
+    static_cast<void>(b);
+    static_cast<void>(instructions);
+
+    return false;
+#endif
+  }
+
+  jit_exit jit_cache::run(jit_context& ctx) const noexcept
+  {
+    assert(translated(static_cast<address_t>(ctx.r[7])));
+
+    ctx.table = table_.get();
+
+    return static_cast<jit_exit>(entry_(&ctx));
+  }
+
+  void jit_cache::buffer_deleter::operator()(std::byte* buffer) const noexcept
+  {
+#if YARISC_ARCH_JIT
+#if defined(_WIN32)
+    VirtualFree(buffer, 0, MEM_RELEASE);
+#else
+    munmap(buffer, code_size);
+#endif
+#else
+    static_cast<void>(buffer);
+#endif
+  }
+
+  bool jit_cache::allocate()
+  {
+#if YARISC_ARCH_JIT
+    if (failed_)
+      return false;
+
+    // The buffer is writable while code is emitted and executable otherwise, see `protect()`
+#if defined(_WIN32)
+    void* buffer = VirtualAlloc(nullptr, code_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+    if (!buffer)
+    {
+      failed_ = true;
+
+      return false;
+    }
+#else
+    void* buffer = mmap(nullptr, code_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (buffer == MAP_FAILED)
+    {
+      failed_ = true;
+
+      return false;
+    }
+#endif
+
+    buffer_.reset(static_cast<std::byte*>(buffer));
+    table_ = std::make_unique<const std::byte*[]>(num_addresses);
+
+    x64_assembler a{buffer_.get()};
+
+    constexpr std::array<host, 8> saved{{
+      host::rbx,
+      host::rbp,
+      host::rsi,
+      host::rdi,
+      host::r12,
+      host::r13,
+      host::r14,
+      host::r15,
+    }};
+
+    // Entry stub, which saves the callee-saved registers of both the Windows and the System V calling convention
+    entry_ = reinterpret_cast<std::uint32_t (*)(jit_context*)>(a.position());
+
+    for (const host r : saved)
+      a.push(r);
+
+#if defined(_WIN32)
+    a.mov64(context_host, host::rcx);
+#endif
+
+    for (std::uint8_t i = 0; i < num_registers; ++i)
+      a.movzx16(guest_host(i), register_operand(i));
+
+    a.movzx16(status_host, at(context_host, offset(&jit_context::status)));
+    a.mov64(budget_host, at(context_host, offset(&jit_context::budget)));
+    a.mov64(memory_host, at(context_host, offset(&jit_context::memory)));
+
+    emit_chain(a);
+
+    // Epilogue, which expects the reason in `eax`
+    epilogue_ = a.position();
+
+    for (std::uint8_t i = 0; i < num_registers; ++i)
+      a.mov16(register_operand(i), guest_host(i));
+
+    a.mov16(at(context_host, offset(&jit_context::status)), status_host);
+    a.mov64(at(context_host, offset(&jit_context::budget)), budget_host);
+
+    for (auto it = saved.rbegin(); it != saved.rend(); ++it)
+      a.pop(*it);
+
+    a.ret();
+
+    // Exit stub for addresses without translated code
+    exit_ = a.position();
+
+    a.mov32(host::rax, static_cast<std::uint32_t>(jit_exit::untranslated));
+    a.jmp(epilogue_);
+
+    stubs_size_ = static_cast<std::size_t>(a.position() - buffer_.get());
+
+    reset();
+
+    if (!protect(buffer_.get(), false))
+    {
+      buffer_.reset();
+      failed_ = true;
+
+      return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void jit_cache::reset() noexcept
+  {
+    if (buffer_)
+    {
+      size_ = stubs_size_;
+      std::fill_n(table_.get(), num_addresses, exit_);
+    }
+
+    if (counters_)
+      std::fill_n(counters_.get(), block_cache::num_words, std::uint8_t{0});
+  }
+
+} // namespace yarisc::arch::detail
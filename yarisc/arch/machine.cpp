@@ -5,39 +5,127 @@
 
 #include <yarisc/arch/machine.hpp>
 
+#include <yarisc/arch/detail/block.hpp>
 #include <yarisc/arch/detail/execution.hpp>
+#include <yarisc/arch/detail/jit.hpp>
+#include <yarisc/arch/detail/threaded.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <fstream>
 #include <ios>
 #include <iterator>
+#include <limits>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace yarisc::arch
 {
   namespace
   {
+    template <execution_engine Engine>
+    using engine_constant = std::integral_constant<execution_engine, Engine>;
+
+    template <typename Policy, typename Func, typename... Args>
+    decltype(auto) switch_engine(execution_engine engine, Policy policy, Func&& func, Args&&... args)
+    {
+      // Only the reference interpreter evaluates the status flags eagerly
+      switch (engine)
+      {
+      case execution_engine::interpreter:
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::interpreter>{}, std::move(policy), std::forward<Args>(args)...);
+      case execution_engine::predecoded:
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::predecoded>{},
+          detail::make_lazy_flags_policy(std::move(policy)),
+          std::forward<Args>(args)...);
+      case execution_engine::threaded:
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::threaded>{},
+          detail::make_lazy_flags_policy(std::move(policy)),
+          std::forward<Args>(args)...);
+      case execution_engine::block:
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::block>{},
+          detail::make_lazy_flags_policy(std::move(policy)),
+          std::forward<Args>(args)...);
+      case execution_engine::jit:
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::jit>{},
+          detail::make_lazy_flags_policy(std::move(policy)),
+          std::forward<Args>(args)...);
+      default:
+        throw std::runtime_error{
+          "Invalid execution engine " + std::to_string(static_cast<std::underlying_type_t<execution_engine>>(engine))};
+      }
+    }
+
+    template <typename Profile, typename Debug, typename Strict, typename Func, typename... Args>
+    decltype(auto) switch_monitor(
+      Debug debug_policy,
+      Strict strict_policy,
+      detail::cache_execution_policy cache_policy,
+      execution_monitor* monitor,
+      execution_engine engine,
+      Func&& func,
+      Args&&... args)
+    {
+      // The monitor hooks into the fetches of the reference interpreter, the other engines are not instrumented at all
+      if (monitor)
+      {
+        return std::forward<Func>(func)(
+          engine_constant<execution_engine::interpreter>{},
+          detail::make_execution_policy<Profile>(
+            debug_policy, strict_policy, cache_policy, detail::monitor_execution_policy{monitor}),
+          std::forward<Args>(args)...);
+      }
+
+      return switch_engine(
+        engine,
+        detail::make_execution_policy<Profile>(debug_policy, strict_policy, cache_policy),
+        std::forward<Func>(func),
+        std::forward<Args>(args)...);
+    }
+
     template <typename Profile, typename Func, typename... Args>
-    decltype(auto) switch_policy(debugger* dbg, execution_mode mode, Func&& func, Args&&... args)
+    decltype(auto) switch_policy(
+      debugger* dbg,
+      execution_monitor* monitor,
+      detail::cache_execution_policy cache_policy,
+      execution_mode mode,
+      execution_engine engine,
+      Func&& func,
+      Args&&... args)
     {
       if (mode == execution_mode::strict)
       {
         if (dbg)
         {
-          return std::forward<Func>(func)(
-            detail::make_execution_policy<Profile>(
-              detail::debug_execution_policy{dbg}, detail::strict_execution_policy{}),
+          return switch_monitor<Profile>(
+            detail::debug_execution_policy{dbg},
+            detail::strict_execution_policy{},
+            cache_policy,
+            monitor,
+            engine,
+            std::forward<Func>(func),
             std::forward<Args>(args)...);
         }
         else
         {
-          return std::forward<Func>(func)(
-            detail::make_execution_policy<Profile>(
-              detail::noop_debug_execution_policy{}, detail::strict_execution_policy{}),
+          return switch_monitor<Profile>(
+            detail::noop_debug_execution_policy{},
+            detail::strict_execution_policy{},
+            cache_policy,
+            monitor,
+            engine,
+            std::forward<Func>(func),
             std::forward<Args>(args)...);
         }
       }
@@ -45,71 +133,213 @@ namespace yarisc::arch
       {
         if (dbg)
         {
-          return std::forward<Func>(func)(
-            detail::make_execution_policy<Profile>(
-              detail::debug_execution_policy{dbg}, detail::noop_strict_execution_policy{}),
+          return switch_monitor<Profile>(
+            detail::debug_execution_policy{dbg},
+            detail::noop_strict_execution_policy{},
+            cache_policy,
+            monitor,
+            engine,
+            std::forward<Func>(func),
             std::forward<Args>(args)...);
         }
         else
         {
-          return std::forward<Func>(func)(
-            detail::make_execution_policy<Profile>(
-              detail::noop_debug_execution_policy{}, detail::noop_strict_execution_policy{}),
+          return switch_monitor<Profile>(
+            detail::noop_debug_execution_policy{},
+            detail::noop_strict_execution_policy{},
+            cache_policy,
+            monitor,
+            engine,
+            std::forward<Func>(func),
             std::forward<Args>(args)...);
         }
       }
     }
 
     template <typename Func, typename... Args>
-    decltype(auto) switch_level(debugger* dbg, feature_level level, execution_mode mode, Func&& func, Args&&... args)
+    decltype(auto) switch_level(
+      debugger* dbg,
+      execution_monitor* monitor,
+      detail::cache_execution_policy cache_policy,
+      feature_level level,
+      execution_mode mode,
+      execution_engine engine,
+      Func&& func,
+      Args&&... args)
     {
       switch (level)
       {
       case feature_level::min:
         return switch_policy<machine_profile<feature_level::min>>(
-          dbg, mode, std::forward<Func>(func), std::forward<Args>(args)...);
+          dbg, monitor, cache_policy, mode, engine, std::forward<Func>(func), std::forward<Args>(args)...);
       case feature_level::v1:
         return switch_policy<machine_profile<feature_level::v1>>(
-          dbg, mode, std::forward<Func>(func), std::forward<Args>(args)...);
+          dbg, monitor, cache_policy, mode, engine, std::forward<Func>(func), std::forward<Args>(args)...);
       default:
         throw std::runtime_error{
           "Invalid feature level " + std::to_string(static_cast<std::underlying_type_t<feature_level>>(level))};
       }
     }
 
+    template <execution_engine Engine, typename Policy>
+    [[nodiscard]] detail::execute_result execute_step(
+      engine_constant<Engine>, Policy& policy, detail::machine_data& data)
+    {
+      if constexpr (Engine == execution_engine::interpreter)
+        return detail::execute_instruction(policy, data.state.reg, data.mem);
+      else
+        return detail::execute_decoded_instruction(policy, data.state.reg, data.mem);
+    }
+
+    template <execution_engine Engine, typename Policy>
+    [[nodiscard]] std::pair<detail::execute_result, std::uint64_t> execute_steps(
+      engine_constant<Engine>, Policy& policy, detail::machine_data& data, std::uint64_t steps)
+    {
+      if constexpr (Engine == execution_engine::jit)
+        return detail::execute_jit(policy, data.state.reg, data.mem, steps);
+      else if constexpr (Engine == execution_engine::block)
+        return detail::execute_blocks(policy, data.state.reg, data.mem, steps);
+      else
+        return detail::execute_threaded(policy, data.state.reg, data.mem, steps);
+    }
+
+    /**
+     * @brief Number of steps between two checks for an idle loop
+     *
+     * It is the least common multiple of 1 to 16, so every loop of up to 16 steps per iteration is back at the same
+     * instruction after each check.
+     */
+    constexpr std::uint64_t idle_check_steps = 720720;
+
+    /**
+     * @brief Detects loops that have reached a fixed point like `JMP self` or a polling loop on unchanged memory
+     *
+     * The machine is deterministic, so if the registers and the memory are the same after `idle_check_steps` steps, the
+     * machine repeats these steps forever. The memory is only copied once the registers have repeated.
+     */
+    class idle_detector final
+    {
+    public:
+      /**
+       * @brief Checks the machine after the next `idle_check_steps` steps have been executed
+       *
+       * @param data registers and memory of the machine with the status flags stored
+       * @return whether the machine is in the same state as after the previous check
+       */
+      [[nodiscard]] bool check(const detail::machine_data& data)
+      {
+        if (!registers_ || (*registers_ != data.state.reg)) [[likely]]
+        {
+          registers_ = data.state.reg;
+          main_.reset();
+
+          return false;
+        }
+
+        if (main_ && (*main_ == data.mem.main))
+          return true;
+
+        main_ = data.mem.main;
+
+        return false;
+      }
+
+    private:
+      std::optional<machine_registers> registers_;
+      std::optional<memory> main_;
+    };
+
     struct execute_func final
     {
       execute_func() = default;
 
-      template <typename Policy>
-      [[nodiscard]] bool operator()(Policy policy, detail::machine_data& data)
+      template <execution_engine Engine, typename Policy>
+      [[nodiscard]] bool operator()(engine_constant<Engine> engine, Policy policy, detail::machine_data& data)
       {
+        detail::flags_scope scope{policy, data.state.reg};
         detail::execute_result result{};
 
-        while (result.keep_going) [[likely]]
-          result = detail::execute_instruction(policy, data.state.reg, data.mem);
+        if constexpr (Engine != execution_engine::interpreter && Engine != execution_engine::predecoded)
+        {
+          constexpr auto max_steps = std::numeric_limits<std::uint64_t>::max();
+
+          while (result.keep_going) [[likely]]
+            result = execute_steps(engine, policy, data, max_steps).first;
+        }
+        else
+        {
+          while (result.keep_going) [[likely]]
+            result = execute_step(engine, policy, data);
+        }
 
         return !result.breakpoint;
       }
 
-      template <typename Policy>
+      template <execution_engine Engine, typename Policy>
       [[nodiscard]] std::pair<bool, std::uint64_t> operator()(
-        Policy policy, detail::machine_data& data, std::uint64_t steps)
+        engine_constant<Engine> engine, Policy policy, detail::machine_data& data, std::uint64_t steps)
       {
+        detail::flags_scope scope{policy, data.state.reg};
         detail::execute_result result{};
 
         std::uint64_t s = 0;
-        bool compute = (steps > 0);
 
-        while (compute) [[likely]]
+        // Short runs are not worth the checks, and a monitor has to see every step
+        if ((steps <= idle_check_steps) || Policy::monitor_policy::enabled)
+        {
+          std::tie(result, s) = execute_chunk(engine, policy, data, steps);
+
+          return {!result.breakpoint && !result.keep_going, s};
+        }
+
+        idle_detector idle;
+
+        while (s < steps)
         {
-          result = detail::execute_instruction(policy, data.state.reg, data.mem);
+          const std::uint64_t chunk = std::min(steps - s, idle_check_steps);
+          const auto [chunk_result, executed] = execute_chunk(engine, policy, data, chunk);
+
+          result = chunk_result;
+          s += executed;
+
+          if (!result.keep_going || (s == steps))
+            break;
 
-          compute = result.keep_going && (steps > ++s);
+          policy.store_flags(data.state.reg);
+
+          // Skip the remaining full rounds of the idle loop, which end in the same state
+          if (idle.check(data)) [[unlikely]]
+            s += (steps - s) / idle_check_steps * idle_check_steps;
         }
 
         return {!result.breakpoint && !result.keep_going, s};
       }
+
+    private:
+      template <execution_engine Engine, typename Policy>
+      [[nodiscard]] static std::pair<detail::execute_result, std::uint64_t> execute_chunk(
+        engine_constant<Engine> engine, Policy& policy, detail::machine_data& data, std::uint64_t steps)
+      {
+        if constexpr (Engine != execution_engine::interpreter && Engine != execution_engine::predecoded)
+        {
+          return execute_steps(engine, policy, data, steps);
+        }
+        else
+        {
+          detail::execute_result result{};
+          std::uint64_t s = 0;
+          bool compute = (steps > 0);
+
+          while (compute) [[likely]]
+          {
+            result = execute_step(engine, policy, data);
+
+            compute = result.keep_going && (steps > ++s);
+          }
+
+          return {result, s};
+        }
+      }
     };
 
   } // namespace
@@ -154,17 +384,115 @@ namespace yarisc::arch
       assert(buf.size() <= data_.mem.main.size());
 
       std::memcpy(data_.mem.main.data(), buf.data(), buf.size());
+
+      invalidate_code();
     }
   }
 
   bool machine::execute(execution_mode mode)
   {
-    return switch_level(debugger_.get(), level_, mode, execute_func{}, data_);
+    cache_.refresh();
+
+    if (debugger_)
+    {
+      const bool watchpoint = debugger_->hit().has_value();
+      debugger_->reset_hit();
+
+      if (watchpoint || debugger_->breakpoint(static_cast<address_t>(data_.state.reg.named.ip())))
+      {
+        const auto [halted, steps] = step_over(mode, watchpoint);
+
+        if (steps == 0)
+          return halted;
+      }
+    }
+
+    return switch_level(
+      debugger_.get(), monitor_.get(), {&cache_, &blocks_, &jit_}, level_, mode, engine_, execute_func{}, data_);
   }
 
   std::pair<bool, std::uint64_t> machine::execute(std::uint64_t steps, execution_mode mode)
   {
-    return switch_level(debugger_.get(), level_, mode, execute_func{}, data_, steps);
+    cache_.refresh();
+
+    std::uint64_t stepped = 0;
+
+    if ((steps > 0) && debugger_)
+    {
+      const bool watchpoint = debugger_->hit().has_value();
+      debugger_->reset_hit();
+
+      if (watchpoint || debugger_->breakpoint(static_cast<address_t>(data_.state.reg.named.ip())))
+      {
+        const auto [halted, s] = step_over(mode, watchpoint);
+
+        if (s == 0)
+          return {halted, 0};
+
+        stepped = s;
+      }
+    }
+
+    const auto [halted, s] = switch_level(
+      debugger_.get(),
+      monitor_.get(),
+      {&cache_, &blocks_, &jit_},
+      level_,
+      mode,
+      engine_,
+      execute_func{},
+      data_,
+      steps - stepped);
+
+    return {halted, s + stepped};
+  }
+
+  std::pair<bool, std::uint64_t> machine::continue_execution(std::uint64_t steps, execution_mode mode)
+  {
+    cache_.refresh();
+
+    if (debugger_)
+      debugger_->reset_hit();
+
+    return switch_level(
+      debugger_.get(), monitor_.get(), {&cache_, &blocks_, &jit_}, level_, mode, engine_, execute_func{}, data_, steps);
+  }
+
+  std::pair<bool, std::uint64_t> machine::step_over(execution_mode mode, bool watchpoints)
+  {
+    const auto address = static_cast<address_t>(data_.state.reg.named.ip() & ~word_t{sizeof(word_t) - 1});
+
+    // Suspending keeps the condition of the breakpoint
+    const bool breakpoint = debugger_->breakpoint(address);
+
+    if (breakpoint)
+      debugger_->suspend_breakpoint(address, true);
+
+    if (watchpoints)
+      debugger_->suspend_watchpoints(true);
+
+    const auto restore = [&]() {
+      if (breakpoint)
+        debugger_->suspend_breakpoint(address, false);
+
+      if (watchpoints)
+        debugger_->suspend_watchpoints(false);
+    };
+
+    try
+    {
+      const auto result = switch_level(
+        debugger_.get(), monitor_.get(), {&cache_, &blocks_, &jit_}, level_, mode, engine_, execute_func{}, data_, 1);
+
+      restore();
+
+      return result;
+    }
+    catch (...)
+    {
+      restore();
+      throw;
+    }
   }
 
 } // namespace yarisc::arch
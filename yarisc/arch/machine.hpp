@@ -6,6 +6,9 @@
 #ifndef YARISC_ARCH_MACHINE_HPP
 #define YARISC_ARCH_MACHINE_HPP
 
+#include <yarisc/arch/detail/block_cache.hpp>
+#include <yarisc/arch/detail/decode.hpp>
+#include <yarisc/arch/detail/jit_cache.hpp>
 #include <yarisc/arch/export.h>
 #include <yarisc/arch/feature_level.hpp>
 #include <yarisc/arch/machine_model.hpp>
@@ -20,8 +23,10 @@
 namespace yarisc::arch
 {
   class debugger;
+  class execution_monitor;
 
   using debugger_ptr = std::shared_ptr<debugger>;
+  using monitor_ptr = std::shared_ptr<execution_monitor>;
 
   /**
    * @brief Execution mode
@@ -42,6 +47,39 @@ namespace yarisc::arch
     strict,
   };
 
+  /**
+   * @brief Engine that executes the instructions
+   */
+  enum class execution_engine
+  {
+    /**
+     * @brief Reference interpreter that decodes every instruction word when it is executed
+     */
+    interpreter,
+
+    /**
+     * @brief Executes predecoded instructions from the decode cache through a central switch
+     */
+    predecoded,
+
+    /**
+     * @brief Executes predecoded instructions with a threaded dispatch from handler to handler
+     */
+    threaded,
+
+    /**
+     * @brief Executes cached basic blocks which are linked to their successors
+     */
+    block,
+
+    /**
+     * @brief Translates hot basic blocks to native code
+     *
+     * Translation is supported on x86-64 in normal mode without breakpoints. Otherwise this is the threaded engine.
+     */
+    jit,
+  };
+
   /**
    * @brief Machine state
    *
@@ -155,6 +193,16 @@ namespace yarisc::arch
       return data_.state;
     }
 
+    /**
+     * @brief Sets the registers of the machine, for example to restore a snapshot
+     *
+     * @param reg new register values
+     */
+    void set_registers(const machine_registers& reg) noexcept
+    {
+      data_.state.reg = reg;
+    }
+
     /**
      * @brief Returns the state of the machine for output
      */
@@ -165,9 +213,14 @@ namespace yarisc::arch
 
     /**
      * @brief Returns the main memory of the machine
+     *
+     * @note
+     * This invalidates all decoded instructions, because the memory may be modified through the returned reference.
      */
     [[nodiscard]] memory& main_memory() noexcept
     {
+      invalidate_code();
+
       return data_.mem.main;
     }
 
@@ -179,6 +232,16 @@ namespace yarisc::arch
       return data_.mem.main;
     }
 
+    /**
+     * @brief Returns the number of times the decoded and translated code has been discarded
+     *
+     * Code is discarded by the next execution after main memory has been accessed through a mutable reference.
+     */
+    [[nodiscard]] std::uint64_t code_generation() const noexcept
+    {
+      return blocks_.generation();
+    }
+
     /**
      * @brief Returns a view into main memory of the machine
      *
@@ -203,7 +266,10 @@ namespace yarisc::arch
     YARISC_ARCH_EXPORT void load(const std::filesystem::path& image);
 
     /**
-     * @brief Executes until a halt instruction is executed or a debugger breakpoint is hit
+     * @brief Executes until a halt instruction is executed or a debugger breakpoint or watchpoint is hit
+     *
+     * A breakpoint at the instruction pointer and the instruction that hit a watchpoint are stepped over, so execution
+     * resumes after it has been hit.
      *
      * @param mode execution mode normal or strict
      * @return true if halted, false if a debugger breakpoint was hit
@@ -213,6 +279,11 @@ namespace yarisc::arch
     /**
      * @brief Executes a given number of steps
      *
+     * A breakpoint at the instruction pointer and the instruction that hit a watchpoint are stepped over, so execution
+     * resumes after it has been hit. Once the
+     * machine is caught in an idle loop, like a jump to itself or polling memory that never changes, the remaining
+     * iterations are counted as executed steps without executing them.
+     *
      * @param number of steps to execute
      * @param mode execution mode normal or strict
      * @return a boolean whether the machine was halted and the number of executed steps
@@ -220,14 +291,77 @@ namespace yarisc::arch
     YARISC_ARCH_EXPORT std::pair<bool, std::uint64_t> execute(
       std::uint64_t steps, execution_mode mode = execution_mode::normal);
 
+    /**
+     * @brief Executes a given number of steps as a continuation of the previous call
+     *
+     * Unlike `execute()` a breakpoint at the instruction pointer is not stepped over, so splitting an execution into
+     * several calls stops at the same breakpoints as a single call.
+     *
+     * @param number of steps to execute
+     * @param mode execution mode normal or strict
+     * @return a boolean whether the machine was halted and the number of executed steps
+     */
+    YARISC_ARCH_EXPORT std::pair<bool, std::uint64_t> continue_execution(
+      std::uint64_t steps, execution_mode mode = execution_mode::normal);
+
+    /**
+     * @brief Returns the feature level of the machine
+     */
+    [[nodiscard]] feature_level level() const noexcept
+    {
+      return level_;
+    }
+
+    /**
+     * @brief Returns the engine used for execution
+     */
+    [[nodiscard]] execution_engine engine() const noexcept
+    {
+      return engine_;
+    }
+
+    /**
+     * @brief Sets the engine used for execution
+     *
+     * All engines produce the same results. The interpreter is the reference for the other engines.
+     *
+     * @param engine engine for subsequent calls to `execute()`
+     */
+    void set_engine(execution_engine engine) noexcept
+    {
+      engine_ = engine;
+    }
+
+    /**
+     * @brief Returns the monitor or nullptr
+     */
+    [[nodiscard]] const monitor_ptr& monitor() const noexcept
+    {
+      return monitor_;
+    }
+
+    /**
+     * @brief Sets the monitor, which records what the machine executes
+     *
+     * A machine with a monitor executes with the reference interpreter regardless of the engine, and without
+     * skipping idle loops, so the monitor sees every step.
+     *
+     * @param mon monitor for subsequent calls to `execute()` or nullptr
+     */
+    void set_monitor(monitor_ptr mon) noexcept
+    {
+      monitor_ = std::move(mon);
+    }
+
     /**
      * @brief Resets the machine to initial state
      *
-     * This function keeps the debugger.
+     * This function keeps the debugger and the monitor.
      */
     void reset() noexcept
     {
       data_.reset(debugger_.get());
+      invalidate_code();
     }
 
     /**
@@ -241,14 +375,39 @@ namespace yarisc::arch
 
       swap(data_, that.data_);
       swap(level_, that.level_);
+      swap(engine_, that.engine_);
       swap(debugger_, that.debugger_);
+      swap(monitor_, that.monitor_);
+      swap(cache_, that.cache_);
+      swap(blocks_, that.blocks_);
+      swap(jit_, that.jit_);
     }
 
   private:
     detail::machine_data data_;
     feature_level level_{feature_level_latest};
+    execution_engine engine_{execution_engine::jit};
 
     debugger_ptr debugger_;
+    monitor_ptr monitor_;
+
+    detail::decode_cache cache_;
+    detail::block_cache blocks_;
+    detail::jit_cache jit_;
+
+    void invalidate_code() noexcept
+    {
+      cache_.invalidate();
+      blocks_.invalidate();
+    }
+
+    /**
+     * @brief Executes the instruction on which the previous execution has stopped at a breakpoint or watchpoint
+     *
+     * @param mode execution mode normal or strict
+     * @param watchpoints whether the watchpoints are suspended for the instruction
+     */
+    std::pair<bool, std::uint64_t> step_over(execution_mode mode, bool watchpoints);
   };
 
   /**
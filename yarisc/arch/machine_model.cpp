@@ -13,21 +13,21 @@ namespace yarisc::arch
   namespace
   {
     template <typename T>
-    void format_registers(std::ostream& os, const T& reg, output_format fmt)
+    void format_registers(std::string& str, const T& reg, output_format fmt)
     {
-      detail::format_output(detail::hex_registers, os, fmt, reg);
+      detail::format_output(detail::hex_registers, str, fmt, reg);
     }
 
   } // namespace
 
-  void tag_invoke(output_t, std::ostream& os, const registers_view& reg, output_format fmt)
+  void tag_invoke(output_to_t, std::string& str, const registers_view& reg, output_format fmt)
   {
-    format_registers(os, reg, fmt);
+    format_registers(str, reg, fmt);
   }
 
-  void tag_invoke(output_t, std::ostream& os, const diff<registers_view>& reg, output_format fmt)
+  void tag_invoke(output_to_t, std::string& str, const diff<registers_view>& reg, output_format fmt)
   {
-    format_registers(os, reg, fmt);
+    format_registers(str, reg, fmt);
   }
 
 } // namespace yarisc::arch
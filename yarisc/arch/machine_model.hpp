@@ -12,8 +12,8 @@
 #include <yarisc/arch/registers.hpp>
 
 #include <array>
-#include <iosfwd>
 #include <optional>
+#include <string>
 
 namespace yarisc::arch
 {
@@ -115,8 +115,9 @@ namespace yarisc::arch
     }
   };
 
-  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const registers_view& reg, output_format fmt);
-  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const diff<registers_view>& reg, output_format fmt);
+  YARISC_ARCH_EXPORT void tag_invoke(output_to_t, std::string& str, const registers_view& reg, output_format fmt);
+  YARISC_ARCH_EXPORT void tag_invoke(
+    output_to_t, std::string& str, const diff<registers_view>& reg, output_format fmt);
 
 } // namespace yarisc::arch
 
@@ -12,6 +12,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 namespace yarisc::arch
@@ -111,6 +112,37 @@ namespace yarisc::arch
     static constexpr bool instruction_supported_v =
       (static_cast<feature_level_t>(instruction_level_v<Code>) <= static_cast<feature_level_t>(Level));
 
+    /**
+     * @brief Number of cycles to fetch an additional instruction word, i.e. a long immediate constant
+     */
+    inline constexpr std::uint8_t fetch_cycles = 1;
+
+    /**
+     * @brief Number of cycles of a load from or store to memory, except for instruction fetches
+     */
+    inline constexpr std::uint8_t memory_cycles = 1;
+
+    /**
+     * @brief Returns the number of cycles of each instruction at a feature level
+     *
+     * Every supported instruction takes one cycle to fetch its first word and one cycle to execute. Additional words
+     * and memory accesses are accounted separately. Unsupported instructions take no cycles, they are never retired.
+     */
+    [[nodiscard]] constexpr std::array<std::uint8_t, num_opcodes> make_cycle_table(feature_level level) noexcept
+    {
+      std::array<std::uint8_t, num_opcodes> table{};
+
+      for (std::size_t code = 0; code < num_opcodes; ++code)
+      {
+        const feature_level supported = instruction_table[code].level;
+
+        if ((supported != feature_level::none) && (supported <= level))
+          table[code] = 2;
+      }
+
+      return table;
+    }
+
   } // namespace detail
 
   /**
@@ -144,6 +176,12 @@ namespace yarisc::arch
      */
     template <opcode Code>
     static constexpr bool instruction_supported = detail::instruction_supported_v<Code, Level>;
+
+    /**
+     * @brief Number of cycles of each instruction, excluding additional instruction words and memory accesses
+     */
+    static constexpr std::array<std::uint8_t, detail::num_opcodes> instruction_cycles =
+      detail::make_cycle_table(Level);
   };
 
   /**
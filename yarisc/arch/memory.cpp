@@ -26,21 +26,21 @@ namespace yarisc::arch
     static_assert(detail::is_aligned(max_size));
 
     template <typename T>
-    void format_memory_view(std::ostream& os, const T& mem, output_format fmt)
+    void format_memory_view(std::string& str, const T& mem, output_format fmt)
     {
-      detail::format_output(detail::hex_memory, os, fmt, mem);
+      detail::format_output(detail::hex_memory, str, fmt, mem);
     }
 
   } // namespace
 
-  void tag_invoke(output_t, std::ostream& os, memory_view mem, output_format fmt)
+  void tag_invoke(output_to_t, std::string& str, memory_view mem, output_format fmt)
   {
-    format_memory_view(os, mem, fmt);
+    format_memory_view(str, mem, fmt);
   }
 
-  void tag_invoke(output_t, std::ostream& os, diff<memory_view> mem, output_format fmt)
+  void tag_invoke(output_to_t, std::string& str, diff<memory_view> mem, output_format fmt)
   {
-    format_memory_view(os, mem, fmt);
+    format_memory_view(str, mem, fmt);
   }
 
   memory::memory()
@@ -13,9 +13,9 @@
 
 #include <cassert>
 #include <cstddef>
-#include <iosfwd>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 namespace yarisc::arch
@@ -248,8 +248,8 @@ namespace yarisc::arch
     return view.cend();
   }
 
-  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, memory_view mem, output_format fmt);
-  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, diff<memory_view> mem, output_format fmt);
+  YARISC_ARCH_EXPORT void tag_invoke(output_to_t, std::string& str, memory_view mem, output_format fmt);
+  YARISC_ARCH_EXPORT void tag_invoke(output_to_t, std::string& str, diff<memory_view> mem, output_format fmt);
 
   /**
    * @brief Main memory of the machine
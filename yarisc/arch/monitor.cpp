@@ -0,0 +1,419 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/arch/monitor.hpp>
+
+#include <yarisc/arch/assembly.hpp>
+#include <yarisc/arch/detail/hex_word.hpp>
+#include <yarisc/arch/detail/status_bits.hpp>
+#include <yarisc/utils/ios.hpp>
+#include <yarisc/utils/text_buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yarisc::arch
+{
+  namespace
+  {
+    /**
+     * @brief Instructions in a row that have been retired equally often
+     */
+    struct profile_block final
+    {
+      address_t first;
+      address_t next;
+      std::uint64_t count;
+      std::uint64_t instructions;
+    };
+
+    [[nodiscard]] word_t load_word(const memory& mem, std::size_t address) noexcept
+    {
+      return (address + sizeof(word_t) <= mem.size()) ? mem.load(static_cast<address_t>(address)) : word_t{0};
+    }
+
+    [[nodiscard]] bool is_jump(word_t instr) noexcept
+    {
+      switch (static_cast<opcode>(instr & opcode_mask))
+      {
+      case opcode::jump:
+      case opcode::relative_jump:
+      case opcode::cond_jump:
+      case opcode::relative_cond_jump:
+      case opcode::halt:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    /**
+     * @brief Returns the number of words of the instruction at the address
+     */
+    [[nodiscard]] std::size_t instruction_size(const memory& mem, std::size_t address, feature_level level)
+    {
+      return static_cast<std::size_t>(
+        std::max(disassemble(load_word(mem, address), load_word(mem, address + sizeof(word_t)), level).words, 1));
+    }
+
+    [[nodiscard]] std::vector<profile_block> find_blocks(
+      const execution_profile& profile, const memory& mem, feature_level level)
+    {
+      std::vector<profile_block> blocks;
+      bool open = false;
+
+      for (std::size_t address = 0; address < execution_profile::address_space; address += sizeof(word_t))
+      {
+        const std::uint64_t count = profile.instructions(static_cast<address_t>(address));
+
+        if (count == 0)
+        {
+          open = false;
+          continue;
+        }
+
+        if (!open || (blocks.back().next != address) || (blocks.back().count != count))
+          blocks.push_back({static_cast<address_t>(address), static_cast<address_t>(address), count, 0});
+
+        profile_block& b = blocks.back();
+
+        b.next = static_cast<address_t>(address + instruction_size(mem, address, level) * sizeof(word_t));
+        ++b.instructions;
+
+        open = !is_jump(load_word(mem, address));
+      }
+
+      return blocks;
+    }
+
+    std::ostream& output_percent(std::ostream& os, std::uint64_t count, std::uint64_t total)
+    {
+      const double percent = (total > 0) ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0;
+
+      return os << std::fixed << std::setprecision(1) << std::setw(5) << std::setfill(' ') << percent << '%';
+    }
+
+  } // namespace
+
+  trace_ring::trace_ring(std::size_t capacity)
+    : entries_{std::make_unique<trace_entry[]>(std::bit_ceil(std::max<std::size_t>(capacity, 1)))}
+    , mask_{std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1}
+  {
+  }
+
+  std::vector<trace_entry> trace_ring::entries() const
+  {
+    std::vector<trace_entry> result;
+    result.reserve(size());
+
+    for (std::uint64_t i = count_ - size(); i < count_; ++i)
+      result.push_back(entries_[static_cast<std::size_t>(i) & mask_]);
+
+    return result;
+  }
+
+  execution_profile::execution_profile()
+    : instructions_{std::make_unique<std::uint64_t[]>(num_words)}
+    , taken_{std::make_unique<std::uint64_t[]>(num_words)}
+  {
+  }
+
+  void execution_profile::clear() noexcept
+  {
+    std::fill_n(instructions_.get(), num_words, 0);
+    std::fill_n(taken_.get(), num_words, 0);
+    loads_.fill(0);
+    stores_.fill(0);
+    total_ = 0;
+  }
+
+  void tag_invoke(output_t, std::ostream& os, const profile_view& view, output_format)
+  {
+    using namespace std::string_view_literals;
+
+    constexpr std::size_t text_width = 24;
+
+    const utils::ostream_guard guard{os};
+    const execution_profile& profile = *view.profile;
+    const memory& mem = *view.mem;
+
+    os << "Retired instructions: "sv << std::dec << profile.total() << "\n\nHot blocks:\n"sv;
+
+    std::vector<profile_block> blocks = find_blocks(profile, mem, view.level);
+
+    std::sort(blocks.begin(), blocks.end(), [](const profile_block& lhs, const profile_block& rhs) {
+      return lhs.count * lhs.instructions > rhs.count * rhs.instructions;
+    });
+
+    blocks.resize(std::min(blocks.size(), view.limit));
+
+    for (const profile_block& b : blocks)
+    {
+      detail::output_hex(os << "\n  "sv, b.first) << '-';
+      detail::output_hex(os, static_cast<address_t>(b.next - sizeof(word_t)));
+      os << std::dec << "  "sv << b.count << " x "sv << b.instructions << "  "sv;
+      output_percent(os, b.count * b.instructions, profile.total()) << '\n';
+
+      for (std::size_t address = b.first; address != b.next;)
+      {
+        const word_t instr = load_word(mem, address);
+        const disassembly dis = disassemble(instr, load_word(mem, address + sizeof(word_t)), view.level);
+
+        std::string text = dis.text;
+        text.resize(std::max(text.size(), text_width), ' ');
+
+        detail::output_hex(os << "    "sv, static_cast<address_t>(address)) << "  "sv << text;
+
+        const auto op = static_cast<opcode>(instr & opcode_mask);
+
+        if ((op == opcode::cond_jump) || (op == opcode::relative_cond_jump))
+        {
+          const std::uint64_t taken = profile.taken(static_cast<address_t>(address));
+
+          os << std::dec << "  taken "sv << taken << ", not taken "sv << (b.count - taken);
+        }
+
+        os << '\n';
+
+        address = static_cast<address_t>(address + std::max(dis.words, 1) * sizeof(word_t));
+      }
+    }
+
+    std::vector<std::size_t> pages;
+
+    for (std::size_t page = 0; page < execution_profile::num_pages; ++page)
+    {
+      const auto address = static_cast<address_t>(page * execution_profile::page_size);
+
+      if ((profile.loads(address) > 0) || (profile.stores(address) > 0))
+        pages.push_back(page);
+    }
+
+    const auto accesses = [&profile](std::size_t page) {
+      const auto address = static_cast<address_t>(page * execution_profile::page_size);
+
+      return profile.loads(address) + profile.stores(address);
+    };
+
+    std::stable_sort(
+      pages.begin(), pages.end(), [&](std::size_t lhs, std::size_t rhs) { return accesses(lhs) > accesses(rhs); });
+
+    pages.resize(std::min(pages.size(), view.limit));
+
+    os << "\nData accesses per page:\n"sv;
+
+    for (const std::size_t page : pages)
+    {
+      const auto address = static_cast<address_t>(page * execution_profile::page_size);
+
+      detail::output_hex(os << "  "sv, address) << std::dec << "  loads "sv << profile.loads(address)
+                                                << ", stores "sv << profile.stores(address) << '\n';
+    }
+  }
+
+  std::uint64_t execution_statistics::retired(operand_form form) const noexcept
+  {
+    std::uint64_t sum = 0;
+
+    for (const auto& forms : retired_)
+      sum += forms[static_cast<std::size_t>(form)];
+
+    return sum;
+  }
+
+  void tag_invoke(output_t, std::ostream& os, const execution_statistics& stats, output_format)
+  {
+    using namespace std::string_view_literals;
+
+    const utils::ostream_guard guard{os};
+
+    const auto column = [&os](std::uint64_t value) -> std::ostream& {
+      return os << std::dec << std::setw(12) << std::setfill(' ') << value;
+    };
+
+    os << "Retired instructions: "sv << std::dec << stats.total() << "\n\n"sv;
+    os << "Opcode       retired  percent    register   short imm    long imm\n"sv;
+
+    for (std::size_t code = 0; code < detail::num_opcodes; ++code)
+    {
+      const auto op = static_cast<opcode>(code);
+      const std::uint64_t retired = stats.retired(op);
+
+      if (retired == 0)
+        continue;
+
+      // Only valid instructions are retired, so each one has a mnemonic
+      const detail::instruction_descriptor& desc = detail::instruction_table[code];
+      std::string name{(desc.type == optype::cond_jump) ? "Jcc"sv : desc.mnemonic};
+
+      name.resize(std::max<std::size_t>(name.size(), 8), ' ');
+
+      os << name;
+      column(retired) << "   "sv;
+      output_percent(os, retired, stats.total());
+      column(stats.retired(op, operand_form::register_operand));
+      column(stats.retired(op, operand_form::short_immediate));
+      column(stats.retired(op, operand_form::long_immediate)) << '\n';
+    }
+
+    os << "\nOperand forms: register "sv << std::dec << stats.retired(operand_form::register_operand)
+       << ", short immediate "sv << stats.retired(operand_form::short_immediate) << ", long immediate "sv
+       << stats.retired(operand_form::long_immediate) << '\n';
+
+    os << "Conditional jumps: "sv << stats.branches() << ", taken "sv << stats.taken() << " ("sv << std::fixed
+       << std::setprecision(1) << 100.0 * stats.taken_ratio() << "%)\n"sv;
+  }
+
+  std::size_t execution_coverage::count() const noexcept
+  {
+    std::size_t sum = 0;
+
+    for (const std::uint64_t bits : covered_)
+      sum += static_cast<std::size_t>(std::popcount(bits));
+
+    return sum;
+  }
+
+  void tag_invoke(output_t, std::ostream& os, const coverage_view& view, output_format)
+  {
+    using namespace std::string_view_literals;
+
+    const execution_coverage& coverage = *view.coverage;
+    const memory& mem = *view.mem;
+    const std::size_t end = std::min(view.size, execution_profile::address_space);
+
+    const utils::ostream_guard guard{os};
+
+    std::size_t lines = 0;
+    std::size_t lines_hit = 0;
+    std::size_t branches = 0;
+    std::size_t branches_hit = 0;
+
+    if (view.format == coverage_format::lcov)
+      os << "TN:\nSF:"sv << view.source << '\n';
+    else
+      os << "address,covered,taken,not_taken,instruction\n"sv;
+
+    for (std::size_t address = 0; address < end;)
+    {
+      const auto addr = static_cast<address_t>(address);
+      const word_t instr = load_word(mem, address);
+      const disassembly dis = disassemble(instr, load_word(mem, address + sizeof(word_t)), view.level);
+      const bool covered = coverage.covered(addr);
+
+      address += sizeof(word_t);
+
+      if ((dis.words == 0) && !covered)
+        continue;
+
+      // Skips the immediate constant unless an instruction starting there has been retired
+      if ((dis.words > 1) && !coverage.covered(static_cast<address_t>(address)))
+        address += sizeof(word_t);
+
+      const bool branch = detail::instruction_table[instr & opcode_mask].type == optype::cond_jump;
+
+      if (view.format == coverage_format::lcov)
+      {
+        const std::size_t line = addr / sizeof(word_t) + 1;
+
+        os << std::dec << "DA:"sv << line << ',' << (covered ? 1 : 0) << '\n';
+
+        if (branch)
+        {
+          const std::array<bool, 2> taken{{coverage.taken(addr), coverage.not_taken(addr)}};
+
+          for (std::size_t i = 0; i < taken.size(); ++i)
+          {
+            // A branch that has never been evaluated has no count
+            os << "BRDA:"sv << line << ",0,"sv << i << ',';
+
+            if (covered)
+              os << (taken[i] ? 1 : 0) << '\n';
+            else
+              os << "-\n"sv;
+
+            ++branches;
+            branches_hit += taken[i] ? 1 : 0;
+          }
+        }
+      }
+      else
+      {
+        detail::output_hex(os, addr) << ',' << (covered ? 1 : 0) << ',';
+
+        if (branch)
+          os << (coverage.taken(addr) ? 1 : 0) << ',' << (coverage.not_taken(addr) ? 1 : 0);
+        else
+          os << ',';
+
+        os << ",\""sv << dis.text << "\"\n"sv;
+      }
+
+      ++lines;
+      lines_hit += covered ? 1 : 0;
+    }
+
+    if (view.format == coverage_format::lcov)
+    {
+      os << std::dec << "BRF:"sv << branches << "\nBRH:"sv << branches_hit << "\nLF:"sv << lines << "\nLH:"sv
+         << lines_hit << "\nend_of_record\n"sv;
+    }
+  }
+
+  void tag_invoke(output_t, std::ostream& os, const cycle_counter& counter, output_format)
+  {
+    using namespace std::string_view_literals;
+
+    const utils::ostream_guard guard{os};
+
+    os << "Steps: "sv << std::dec << counter.steps() << ", cycles: "sv << counter.cycles()
+       << ", cycles per instruction: "sv << std::fixed << std::setprecision(2) << counter.cpi() << '\n';
+  }
+
+  void tag_invoke(output_to_t, std::string& str, const trace_ring& trace, output_format)
+  {
+    using namespace std::string_view_literals;
+
+    constexpr std::size_t text_width = 24;
+    constexpr std::array<std::string_view, 8> names{{"r0", "r1", "r2", "r3", "r4", "r5", "sp", "ip"}};
+
+    utils::text_buffer buf{str};
+
+    for (const trace_entry& entry : trace.entries())
+    {
+      detail::output_hex(buf, entry.ip) << ": "sv;
+      detail::output_hex(buf, entry.words[0]) << ' ';
+
+      if (entry.size > 1)
+        detail::output_hex(buf, entry.words[1]);
+      else
+        buf << "    "sv;
+
+      const std::string text = disassemble(entry.words[0], entry.words[1]).text;
+
+      buf << "  "sv << text;
+
+      if (text.size() < text_width)
+        buf.append(text_width - text.size(), ' ');
+
+      buf << ' ' << detail::zero_bit(entry.status) << detail::carry_bit(entry.status);
+
+      if (entry.reg != trace_entry::no_register)
+        detail::output_hex(buf << "  "sv << names[entry.reg] << " = "sv, entry.value);
+
+      if (entry.store)
+        detail::output_hex(detail::output_hex(buf << "  ["sv, entry.address) << "] = "sv, entry.data);
+
+      buf << '\n';
+    }
+  }
+
+} // namespace yarisc::arch
@@ -0,0 +1,842 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_ARCH_MONITOR_HPP
+#define YARISC_ARCH_MONITOR_HPP
+
+#include <yarisc/arch/export.h>
+#include <yarisc/arch/feature_level.hpp>
+#include <yarisc/arch/instructions.hpp>
+#include <yarisc/arch/machine.hpp>
+#include <yarisc/arch/machine_profile.hpp>
+#include <yarisc/arch/machine_model.hpp>
+#include <yarisc/arch/memory.hpp>
+#include <yarisc/arch/output.hpp>
+#include <yarisc/arch/types.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yarisc::arch
+{
+  /**
+   * @brief Retired instruction recorded by the execution trace
+   */
+  struct trace_entry final
+  {
+    static constexpr std::uint8_t no_register = 0xff;
+
+    /**
+     * @brief Byte address of the instruction
+     */
+    address_t ip{0};
+
+    /**
+     * @brief Number of instruction words, which is two for long immediate constants
+     */
+    std::uint8_t size{0};
+
+    /**
+     * @brief Index of the register written by the instruction or `no_register`
+     *
+     * Jumps are not recorded as writing the instruction pointer, the next entry starts at the target.
+     */
+    std::uint8_t reg{no_register};
+
+    /**
+     * @brief Whether the instruction has loaded a word from memory
+     */
+    bool load{false};
+
+    /**
+     * @brief Whether the instruction has stored a word to memory
+     */
+    bool store{false};
+
+    std::array<word_t, 2> words{};
+
+    /**
+     * @brief New value of the written register
+     */
+    word_t value{0};
+
+    /**
+     * @brief Byte address and value of the load or store
+     */
+    address_t address{0};
+    word_t data{0};
+
+    /**
+     * @brief Status register after the instruction
+     */
+    word_t status{0};
+
+    /**
+     * @brief Returns the byte address of the instruction that follows, unless the instruction jumps
+     */
+    [[nodiscard]] word_t next() const noexcept
+    {
+      return static_cast<word_t>(ip + size * sizeof(word_t));
+    }
+  };
+
+  /**
+   * @brief Ring of the last retired instructions
+   *
+   * The entries are allocated once, recording an instruction only copies it into the next slot and overwrites the
+   * oldest entry once the ring is full.
+   */
+  class trace_ring final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param capacity minimum number of entries, which is rounded up to a power of two
+     */
+    YARISC_ARCH_EXPORT explicit trace_ring(std::size_t capacity);
+
+    void push(const trace_entry& entry) noexcept
+    {
+      entries_[static_cast<std::size_t>(count_) & mask_] = entry;
+      ++count_;
+    }
+
+    /**
+     * @brief Returns the maximum number of entries
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+      return mask_ + 1;
+    }
+
+    /**
+     * @brief Returns the number of entries, which is less than the capacity until the ring has filled up
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return (count_ < capacity()) ? static_cast<std::size_t>(count_) : capacity();
+    }
+
+    /**
+     * @brief Returns the number of instructions recorded since the last clear, including overwritten ones
+     */
+    [[nodiscard]] std::uint64_t count() const noexcept
+    {
+      return count_;
+    }
+
+    /**
+     * @brief Returns a copy of the entries from the oldest to the latest
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT std::vector<trace_entry> entries() const;
+
+    /**
+     * @brief Removes all entries
+     */
+    void clear() noexcept
+    {
+      count_ = 0;
+    }
+
+  private:
+    std::unique_ptr<trace_entry[]> entries_;
+    std::size_t mask_;
+    std::uint64_t count_{0};
+  };
+
+  YARISC_ARCH_EXPORT void tag_invoke(output_to_t, std::string& str, const trace_ring& trace, output_format fmt);
+
+  /**
+   * @brief Execution counts per instruction address and data accesses per page of memory
+   */
+  class execution_profile final
+  {
+  public:
+    static constexpr std::size_t page_size = 0x100;
+    static constexpr std::size_t address_space = std::size_t{std::numeric_limits<address_t>::max()} + 1;
+    static constexpr std::size_t num_words = address_space / sizeof(word_t);
+    static constexpr std::size_t num_pages = address_space / page_size;
+
+    /**
+     * @brief Constructor
+     */
+    YARISC_ARCH_EXPORT execution_profile();
+
+    /**
+     * @brief Counts a retired instruction
+     *
+     * @param entry fetched words and data access of the instruction
+     * @param ip instruction pointer after the instruction
+     */
+    void retire(const trace_entry& entry, word_t ip) noexcept
+    {
+      const std::size_t word = entry.ip / sizeof(word_t);
+
+      ++instructions_[word];
+      ++total_;
+
+      const auto op = static_cast<opcode>(entry.words[0] & opcode_mask);
+
+      if (((op == opcode::cond_jump) || (op == opcode::relative_cond_jump)) && (ip != entry.next()))
+        ++taken_[word];
+
+      if (entry.load)
+        ++loads_[entry.address / page_size];
+
+      if (entry.store)
+        ++stores_[entry.address / page_size];
+    }
+
+    /**
+     * @brief Returns the number of retired instructions
+     */
+    [[nodiscard]] std::uint64_t total() const noexcept
+    {
+      return total_;
+    }
+
+    /**
+     * @brief Returns how often the instruction in the word at the byte address has been retired
+     */
+    [[nodiscard]] std::uint64_t instructions(address_t address) const noexcept
+    {
+      return instructions_[address / sizeof(word_t)];
+    }
+
+    /**
+     * @brief Returns how often the conditional jump in the word at the byte address has jumped
+     *
+     * The jump has not been taken the remaining times it has been retired.
+     */
+    [[nodiscard]] std::uint64_t taken(address_t address) const noexcept
+    {
+      return taken_[address / sizeof(word_t)];
+    }
+
+    /**
+     * @brief Returns the number of loads from the page containing the byte address
+     */
+    [[nodiscard]] std::uint64_t loads(address_t address) const noexcept
+    {
+      return loads_[address / page_size];
+    }
+
+    /**
+     * @brief Returns the number of stores to the page containing the byte address
+     */
+    [[nodiscard]] std::uint64_t stores(address_t address) const noexcept
+    {
+      return stores_[address / page_size];
+    }
+
+    /**
+     * @brief Resets all counts to zero
+     */
+    YARISC_ARCH_EXPORT void clear() noexcept;
+
+  private:
+    std::unique_ptr<std::uint64_t[]> instructions_;
+    std::unique_ptr<std::uint64_t[]> taken_;
+    std::array<std::uint64_t, num_pages> loads_{};
+    std::array<std::uint64_t, num_pages> stores_{};
+    std::uint64_t total_{0};
+  };
+
+  /**
+   * @brief Report of a profile, which disassembles the instructions from memory
+   *
+   * Instructions in a row, which have been retired equally often and of which only the last one may jump, form a block.
+   * The report lists the blocks that have retired the most instructions, followed by the data accesses per page.
+   */
+  struct profile_view final
+  {
+    const execution_profile* profile{nullptr};
+    const memory* mem{nullptr};
+
+    /**
+     * @brief Maximum number of blocks and pages listed
+     */
+    std::size_t limit{10};
+
+    feature_level level{feature_level_latest};
+  };
+
+  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const profile_view& view, output_format fmt);
+
+  /**
+   * @brief Encoding of the operand that is either a register or an immediate constant
+   */
+  enum class operand_form : std::uint8_t
+  {
+    /**
+     * @brief The instruction has no such operand
+     */
+    none,
+
+    /**
+     * @brief Register, the `sel` flag is not set
+     */
+    register_operand,
+
+    /**
+     * @brief Immediate constant in the instruction word, or a short jump address
+     */
+    short_immediate,
+
+    /**
+     * @brief Immediate constant in the next word, the `sel` and `loc` flags are set, or a long jump address
+     */
+    long_immediate,
+  };
+
+  /**
+   * @brief Dynamic instruction statistics, which are the retired instructions per opcode and operand form
+   */
+  class execution_statistics final
+  {
+  public:
+    static constexpr std::size_t num_forms = 4;
+
+    /**
+     * @brief Returns the operand form of an instruction
+     *
+     * @param instr instruction word
+     * @param size number of instruction words
+     */
+    [[nodiscard]] static operand_form form(word_t instr, std::size_t size) noexcept
+    {
+      switch (detail::instruction_table[instr & opcode_mask].type)
+      {
+      case optype::op0_op1:
+      case optype::op0_op1_op2:
+        if ((instr & operand_sel_mask) == 0)
+          return operand_form::register_operand;
+
+        return ((instr & operand_loc_mask) == 0) ? operand_form::short_immediate : operand_form::long_immediate;
+      case optype::jump:
+      case optype::cond_jump:
+        return (size > 1) ? operand_form::long_immediate : operand_form::short_immediate;
+      default:
+        return operand_form::none;
+      }
+    }
+
+    /**
+     * @brief Counts a retired instruction
+     *
+     * @param entry fetched words of the instruction
+     * @param ip instruction pointer after the instruction
+     */
+    void retire(const trace_entry& entry, word_t ip) noexcept
+    {
+      const word_t instr = entry.words[0];
+      const std::size_t code = instr & opcode_mask;
+
+      ++retired_[code][static_cast<std::size_t>(form(instr, entry.size))];
+      ++total_;
+
+      if (detail::instruction_table[code].type == optype::cond_jump)
+      {
+        ++branches_;
+
+        if (ip != entry.next())
+          ++taken_;
+      }
+    }
+
+    /**
+     * @brief Returns the number of retired instructions
+     */
+    [[nodiscard]] std::uint64_t total() const noexcept
+    {
+      return total_;
+    }
+
+    /**
+     * @brief Returns the number of retired instructions with the opcode
+     */
+    [[nodiscard]] std::uint64_t retired(opcode code) const noexcept
+    {
+      const auto& forms = retired_[static_cast<std::size_t>(code) & opcode_mask];
+
+      return forms[0] + forms[1] + forms[2] + forms[3];
+    }
+
+    /**
+     * @brief Returns the number of retired instructions with the opcode and operand form
+     */
+    [[nodiscard]] std::uint64_t retired(opcode code, operand_form form) const noexcept
+    {
+      return retired_[static_cast<std::size_t>(code) & opcode_mask][static_cast<std::size_t>(form)];
+    }
+
+    /**
+     * @brief Returns the number of retired instructions with the operand form
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT std::uint64_t retired(operand_form form) const noexcept;
+
+    /**
+     * @brief Returns the number of retired conditional jumps
+     */
+    [[nodiscard]] std::uint64_t branches() const noexcept
+    {
+      return branches_;
+    }
+
+    /**
+     * @brief Returns the number of retired conditional jumps that have jumped
+     */
+    [[nodiscard]] std::uint64_t taken() const noexcept
+    {
+      return taken_;
+    }
+
+    /**
+     * @brief Returns the ratio of the conditional jumps that have jumped, or zero if there has been none
+     */
+    [[nodiscard]] double taken_ratio() const noexcept
+    {
+      return (branches_ > 0) ? static_cast<double>(taken_) / static_cast<double>(branches_) : 0.0;
+    }
+
+    /**
+     * @brief Resets all counts to zero
+     */
+    void clear() noexcept
+    {
+      *this = {};
+    }
+
+  private:
+    std::array<std::array<std::uint64_t, num_forms>, detail::num_opcodes> retired_{};
+    std::uint64_t total_{0};
+    std::uint64_t branches_{0};
+    std::uint64_t taken_{0};
+  };
+
+  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const execution_statistics& stats, output_format fmt);
+
+  /**
+   * @brief Code coverage, which are the addresses of retired instructions and the directions of conditional jumps
+   *
+   * Each word of the address space has one bit, which is set if an instruction starting at the word has been retired,
+   * and two bits, which are set if a conditional jump at the word has jumped or has gone on with the next instruction.
+   */
+  class execution_coverage final
+  {
+  public:
+    static constexpr std::size_t num_words = execution_profile::num_words;
+
+    /**
+     * @brief Records a retired instruction
+     *
+     * @param entry fetched words of the instruction
+     * @param ip instruction pointer after the instruction
+     */
+    void retire(const trace_entry& entry, word_t ip) noexcept
+    {
+      const std::size_t word = entry.ip / sizeof(word_t);
+
+      covered_[word / 64] |= std::uint64_t{1} << (word % 64);
+
+      if (detail::instruction_table[entry.words[0] & opcode_mask].type == optype::cond_jump)
+        edges_[word / 32] |= ((ip != entry.next()) ? taken_bit : not_taken_bit) << (word % 32 * 2);
+    }
+
+    /**
+     * @brief Returns whether an instruction starting in the word at the byte address has been retired
+     */
+    [[nodiscard]] bool covered(address_t address) const noexcept
+    {
+      const std::size_t word = address / sizeof(word_t);
+
+      return ((covered_[word / 64] >> (word % 64)) & 1) != 0;
+    }
+
+    /**
+     * @brief Returns whether the conditional jump in the word at the byte address has jumped
+     */
+    [[nodiscard]] bool taken(address_t address) const noexcept
+    {
+      return (edges(address) & taken_bit) != 0;
+    }
+
+    /**
+     * @brief Returns whether the conditional jump in the word at the byte address has gone on with the next instruction
+     */
+    [[nodiscard]] bool not_taken(address_t address) const noexcept
+    {
+      return (edges(address) & not_taken_bit) != 0;
+    }
+
+    /**
+     * @brief Returns the number of words at which instructions have been retired
+     */
+    [[nodiscard]] YARISC_ARCH_EXPORT std::size_t count() const noexcept;
+
+    /**
+     * @brief Resets the coverage
+     */
+    void clear() noexcept
+    {
+      *this = {};
+    }
+
+  private:
+    static constexpr std::uint64_t taken_bit = 0x1;
+    static constexpr std::uint64_t not_taken_bit = 0x2;
+
+    std::array<std::uint64_t, num_words / 64> covered_{};
+    std::array<std::uint64_t, num_words / 32> edges_{};
+
+    [[nodiscard]] std::uint64_t edges(address_t address) const noexcept
+    {
+      const std::size_t word = address / sizeof(word_t);
+
+      return (edges_[word / 32] >> (word % 32 * 2)) & (taken_bit | not_taken_bit);
+    }
+  };
+
+  /**
+   * @brief File format of exported code coverage
+   */
+  enum class coverage_format : std::uint8_t
+  {
+    /**
+     * @brief Tracefile of lcov, whose line numbers are the byte addresses divided by two plus one
+     */
+    lcov,
+
+    /**
+     * @brief Comma separated values with a header and one row per instruction
+     */
+    csv,
+  };
+
+  /**
+   * @brief Export of code coverage, which disassembles the instructions of an image in memory
+   *
+   * The image is scanned from address zero. Invalid instructions are considered data and skipped unless they have been
+   * retired, and so are immediate constants. Words that have been retired start an instruction in any case.
+   */
+  struct coverage_view final
+  {
+    const execution_coverage* coverage{nullptr};
+    const memory* mem{nullptr};
+
+    /**
+     * @brief Number of bytes of the image
+     */
+    std::size_t size{0};
+
+    coverage_format format{coverage_format::csv};
+
+    /**
+     * @brief Name of the image, which is the source file of the lcov record
+     */
+    std::string_view source{};
+
+    feature_level level{feature_level_latest};
+  };
+
+  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const coverage_view& view, output_format fmt);
+
+  /**
+   * @brief Estimated number of cycles the hardware spends on the retired instructions
+   *
+   * The cost of an instruction is given by the cycle table of the feature level, plus the cycles to fetch additional
+   * instruction words and to access memory.
+   */
+  class cycle_counter final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param level feature level of the machine, whose cycle table is used
+     */
+    explicit cycle_counter(feature_level level) noexcept
+      : table_{detail::make_cycle_table(level)}
+    {
+    }
+
+    /**
+     * @brief Counts a retired instruction
+     *
+     * @param entry fetched words and data access of the instruction
+     */
+    void retire(const trace_entry& entry) noexcept
+    {
+      cycles_ += table_[entry.words[0] & opcode_mask];
+      cycles_ += std::uint64_t{detail::fetch_cycles} * (entry.size - 1u);
+
+      if (entry.load)
+        cycles_ += detail::memory_cycles;
+
+      if (entry.store)
+        cycles_ += detail::memory_cycles;
+
+      ++steps_;
+    }
+
+    /**
+     * @brief Returns the number of retired instructions
+     */
+    [[nodiscard]] std::uint64_t steps() const noexcept
+    {
+      return steps_;
+    }
+
+    /**
+     * @brief Returns the number of cycles of the retired instructions
+     */
+    [[nodiscard]] std::uint64_t cycles() const noexcept
+    {
+      return cycles_;
+    }
+
+    /**
+     * @brief Returns the average number of cycles per instruction, or zero if none has been retired
+     */
+    [[nodiscard]] double cpi() const noexcept
+    {
+      return (steps_ > 0) ? static_cast<double>(cycles_) / static_cast<double>(steps_) : 0.0;
+    }
+
+    /**
+     * @brief Returns the estimated runtime in seconds
+     *
+     * @param frequency clock frequency of the hardware in Hertz
+     */
+    [[nodiscard]] double runtime(double frequency) const noexcept
+    {
+      return static_cast<double>(cycles_) / frequency;
+    }
+
+    /**
+     * @brief Resets the counts to zero
+     */
+    void clear() noexcept
+    {
+      cycles_ = 0;
+      steps_ = 0;
+    }
+
+  private:
+    std::array<std::uint8_t, detail::num_opcodes> table_;
+    std::uint64_t cycles_{0};
+    std::uint64_t steps_{0};
+  };
+
+  YARISC_ARCH_EXPORT void tag_invoke(output_t, std::ostream& os, const cycle_counter& counter, output_format fmt);
+
+  /**
+   * @brief Records what the machine executes
+   *
+   * A machine with a monitor executes with the reference interpreter, which calls the hooks of the monitor. The
+   * execution of machines without a monitor is not affected at all.
+   */
+  class execution_monitor final
+  {
+  public:
+    /**
+     * @brief Constructor
+     */
+    execution_monitor() = default;
+
+    execution_monitor(const execution_monitor& that) = delete;
+    execution_monitor(execution_monitor&& that) = delete;
+
+    /**
+     * @brief Destructor
+     */
+    ~execution_monitor() = default;
+
+    execution_monitor& operator=(const execution_monitor& that) = delete;
+    execution_monitor& operator=(execution_monitor&& that) = delete;
+
+    /**
+     * @brief Records the last retired instructions from now on
+     *
+     * @param capacity minimum number of instructions kept
+     */
+    void enable_trace(std::size_t capacity)
+    {
+      trace_.emplace(capacity);
+    }
+
+    /**
+     * @brief Returns the execution trace or nullptr if it is not enabled
+     */
+    [[nodiscard]] const trace_ring* trace() const noexcept
+    {
+      return trace_ ? &*trace_ : nullptr;
+    }
+
+    /**
+     * @brief Counts the retired instructions and data accesses from now on
+     */
+    void enable_profile()
+    {
+      profile_.emplace();
+    }
+
+    /**
+     * @brief Returns the profile or nullptr if it is not enabled
+     */
+    [[nodiscard]] const execution_profile* profile() const noexcept
+    {
+      return profile_ ? &*profile_ : nullptr;
+    }
+
+    /**
+     * @brief Counts the retired instructions per opcode and operand form from now on
+     */
+    void enable_statistics()
+    {
+      statistics_.emplace();
+    }
+
+    /**
+     * @brief Returns the statistics or nullptr if they are not enabled
+     */
+    [[nodiscard]] const execution_statistics* statistics() const noexcept
+    {
+      return statistics_ ? &*statistics_ : nullptr;
+    }
+
+    /**
+     * @brief Records the code coverage from now on
+     */
+    void enable_coverage()
+    {
+      coverage_.emplace();
+    }
+
+    /**
+     * @brief Returns the code coverage or nullptr if it is not enabled
+     */
+    [[nodiscard]] const execution_coverage* coverage() const noexcept
+    {
+      return coverage_ ? &*coverage_ : nullptr;
+    }
+
+    /**
+     * @brief Counts the cycles of the retired instructions from now on
+     *
+     * @param level feature level of the machine
+     */
+    void enable_cycles(feature_level level)
+    {
+      cycles_.emplace(level);
+    }
+
+    /**
+     * @brief Returns the cycle counter or nullptr if it is not enabled
+     */
+    [[nodiscard]] const cycle_counter* cycles() const noexcept
+    {
+      return cycles_ ? &*cycles_ : nullptr;
+    }
+
+    /**
+     * @brief Called for each instruction word the interpreter fetches
+     */
+    void fetch(address_t address, word_t word) noexcept
+    {
+      if (current_.size == 0)
+        current_.ip = address;
+
+      if (current_.size < current_.words.size())
+        current_.words[current_.size++] = word;
+    }
+
+    /**
+     * @brief Called for each load from memory, except for instruction fetches
+     */
+    void load(address_t address, word_t value) noexcept
+    {
+      current_.load = true;
+      current_.address = address;
+      current_.data = value;
+    }
+
+    /**
+     * @brief Called for each store to memory
+     */
+    void store(address_t address, word_t value) noexcept
+    {
+      current_.store = true;
+      current_.address = address;
+      current_.data = value;
+    }
+
+    /**
+     * @brief Called after each instruction, which is only retired if execution goes on
+     *
+     * @param reg registers of the machine after the instruction
+     * @param retired whether the instruction has been executed as a step
+     */
+    void retire(const machine_registers& reg, bool retired) noexcept
+    {
+      if (retired && profile_)
+        profile_->retire(current_, reg.named.ip());
+
+      if (retired && statistics_)
+        statistics_->retire(current_, reg.named.ip());
+
+      if (retired && coverage_)
+        coverage_->retire(current_, reg.named.ip());
+
+      if (retired && cycles_)
+        cycles_->retire(current_);
+
+      if (retired && trace_)
+      {
+        switch (static_cast<opcode>(current_.words[0] & opcode_mask))
+        {
+        case opcode::move:
+        case opcode::load:
+        case opcode::add:
+        case opcode::add_with_carry:
+          current_.reg = static_cast<std::uint8_t>((current_.words[0] & operand_op0_mask) >> operand_op0_offset);
+          current_.value = reg.named.r[current_.reg];
+          break;
+        default:
+          break;
+        }
+
+        current_.status = reg.status.s;
+        trace_->push(current_);
+      }
+
+      current_ = {};
+    }
+
+  private:
+    std::optional<trace_ring> trace_;
+    std::optional<execution_profile> profile_;
+    std::optional<execution_statistics> statistics_;
+    std::optional<execution_coverage> coverage_;
+    std::optional<cycle_counter> cycles_;
+
+    /**
+     * @brief Instruction being executed
+     */
+    trace_entry current_{};
+  };
+
+} // namespace yarisc::arch
+
+#endif
@@ -8,7 +8,10 @@
 
 #include <yarisc/arch/detail/functional.hpp>
 
-#include <iosfwd>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace yarisc::arch
@@ -34,8 +37,98 @@ namespace yarisc::arch
     colored,
   };
 
+  namespace detail::_output_to
+  {
+    namespace cpo
+    {
+      struct fn
+      {
+        explicit fn() = default;
+
+        template <typename T>
+          requires custom::tag_invocable<fn, std::string&, const T&, output_format>
+        std::string& operator()(std::string& str, const T& obj, output_format fmt = output_format::console) const
+        {
+          custom::tag_invoke(*this, str, obj, fmt);
+
+          return str;
+        }
+      };
+
+    } // namespace cpo
+
+  } // namespace detail::_output_to
+
+  /**
+   * @brief Type of the customization point object for appending text to a string
+   */
+  using output_to_t = detail::_output_to::cpo::fn;
+
+  /**
+   * @brief Customization point object for appending text to a string
+   *
+   * This is the backend of the output customization point for types that customize it. Reusing the string avoids
+   * allocations for repeated output, e.g. of a debugger view.
+   *
+   * @code
+   * void foo(std::string& str)
+   * {
+   *   registers reg;
+   *
+   *   str.clear();
+   *   output_to(str, reg, output_format::colored);
+   * }
+   * @endcode
+   */
+  inline constexpr output_to_t output_to{};
+
   namespace detail::_output
   {
+    /**
+     * @brief Returns the string of this thread to which the output is formatted before it is written to the stream
+     */
+    [[nodiscard]] inline std::string& scratch() noexcept
+    {
+      thread_local std::string str;
+
+      return str;
+    }
+
+    /**
+     * @brief Removes the text that has been appended to a string since construction
+     *
+     * Nested output appends to the same string after the text of the enclosing output.
+     */
+    class scratch_guard final
+    {
+    public:
+      explicit scratch_guard(std::string& str) noexcept
+        : str_{str}
+        , size_{str.size()}
+      {
+      }
+
+      scratch_guard(const scratch_guard& that) = delete;
+      scratch_guard(scratch_guard&& that) = delete;
+
+      ~scratch_guard()
+      {
+        str_.resize(size_);
+      }
+
+      scratch_guard& operator=(const scratch_guard& that) = delete;
+      scratch_guard& operator=(scratch_guard&& that) = delete;
+
+      [[nodiscard]] std::string_view text() const noexcept
+      {
+        return std::string_view{str_}.substr(size_);
+      }
+
+    private:
+      std::string& str_;
+      std::size_t size_;
+    };
+
     namespace cpo
     {
       struct fn
@@ -50,6 +143,21 @@ namespace yarisc::arch
 
           return os;
         }
+
+        template <typename T>
+          requires(!custom::tag_invocable<fn, std::ostream&, const T&, output_format>) &&
+                  custom::tag_invocable<output_to_t, std::string&, const T&, output_format>
+        std::ostream& operator()(std::ostream& os, const T& obj, output_format fmt = output_format::console) const
+        {
+          std::string& str = scratch();
+          const scratch_guard guard{str};
+
+          output_to(str, obj, fmt);
+
+          const std::string_view text = guard.text();
+
+          return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
       };
 
     } // namespace cpo
@@ -64,6 +172,8 @@ namespace yarisc::arch
   /**
    * @brief Customization point object for outputting text to an output stream
    *
+   * Types that customize `output_to` are formatted into a string first, which is written to the stream at once.
+   *
    * @code
    * void foo(std::ostream& os)
    * {
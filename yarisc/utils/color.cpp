@@ -7,6 +7,8 @@
 
 #if defined(_WIN32)
 #include <Windows.h>
+#else
+#include <unistd.h>
 #endif
 
 namespace yarisc::utils::color
@@ -40,6 +42,13 @@ namespace yarisc::utils::color
       return try_enable_color(STD_OUTPUT_HANDLE) && try_enable_color(STD_ERROR_HANDLE);
     }
 
+#else
+
+    [[nodiscard]] bool try_enable_color() noexcept
+    {
+      return ::isatty(STDOUT_FILENO) && ::isatty(STDERR_FILENO);
+    }
+
 #endif
 
   } // namespace
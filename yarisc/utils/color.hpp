@@ -7,6 +7,7 @@
 #define YARISC_UTILS_COLOR_HPP
 
 #include <yarisc/utils/export.h>
+#include <yarisc/utils/text_buffer.hpp>
 
 #include <atomic>
 #include <concepts>
@@ -35,9 +36,98 @@ namespace yarisc::utils::color
 
     [[nodiscard]] YARISC_UTILS_EXPORT bool enable_color() noexcept;
 
+    /**
+     * @brief Layer of the terminal attributes that a select graphic rendition sequence changes
+     */
+    enum class attribute_layer
+    {
+      foreground,
+      background,
+      other
+    };
+
+    /**
+     * @brief Returns the layer of a sequence of the form `ESC [ n m`
+     */
+    [[nodiscard]] constexpr attribute_layer layer_of(std::string_view sequence) noexcept
+    {
+      if ((sequence.size() < 4) || (sequence.substr(0, 2) != "\033[") || (sequence.back() != 'm'))
+        return attribute_layer::other;
+
+      int code = 0;
+
+      for (const char ch : sequence.substr(2, sequence.size() - 3))
+      {
+        if ((ch < '0') || (ch > '9'))
+          return attribute_layer::other;
+
+        code = 10 * code + (ch - '0');
+      }
+
+      if (((code >= 30) && (code <= 37)) || (code == 39) || ((code >= 90) && (code <= 97)))
+        return attribute_layer::foreground;
+
+      if (((code >= 40) && (code <= 47)) || (code == 49) || ((code >= 100) && (code <= 107)))
+        return attribute_layer::background;
+
+      return attribute_layer::other;
+    }
+
+    /**
+     * @brief Attributes of the terminal that have been set in a context
+     */
     struct context_base
     {
       bool dirty_{false};
+
+      /**
+       * @brief Current foreground and background sequences, which are empty for the default colors
+       */
+      std::string_view foreground_{};
+      std::string_view background_{};
+
+      /**
+       * @brief Records the attributes that the given sequence sets
+       *
+       * @return false if the sequence would not change the attributes of the terminal, true otherwise
+       */
+      [[nodiscard]] constexpr bool change(std::string_view sequence) noexcept
+      {
+        switch (layer_of(sequence))
+        {
+        case attribute_layer::foreground:
+          if (foreground_ == sequence)
+            return false;
+
+          foreground_ = sequence;
+          break;
+
+        case attribute_layer::background:
+          if (background_ == sequence)
+            return false;
+
+          background_ = sequence;
+          break;
+
+        default:
+          // The effect is unknown, so any following sequence has to be output
+          foreground_ = {};
+          background_ = {};
+          break;
+        }
+
+        dirty_ = true;
+
+        return true;
+      }
+
+      /**
+       * @brief Takes over the attributes and leaves the default attributes
+       */
+      [[nodiscard]] constexpr context_base take() noexcept
+      {
+        return std::exchange(*this, context_base{});
+      }
     };
 
   } // namespace detail
@@ -100,7 +190,7 @@ namespace yarisc::utils::color
      * @param that context to move
      */
     colored_context(colored_context&& that) noexcept
-      : detail::context_base{that.reset_dirty()}
+      : detail::context_base{that.take()}
     {
     }
 
@@ -130,11 +220,6 @@ namespace yarisc::utils::color
     friend detail::color_reset;
 
     friend class dynamic_context;
-
-    [[nodiscard]] bool reset_dirty() noexcept
-    {
-      return std::exchange(dirty_, false);
-    }
   };
 
   /**
@@ -160,7 +245,7 @@ namespace yarisc::utils::color
      * @param that context to move
      */
     dynamic_context(dynamic_context&& that) noexcept
-      : detail::context_base{that.reset_dirty()}
+      : detail::context_base{that.take()}
       , enabled_{that.enabled_}
     {
     }
@@ -182,7 +267,7 @@ namespace yarisc::utils::color
      * Conversion from a colored context. This context will be enabled.
      */
     dynamic_context(colored_context&& ctx) noexcept
-      : detail::context_base{ctx.reset_dirty()}
+      : detail::context_base{ctx.take()}
       , enabled_{true}
     {
     }
@@ -213,11 +298,6 @@ namespace yarisc::utils::color
     friend detail::color_reset;
 
     bool enabled_{supported()};
-
-    [[nodiscard]] bool reset_dirty() noexcept
-    {
-      return std::exchange(dirty_, false);
-    }
   };
 
   namespace detail
@@ -235,6 +315,11 @@ namespace yarisc::utils::color
       {
         return os;
       }
+
+      friend text_buffer& operator<<(text_buffer& buf, const color_never&) noexcept
+      {
+        return buf;
+      }
     };
 
     class color_always final
@@ -250,11 +335,11 @@ namespace yarisc::utils::color
       colored_context* context_;
       std::string_view sequence_;
 
-      void put(std::ostream& os) const
+      template <typename Out>
+      void put(Out& os) const
       {
-        os << sequence_;
-
-        context_->dirty_ = true;
+        if (context_->change(sequence_))
+          os << sequence_;
       }
 
       friend std::ostream& operator<<(std::ostream& os, const color_always& clr)
@@ -263,6 +348,13 @@ namespace yarisc::utils::color
 
         return os;
       }
+
+      friend text_buffer& operator<<(text_buffer& buf, const color_always& clr)
+      {
+        clr.put(buf);
+
+        return buf;
+      }
     };
 
     class color_conditional final
@@ -278,14 +370,11 @@ namespace yarisc::utils::color
       dynamic_context* context_;
       std::string_view sequence_;
 
-      void put(std::ostream& os) const
+      template <typename Out>
+      void put(Out& os) const
       {
-        if (context_->enabled_)
-        {
+        if (context_->enabled_ && context_->change(sequence_))
           os << sequence_;
-
-          context_->dirty_ = true;
-        }
       }
 
       friend std::ostream& operator<<(std::ostream& os, const color_conditional& clr)
@@ -294,6 +383,13 @@ namespace yarisc::utils::color
 
         return os;
       }
+
+      friend text_buffer& operator<<(text_buffer& buf, const color_conditional& clr)
+      {
+        clr.put(buf);
+
+        return buf;
+      }
     };
 
     class color_reset final
@@ -312,7 +408,8 @@ namespace yarisc::utils::color
     private:
       context_base* context_;
 
-      void put(std::ostream& os) const
+      template <typename Out>
+      void put(Out& os) const
       {
         using namespace std::string_view_literals;
 
@@ -320,7 +417,7 @@ namespace yarisc::utils::color
         {
           os << "\033[0m"sv;
 
-          context_->dirty_ = false;
+          *context_ = context_base{};
         }
       }
 
@@ -330,6 +427,13 @@ namespace yarisc::utils::color
 
         return os;
       }
+
+      friend text_buffer& operator<<(text_buffer& buf, const color_reset& clr)
+      {
+        clr.put(buf);
+
+        return buf;
+      }
     };
 
     template <typename T>
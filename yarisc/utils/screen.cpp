@@ -0,0 +1,331 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#include <yarisc/utils/screen.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <utility>
+
+namespace yarisc::utils
+{
+  namespace
+  {
+    using namespace std::string_view_literals;
+
+    constexpr std::string_view erase_line_seq = "\033[K";
+    constexpr std::string_view clear_seq = "\033[H\033[2J";
+
+    /**
+     * @brief Maximum number of unchanged cells that are rewritten instead of moving the cursor over them
+     *
+     * A cursor move takes at least six characters.
+     */
+    constexpr std::size_t max_rewrite = 4;
+
+    /**
+     * @brief Applies the parameters of an SGR sequence to the foreground and background color
+     *
+     * Extended colors and other attributes are skipped.
+     */
+    void apply_sgr(std::string_view params, std::uint8_t& foreground, std::uint8_t& background) noexcept
+    {
+      std::size_t first = 0;
+      std::size_t skip = 0;
+      bool extended = false;
+
+      for (;;)
+      {
+        const std::size_t last = std::min(params.find(';', first), params.size());
+
+        // An empty parameter is zero
+        unsigned int code = 0;
+
+        for (const char ch : params.substr(first, last - first))
+        {
+          if ((ch >= '0') && (ch <= '9'))
+            code = std::min(10 * code + static_cast<unsigned int>(ch - '0'), 1000u);
+        }
+
+        if (skip > 0)
+        {
+          --skip;
+        }
+        else if (extended)
+        {
+          // Either 5 and an index or 2 and three color components
+          extended = false;
+          skip = (code == 5) ? 1 : ((code == 2) ? 3 : 0);
+        }
+        else if (code == 0)
+        {
+          foreground = 0;
+          background = 0;
+        }
+        else if (((code >= 30) && (code <= 37)) || ((code >= 90) && (code <= 97)))
+        {
+          foreground = static_cast<std::uint8_t>(code);
+        }
+        else if (((code >= 40) && (code <= 47)) || ((code >= 100) && (code <= 107)))
+        {
+          background = static_cast<std::uint8_t>(code);
+        }
+        else if (code == 39)
+        {
+          foreground = 0;
+        }
+        else if (code == 49)
+        {
+          background = 0;
+        }
+        else if ((code == 38) || (code == 48))
+        {
+          extended = true;
+        }
+
+        if (last == params.size())
+          break;
+
+        first = last + 1;
+      }
+    }
+
+    void append_number(std::size_t value, std::string& out)
+    {
+      char digits[std::numeric_limits<std::size_t>::digits10 + 1];
+      std::size_t count = 0;
+
+      do
+      {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+      } while (value != 0);
+
+      while (count > 0)
+        out += digits[--count];
+    }
+
+    /**
+     * @brief Returns the number of digits of a value
+     */
+    [[nodiscard]] std::size_t number_length(std::size_t value) noexcept
+    {
+      std::size_t length = 1;
+
+      while (value >= 10)
+      {
+        value /= 10;
+        ++length;
+      }
+
+      return length;
+    }
+
+    /**
+     * @brief Returns the length of the SGR parameters, which are separated by semicolons
+     */
+    [[nodiscard]] std::size_t sgr_length(std::span<const std::size_t> params) noexcept
+    {
+      std::size_t length = params.size() - 1;
+
+      for (const std::size_t value : params)
+        length += number_length(value);
+
+      return length;
+    }
+
+  } // namespace
+
+  void screen::render(std::string_view frame, std::string& out)
+  {
+    parse(frame);
+
+    if (!valid_)
+    {
+      out += clear_seq;
+
+      lines_.clear();
+      row_ = 0;
+      column_ = 0;
+      attr_ = {};
+      valid_ = true;
+    }
+    else
+    {
+      // The cursor has been moved by other output since the previous frame
+      row_ = std::numeric_limits<std::size_t>::max();
+    }
+
+    static const line empty_line{};
+
+    for (std::size_t r = 0; r < next_.size(); ++r)
+    {
+      const line& current = next_[r];
+      const line& previous = (r < lines_.size()) ? lines_[r] : empty_line;
+
+      for (std::size_t c = 0; c < current.size(); ++c)
+      {
+        if ((c < previous.size()) && (previous[c] == current[c]))
+          continue;
+
+        move_to(r, c, out);
+        set_attr(current[c].attr, out);
+
+        out += current[c].ch;
+        ++column_;
+      }
+
+      if (previous.size() > current.size())
+      {
+        move_to(r, current.size(), out);
+        set_attr({}, out);
+
+        out += erase_line_seq;
+      }
+    }
+
+    for (std::size_t r = next_.size(); r < lines_.size(); ++r)
+    {
+      if (!lines_[r].empty())
+      {
+        move_to(r, 0, out);
+        set_attr({}, out);
+
+        out += erase_line_seq;
+      }
+    }
+
+    set_attr({}, out);
+    move_to(next_.size() - 1, next_.back().size(), out);
+
+    std::swap(lines_, next_);
+  }
+
+  void screen::parse(std::string_view frame)
+  {
+    // Keeps the capacity of the lines of the frame before the previous one
+    std::size_t rows = 1;
+    next_.resize(std::max<std::size_t>(next_.size(), 1));
+    next_[0].clear();
+
+    attributes attr{};
+
+    for (std::size_t i = 0; i < frame.size(); ++i)
+    {
+      const char ch = frame[i];
+
+      if ((ch == '\033') && (i + 1 < frame.size()) && (frame[i + 1] == '['))
+      {
+        // The final byte of a control sequence is in the range from '@' to '~'
+        std::size_t end = i + 2;
+
+        while ((end < frame.size()) && ((frame[end] < '@') || (frame[end] > '~')))
+          ++end;
+
+        if (end == frame.size())
+          break;
+
+        if (frame[end] == 'm')
+          apply_sgr(frame.substr(i + 2, end - i - 2), attr.foreground, attr.background);
+
+        i = end;
+      }
+      else if (ch == '\n')
+      {
+        if (rows == next_.size())
+          next_.emplace_back();
+
+        next_[rows++].clear();
+      }
+      else if (ch != '\r')
+      {
+        next_[rows - 1].push_back({ch, attr});
+      }
+    }
+
+    next_.resize(rows);
+  }
+
+  void screen::move_to(std::size_t row, std::size_t column, std::string& out)
+  {
+    if ((row == row_) && (column == column_))
+      return;
+
+    // Rewriting a few unchanged cells of the current color is shorter than a cursor move
+    if ((row == row_) && (column > column_) && (column - column_ <= max_rewrite) && (row < lines_.size()))
+    {
+      const line& previous = lines_[row];
+      const line& current = next_[row];
+
+      const bool same = (column <= previous.size()) &&
+                        std::all_of(current.begin() + static_cast<std::ptrdiff_t>(column_),
+                                    current.begin() + static_cast<std::ptrdiff_t>(column),
+                                    [this](const cell& c) { return c.attr == attr_; });
+
+      if (same)
+      {
+        for (std::size_t c = column_; c < column; ++c)
+          out += current[c].ch;
+
+        column_ = column;
+
+        return;
+      }
+    }
+
+    out += "\033["sv;
+    append_number(row + 1, out);
+    out += ';';
+    append_number(column + 1, out);
+    out += 'H';
+
+    row_ = row;
+    column_ = column;
+  }
+
+  void screen::set_attr(attributes attr, std::string& out)
+  {
+    if (attr == attr_)
+      return;
+
+    // Either only the colors that change are set, or all colors are reset first, whichever is shorter
+    std::size_t changed[2];
+    std::size_t reset[3] = {0};
+    std::size_t num_changed = 0;
+    std::size_t num_reset = 1;
+
+    if (attr.foreground != attr_.foreground)
+      changed[num_changed++] = (attr.foreground != 0) ? attr.foreground : 39;
+    if (attr.background != attr_.background)
+      changed[num_changed++] = (attr.background != 0) ? attr.background : 49;
+
+    if (attr.foreground != 0)
+      reset[num_reset++] = attr.foreground;
+    if (attr.background != 0)
+      reset[num_reset++] = attr.background;
+
+    // The lengths are counted before, so no temporary sequences are built
+    const std::span<const std::size_t> changed_params{changed, num_changed};
+    const std::span<const std::size_t> reset_params{reset, num_reset};
+    const std::span<const std::size_t> params =
+      (sgr_length(changed_params) < sgr_length(reset_params)) ? changed_params : reset_params;
+
+    out += "\033["sv;
+
+    for (std::size_t i = 0; i < params.size(); ++i)
+    {
+      if (i > 0)
+        out += ';';
+
+      append_number(params[i], out);
+    }
+
+    out += 'm';
+
+    attr_ = attr;
+  }
+
+} // namespace yarisc::utils
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_UTILS_SCREEN_HPP
+#define YARISC_UTILS_SCREEN_HPP
+
+#include <yarisc/utils/export.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yarisc::utils
+{
+  /**
+   * @brief Model of a terminal screen, which only redraws the cells that differ from the previous frame
+   *
+   * A frame is ASCII text whose lines are separated by newlines and which is colored by SGR sequences. Only the
+   * foreground and background colors of the sequences are kept, other attributes and control sequences are ignored. The
+   * frame is drawn from the top left corner of the terminal.
+   *
+   * The screen keeps track of the colors of the terminal, so only the colors that change between cells are output.
+   */
+  class screen final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * The first frame is drawn to a cleared terminal.
+     */
+    screen() = default;
+
+    screen(const screen& that) = delete;
+    screen(screen&& that) = default;
+
+    ~screen() = default;
+
+    screen& operator=(const screen& that) = delete;
+    screen& operator=(screen&& that) = default;
+
+    /**
+     * @brief Appends the output that updates the terminal from the previous frame to the given one
+     *
+     * The output moves the cursor to the cells that have changed and leaves the cursor where it would be after writing
+     * the frame to a cleared terminal. The colors are reset at the end.
+     *
+     * @param frame text of the frame
+     * @param out string to which the output is appended
+     */
+    YARISC_UTILS_EXPORT void render(std::string_view frame, std::string& out);
+
+    /**
+     * @brief Clears the terminal with the next frame, e.g. because other output has overwritten the screen
+     */
+    void invalidate() noexcept
+    {
+      valid_ = false;
+    }
+
+  private:
+    /**
+     * @brief Foreground and background color as SGR parameter, zero is the default color
+     */
+    struct attributes final
+    {
+      std::uint8_t foreground{0};
+      std::uint8_t background{0};
+
+      [[nodiscard]] bool operator==(const attributes& that) const noexcept = default;
+    };
+
+    struct cell final
+    {
+      char ch{' '};
+      attributes attr{};
+
+      [[nodiscard]] bool operator==(const cell& that) const noexcept = default;
+    };
+
+    using line = std::vector<cell>;
+
+    std::vector<line> lines_{};
+    std::vector<line> next_{};
+    bool valid_{false};
+
+    std::size_t row_{0};
+    std::size_t column_{0};
+    attributes attr_{};
+
+    void parse(std::string_view frame);
+
+    void move_to(std::size_t row, std::size_t column, std::string& out);
+
+    void set_attr(attributes attr, std::string& out);
+  };
+
+} // namespace yarisc::utils
+
+#endif
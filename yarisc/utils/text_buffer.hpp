@@ -0,0 +1,180 @@
+/*
+ * This file is part of the YaRISC processor project which is released under the MIT license.
+ * See file LICENSE in the root folder of this repository for details.
+ */
+
+#ifndef YARISC_UTILS_TEXT_BUFFER_HPP
+#define YARISC_UTILS_TEXT_BUFFER_HPP
+
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace yarisc::utils
+{
+  namespace detail
+  {
+    [[nodiscard]] consteval std::array<std::array<char, 2>, 256> make_hex_byte_table() noexcept
+    {
+      constexpr std::string_view digits = "0123456789abcdef";
+
+      std::array<std::array<char, 2>, 256> table{};
+
+      for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = {digits[i >> 4], digits[i & 0xf]};
+
+      return table;
+    }
+
+    /**
+     * @brief Two lowercase hexadecimal digits of every byte
+     */
+    inline constexpr std::array<std::array<char, 2>, 256> hex_byte_table = make_hex_byte_table();
+
+    /**
+     * @brief Converts an unsigned integer to lowercase hexadecimal digits without leading zeros
+     *
+     * @param digits storage of the digits
+     * @param value integer to convert
+     * @return view of the digits in the given storage
+     */
+    template <std::unsigned_integral T>
+    [[nodiscard]] std::string_view to_hex_chars(std::array<char, 2 * sizeof(T)>& digits, T value) noexcept
+    {
+      std::size_t first = digits.size();
+
+      // Two digits per table lookup, from the least significant byte
+      do
+      {
+        const auto& pair = hex_byte_table[static_cast<unsigned char>(value & 0xff)];
+
+        digits[--first] = pair[1];
+        digits[--first] = pair[0];
+
+        if constexpr (sizeof(T) > 1)
+          value = static_cast<T>(value >> 8);
+        else
+          value = 0;
+      } while (value != 0);
+
+      // Only the most significant byte can have a leading zero
+      if ((digits[first] == '0') && (first + 1 < digits.size()))
+        ++first;
+
+      return {digits.data() + first, digits.size() - first};
+    }
+
+  } // namespace detail
+
+  /**
+   * @brief Appends text to a caller-provided string
+   *
+   * This is the formatting backend of the text output. Unlike an output stream it has no formatting state and no
+   * locale, and a string that is reused keeps its capacity, so formatting into it does not allocate.
+   */
+  class text_buffer final
+  {
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param str string to which the text is appended, which must outlive this buffer
+     */
+    explicit text_buffer(std::string& str) noexcept
+      : str_{&str}
+    {
+    }
+
+    text_buffer(const text_buffer& that) = delete;
+    text_buffer(text_buffer&& that) = delete;
+
+    ~text_buffer() = default;
+
+    text_buffer& operator=(const text_buffer& that) = delete;
+    text_buffer& operator=(text_buffer&& that) = delete;
+
+    text_buffer& operator<<(char ch)
+    {
+      str_->push_back(ch);
+
+      return *this;
+    }
+
+    text_buffer& operator<<(std::string_view str)
+    {
+      str_->append(str);
+
+      return *this;
+    }
+
+    /**
+     * @brief Appends the given character repeatedly
+     */
+    text_buffer& append(std::size_t count, char ch)
+    {
+      str_->append(count, ch);
+
+      return *this;
+    }
+
+    /**
+     * @brief Returns the string to which the text is appended
+     */
+    [[nodiscard]] std::string& str() const noexcept
+    {
+      return *str_;
+    }
+
+  private:
+    std::string* str_;
+  };
+
+  /**
+   * @brief Appends an unsigned integer as lowercase hexadecimal digits
+   *
+   * @param buf text buffer
+   * @param value integer to append
+   * @param width minimum number of digits, which is filled with leading zeros
+   * @return given text buffer
+   */
+  template <std::unsigned_integral T>
+  text_buffer& append_hex(text_buffer& buf, T value, std::size_t width = 2 * sizeof(T))
+  {
+    std::array<char, 2 * sizeof(T)> storage;
+    const std::string_view digits = detail::to_hex_chars(storage, value);
+
+    if (width > digits.size())
+      buf.append(width - digits.size(), '0');
+
+    return buf << digits;
+  }
+
+  /**
+   * @brief Appends an integer as decimal digits
+   *
+   * @param buf text buffer
+   * @param value integer to append
+   * @return given text buffer
+   */
+  template <std::integral T>
+    requires(!std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+  text_buffer& append_decimal(text_buffer& buf, T value)
+  {
+    std::array<char, std::numeric_limits<T>::digits10 + 2> digits;
+
+    [[maybe_unused]] const auto [ptr, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    assert(ec == std::errc{});
+
+    return buf << std::string_view{digits.data(), static_cast<std::size_t>(ptr - digits.data())};
+  }
+
+} // namespace yarisc::utils
+
+#endif